@@ -0,0 +1,53 @@
+/*********************************************************************
+** Program Filename: AliasTable.cpp
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Implements functions declared by the AliasTable class.
+** Input: None
+** Output: None
+*********************************************************************/
+#include <cmath>
+#include <numeric>
+#include "AliasTable.h"
+
+/*********************************************************************
+** Function: AliasTable
+** Description: Constructor for the AliasTable class; builds the columns
+ * by pairing off outcomes with less than a column's worth of chance
+ * against ones with more.
+** Parameters: weights are the outcomes' relative chances.
+** Pre-Conditions: weights are finite and non-negative, and at least one
+ * is positive.
+** Post-Conditions: None
+*********************************************************************/
+AliasTable::AliasTable(const std::vector<double> &weights):
+    columns_(weights.size()) {
+  std::size_t n = weights.size();
+  double total = std::accumulate(weights.begin(), weights.end(), 0.0);
+
+  // Each outcome's chance, in columns.
+  std::vector<double> chances(n);
+  std::vector<std::size_t> small, large;
+  for (std::size_t i = 0; i != n; ++i) {
+    chances[i] = weights[i] * n / total;
+    (chances[i] < 1.0 ? small : large).push_back(i);
+  }
+
+  while (!small.empty() && !large.empty()) {
+    std::size_t s = small.back(), l = large.back();
+    small.pop_back();
+    columns_[s].keep = static_cast<std::uint64_t>(
+        std::ldexp(chances[s], 32));
+    columns_[s].alias = l;
+
+    chances[l] -= 1.0 - chances[s];
+    if (chances[l] < 1.0) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+
+  // What is left has a column's worth of chance, give or take rounding.
+  for (std::size_t i : small) columns_[i] = Column{1ULL << 32, i};
+  for (std::size_t i : large) columns_[i] = Column{1ULL << 32, i};
+}
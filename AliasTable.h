@@ -0,0 +1,60 @@
+#ifndef ZOO_TYCOON_ALIASTABLE_H
+#define ZOO_TYCOON_ALIASTABLE_H
+/*********************************************************************
+** Program Filename: AliasTable.h
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Declares the AliasTable class and its related members.
+** Input: None
+** Output: None
+*********************************************************************/
+
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// An AliasTable draws one of n outcomes with fixed, weighted chances in
+// O(1), from a single draw of the random engine and without allocating
+// (Walker's alias method, built with Vose's algorithm in O(n)). Each
+// outcome has a column, which it keeps with a certain chance and
+// otherwise hands over to its alias; the chances of the columns sum to
+// one column's worth for every outcome.
+class AliasTable {
+  public:
+    AliasTable() {}
+    explicit AliasTable(const std::vector<double> &weights);
+
+    std::size_t size() const { return columns_.size(); }
+
+    std::size_t Draw(std::mt19937 &rng_engine) const;
+
+  private:
+    struct Column {
+      // The column's outcome is kept when the low 32 bits of the draw are
+      // below keep; keep is 2^32 for a column that is never handed over.
+      std::uint64_t keep;
+      std::size_t alias;
+    };
+
+    std::vector<Column> columns_;
+};
+
+/*********************************************************************
+** Function: Draw
+** Description: Draws an outcome. The engine's 32 random bits, scaled by
+ * the number of columns, pick a column with their high bits and whether
+ * to keep it with their low bits.
+** Parameters: rng_engine is the game's random engine.
+** Pre-Conditions: size() > 0.
+** Post-Conditions: Returns the index of the outcome's weight.
+*********************************************************************/
+inline std::size_t AliasTable::Draw(std::mt19937 &rng_engine) const {
+  std::uint64_t x =
+      static_cast<std::uint64_t>(rng_engine()) * columns_.size();
+  std::size_t i = static_cast<std::size_t>(x >> 32);
+  return (x & 0xffffffffu) < columns_[i].keep ? i : columns_[i].alias;
+}
+
+
+#endif //ZOO_TYCOON_ALIASTABLE_H
@@ -13,23 +13,37 @@
 /*********************************************************************
 ** Function: Animal
 ** Description: Constructor for the abstract Animal class.
-** Parameters: age is the age of the animal; cost is the unit cost of
+** Parameters: species is the animal's species; name is its display name;
+ * age is the age of the animal; cost is the unit cost of
  * the animal species; babies_per_birth is the number of babies the
  * animal's species creates in one birth; food_cost_multiplier is the
- * multiplier for the daily base food cost; revenue_pct is the percent
- * of the specie's unit cost the animal generates in revenue.
+ * multiplier for the daily base food cost; daily_birth_chance and
+ * daily_sickness_chance are the chances the animal gives birth or falls
+ * sick on any one day; gestation_days is how long the animal's pregnancies
+ * last; lifespan is the oldest the animal gets; revenue_pct is the
+ * percent of the specie's unit cost the animal generates in revenue.
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
 Animal::Animal(
+    AnimalSpecies species,
     const std::string &name,
     unsigned age,
     unsigned cost,
     unsigned babies_per_birth,
     unsigned food_cost_multiplier,
+    double daily_birth_chance,
+    double daily_sickness_chance,
+    unsigned gestation_days,
+    unsigned lifespan,
     double revenue_pct):
-    name_(name), age_(age), babies_per_birth_(babies_per_birth), cost_(cost),
-    food_cost_multiplier_(food_cost_multiplier), revenue_pct_(revenue_pct) {}
+    name_(name), species_(species), age_(age),
+    babies_per_birth_(babies_per_birth), cost_(cost),
+    food_cost_multiplier_(food_cost_multiplier),
+    daily_birth_chance_(daily_birth_chance),
+    daily_sickness_chance_(daily_sickness_chance),
+    gestation_days_(gestation_days), lifespan_(lifespan),
+    revenue_pct_(revenue_pct) {}
 
 /*********************************************************************
 ** Function: DailyRevenue
@@ -81,6 +95,20 @@ std::string Animal::PrettyAge() const {
   return std::to_string(years) + " years and " + std::to_string(days) +" days";
 }
 
+/*********************************************************************
+** Function: PrintPrettyAge
+** Description: Prints an age the way PrettyAge formats it, without
+ * building a string.
+** Parameters: os is the stream to print to; age is the age, in days.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+std::ostream &PrintPrettyAge(std::ostream &os, unsigned age) {
+  if (age < 365) return os << age << " days";
+  if (age % 365 == 0) return os << age / 365 << " years";
+  return os << age / 365 << " years and " << age % 365 << " days";
+}
+
 /*********************************************************************
 ** Function: operator==
 ** Description: Overloads the equality operator for Animals.
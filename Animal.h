@@ -10,12 +10,20 @@
 *********************************************************************/
 
 
+#include <iosfwd>
 #include <vector>
 #include "Option.h"
 #include "Utils.h"
 #include "FoodType.h"
 
 class Animal;
+// Defined in AnimalSpecies.h, which needs the Animal subclasses.
+enum class AnimalSpecies;
+
+// Animals younger than this many days are babies; animals this many days
+// old or older are adults.
+static constexpr unsigned ANIMAL_BABY_MAX_AGE = 30;
+static constexpr unsigned ANIMAL_ADULT_AGE = 365 * 3;
 
 using AnimalsVec = std::vector<std::unique_ptr<Animal>>;
 using CAnimalRef = std::reference_wrapper<const Animal>;
@@ -25,21 +33,37 @@ class Animal {
 
   public:
     Animal(
+        AnimalSpecies species,
         const std::string &name,
         unsigned age,
         unsigned cost,
         unsigned babies_per_birth,
         unsigned food_cost_multiplier,
+        double daily_birth_chance,
+        double daily_sickness_chance,
+        unsigned gestation_days,
+        unsigned lifespan,
         double revenue_pct = 0.05);
 
     unsigned age() const { return age_; }
     unsigned babies_per_birth() const { return babies_per_birth_; }
     unsigned cost() const { return cost_; }
+    // The chances that the animal gives birth (if it is an adult), or
+    // falls sick, on any one day; see PopulationEvents.
+    double daily_birth_chance() const { return daily_birth_chance_; }
+    double daily_sickness_chance() const { return daily_sickness_chance_; }
+    // How many days after conceiving the animal gives birth, when births
+    // are scheduled (see GameTurn::Conceive).
+    unsigned gestation_days() const { return gestation_days_; }
+    // The oldest the animal gets, in days: it dies of old age the morning
+    // after it reaches this age (see Zoo::RemoveExpiredAnimals).
+    unsigned lifespan() const { return lifespan_; }
     const std::string &name() const { return name_; }
+    AnimalSpecies species() const { return species_; }
 
     virtual double DailyRevenue(Option<unsigned> bonus_revenue) const;
     double FoodCost(FoodType t, double base_cost) const;
-    bool IsBaby() const { return age_ < 30; }
+    bool IsBaby() const { return age_ < ANIMAL_BABY_MAX_AGE; }
     inline bool IsAdult() const;
     std::string PrettyAge() const;
     double SickCareCost() const { return static_cast<double>(cost_) / 2; }
@@ -51,17 +75,23 @@ class Animal {
   private:
     // Name (right now) is just the species name.
     std::string name_;
+    AnimalSpecies species_;
 
     unsigned age_;
     unsigned babies_per_birth_;
     unsigned cost_;
     unsigned food_cost_multiplier_;
+    double daily_birth_chance_;
+    double daily_sickness_chance_;
+    unsigned gestation_days_;
+    unsigned lifespan_;
     // Animals generate revenue equal to percentage of the cost of
     // one of their species (default = 5%).
     double revenue_pct_;
 };
 
 bool operator==(const Animal &lhs, const Animal &rhs);
+std::ostream &PrintPrettyAge(std::ostream &os, unsigned age);
 
 /*********************************************************************
 ** Function: IsAdult
@@ -71,7 +101,7 @@ bool operator==(const Animal &lhs, const Animal &rhs);
 ** Post-Conditions: None
 *********************************************************************/
 bool Animal::IsAdult() const {
-  return (static_cast<double>(age_) / 365) >= 3;
+  return age_ >= ANIMAL_ADULT_AGE;
 }
 
 /*********************************************************************
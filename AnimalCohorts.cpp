@@ -0,0 +1,265 @@
+/*********************************************************************
+** Program Filename: AnimalCohorts.cpp
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Implements functions declared by the AnimalCohorts class.
+** Input: None
+** Output: None
+*********************************************************************/
+#include "AnimalCohorts.h"
+
+constexpr AnimalCohorts::size_type AnimalCohorts::NO_COHORT;
+
+/*********************************************************************
+** Function: Add
+** Description: Adds count animals to the end of the zoo, merging them into
+ * the last cohort if it holds the same kind of animal.
+** Parameters: s is the animals' species; birth_day is the day they were
+ * born on; count is the number of animals; adult is whether they are
+ * adults.
+** Pre-Conditions: None
+** Post-Conditions: Returns the index of the cohort holding the animals.
+*********************************************************************/
+AnimalCohorts::size_type AnimalCohorts::Add(
+    AnimalSpecies s, long birth_day, unsigned long count, bool adult) {
+  if (!cohorts_.empty()) {
+    size_type last = cohorts_.size() - 1;
+    const AnimalCohort &c = cohorts_[last];
+    if (c.species == s && c.birth_day == birth_day && IsAdult(last) == adult) {
+      if (c.count == 0) --n_empty_;
+      cohorts_.Mutable(last).count += count;
+      animals_.Add(last, count);
+      if (adult) adults_.Add(last, count);
+      return last;
+    }
+  }
+
+  cohorts_.push_back(AnimalCohort{s, birth_day, count});
+  adult_.push_back(adult);
+  animals_.Push(count);
+  adults_.Push(adult ? count : 0);
+  // The new cohort has the highest index, so it goes after every entry
+  // with its birth day.
+  CowArray<BirthDayEntry> &index = by_birth_day_[SpeciesIndex(s)];
+  BirthDayEntry e(birth_day, cohorts_.size() - 1);
+  if (index.empty() || index.back().first <= birth_day) {
+    index.push_back(e);
+  } else {
+    index.Insert(index.PartitionPoint(
+        [&](const BirthDayEntry &x) { return !(e < x); }), e);
+  }
+  return cohorts_.size() - 1;
+}
+
+/*********************************************************************
+** Function: Clear
+** Description: Removes every cohort, keeping the memory they used.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: size() is 0.
+*********************************************************************/
+void AnimalCohorts::Clear() {
+  cohorts_.clear();
+  adult_.clear();
+  for (CowArray<BirthDayEntry> &index : by_birth_day_) index.clear();
+  n_empty_ = 0;
+  remap_.clear();
+  animals_.Clear();
+  adults_.Clear();
+}
+
+/*********************************************************************
+** Function: Compact
+** Description: Drops the cohorts that have no animals left, keeping the
+ * others in order, in O(n log n). The k-th animal (or adult animal) is
+ * the same animal afterwards; only the cohorts' indices change. The
+ * cohorts before the first empty one are left alone, so a copy still
+ * shares them.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: Returns, for each index a cohort had, its new index,
+ * or NO_COHORT if it was dropped; valid until the next Compact.
+*********************************************************************/
+const CowArray<AnimalCohorts::size_type> &AnimalCohorts::Compact() {
+  CowArray<size_type> &remap = remap_;
+  remap.clear();
+  remap.reserve(cohorts_.size());
+  animals_.Clear();
+  adults_.Clear();
+  size_type n = 0;
+  for (size_type i = 0; i != cohorts_.size(); ++i) {
+    if (cohorts_[i].count == 0) {
+      remap.push_back(NO_COHORT);
+      continue;
+    }
+    remap.push_back(n);
+    if (n != i) {
+      AnimalCohort c = cohorts_[i];
+      cohorts_.Mutable(n) = c;
+      adult_.Mutable(n) = adult_[i];
+    }
+    animals_.Push(cohorts_[n].count);
+    adults_.Push(IsAdult(n) ? cohorts_[n].count : 0);
+    ++n;
+  }
+
+  cohorts_.Truncate(n);
+  adult_.Truncate(n);
+  n_empty_ = 0;
+
+  // remap keeps the cohorts' order, so each index stays sorted.
+  for (CowArray<BirthDayEntry> &index : by_birth_day_) {
+    size_type kept = 0;
+    for (size_type j = 0; j != index.size(); ++j) {
+      BirthDayEntry e = index[j];
+      if (remap[e.second] == NO_COHORT) continue;
+      e.second = remap[e.second];
+      if (index[kept] != e) index.Mutable(kept) = e;
+      ++kept;
+    }
+    index.Truncate(kept);
+  }
+
+  return remap;
+}
+
+/*********************************************************************
+** Function: FindFirst
+** Description: Finds the first cohort still holding animals of the given
+ * species and birth day; the one Zoo::RemoveAnimal would remove an
+ * animal of that species and age from. O(log n), plus one step per
+ * cohort of that kind emptied since the last Compact.
+** Parameters: s is the species; birth_day is the day of birth.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+Option<AnimalCohorts::size_type> AnimalCohorts::FindFirst(
+    AnimalSpecies s, long birth_day) const {
+  const CowArray<BirthDayEntry> &index = by_birth_day_[SpeciesIndex(s)];
+  BirthDayEntry first(birth_day, 0);
+  size_type j = index.PartitionPoint(
+      [&](const BirthDayEntry &e) { return e < first; });
+  for (; j != index.size() && index[j].first == birth_day; ++j)
+    if (cohorts_[index[j].second].count) return index[j].second;
+
+  return None;
+}
+
+/*********************************************************************
+** Function: MarkAdult
+** Description: Counts the animals of the given cohort as adults.
+** Parameters: i is the index of the cohort.
+** Pre-Conditions: The cohort is not already counted as adults.
+** Post-Conditions: None
+*********************************************************************/
+void AnimalCohorts::MarkAdult(size_type i) {
+  adult_.Mutable(i) = 1;
+  adults_.Add(i, cohorts_[i].count);
+}
+
+/*********************************************************************
+** Function: Remove
+** Description: Removes count animals from the given cohort.
+** Parameters: i is the index of the cohort; count is the number of
+ * animals.
+** Pre-Conditions: The cohort holds at least count animals.
+** Post-Conditions: None
+*********************************************************************/
+void AnimalCohorts::Remove(size_type i, unsigned long count) {
+  unsigned long left = cohorts_.Mutable(i).count -= count;
+  if (count && left == 0) ++n_empty_;
+  animals_.Add(i, -count);
+  if (IsAdult(i)) adults_.Add(i, -count);
+}
+
+/*********************************************************************
+** Function: Reserve
+** Description: Makes room for n cohorts, so that adding them does not
+ * have to grow the cohorts' arrays.
+** Parameters: n is the number of cohorts.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void AnimalCohorts::Reserve(size_type n) {
+  cohorts_.reserve(n);
+  adult_.reserve(n);
+  for (CowArray<BirthDayEntry> &index : by_birth_day_) index.reserve(n);
+  remap_.reserve(n);
+  animals_.Reserve(n);
+  adults_.Reserve(n);
+}
+
+/*********************************************************************
+** Function: pop
+** Description: Removes the soonest cohort.
+** Parameters: None
+** Pre-Conditions: The heap is not empty.
+** Post-Conditions: None
+*********************************************************************/
+void CohortHeap::pop() {
+  Entry last = heap_.back();
+  heap_.pop_back();
+  if (heap_.empty()) return;
+  heap_.Mutable(0) = last;
+  SiftDown(0);
+}
+
+/*********************************************************************
+** Function: push
+** Description: Adds a cohort.
+** Parameters: day is the cohort's day; c is the index of the cohort.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void CohortHeap::push(long day, AnimalCohorts::size_type c) {
+  Entry e(day, c);
+  size_type i = heap_.size();
+  heap_.push_back(e);
+  while (i) {
+    size_type parent = (i - 1) / 2;
+    if (!(e < heap_[parent])) break;
+    heap_.Mutable(i) = heap_[parent];
+    i = parent;
+  }
+  if (i != heap_.size() - 1) heap_.Mutable(i) = e;
+}
+
+/*********************************************************************
+** Function: Remap
+** Description: Follows the cohorts through AnimalCohorts::Compact,
+ * dropping the ones it dropped, in O(n).
+** Parameters: remap is what Compact returned.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void CohortHeap::Remap(const CowArray<AnimalCohorts::size_type> &remap) {
+  size_type kept = 0;
+  for (size_type i = 0; i != heap_.size(); ++i) {
+    Entry e = heap_[i];
+    if (remap[e.second] != AnimalCohorts::NO_COHORT)
+      heap_.Mutable(kept++) = Entry(e.first, remap[e.second]);
+  }
+  heap_.Truncate(kept);
+  for (size_type i = kept / 2; i; --i)
+    SiftDown(i - 1);
+}
+
+/*********************************************************************
+** Function: SiftDown
+** Description: Moves entry i down the heap, below any children that
+ * are sooner than it, in O(log n).
+** Parameters: i is the index of the entry.
+** Pre-Conditions: The entries below i form heaps.
+** Post-Conditions: The entries from i down form a heap.
+*********************************************************************/
+void CohortHeap::SiftDown(size_type i) {
+  Entry e = heap_[i];
+  size_type start = i;
+  for (size_type child; (child = 2 * i + 1) < heap_.size(); i = child) {
+    if (child + 1 < heap_.size() && heap_[child + 1] < heap_[child])
+      ++child;
+    if (!(heap_[child] < e)) break;
+    heap_.Mutable(i) = heap_[child];
+  }
+  if (i != start) heap_.Mutable(i) = e;
+}
@@ -0,0 +1,131 @@
+#ifndef ZOO_TYCOON_ANIMALCOHORTS_H
+#define ZOO_TYCOON_ANIMALCOHORTS_H
+/*********************************************************************
+** Program Filename: AnimalCohorts.h
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Declares the AnimalCohorts class and its related members.
+** Input: None
+** Output: None
+*********************************************************************/
+
+
+#include <array>
+#include <limits>
+#include <utility>
+#include "AnimalSpecies.h"
+#include "CowArray.h"
+#include "FenwickTree.h"
+#include "Option.h"
+
+// How much of a zoo's cohorts may be empty before it is worth compacting
+// them: Compact is O(n log n), so waiting until half the cohorts are empty
+// pays for each one with the removals that emptied them.
+static constexpr double MAX_EMPTY_COHORT_FRACTION = 0.5;
+
+// A run of animals of one species born on the same day, added to the zoo
+// one after another.
+struct AnimalCohort {
+  AnimalSpecies species;
+  // The day the animals were born on; their age on day d is
+  // d - birth_day. Negative for animals bought as adults early on.
+  long birth_day;
+  unsigned long count;
+};
+
+// AnimalCohorts holds a zoo's animals as cohorts, in the order the animals
+// were added, so that the k-th animal (or adult animal) of a zoo can be
+// found in O(log n) without storing animals one by one. A cohort whose
+// animals have all been removed is left in place with a count of zero, so
+// that indices stay valid, until Compact drops it; callers wait for
+// WorthCompacting, so that empty cohorts are dropped in batches.
+//
+// Compact and Clear keep the memory the cohorts used, so once Reserve (or
+// earlier growth) has made room for n cohorts, adding up to n of them
+// does not allocate. Everything is held in CowArrays, so a copy (a forked
+// Zoo's, say) costs O(n / COW_ARRAY_CHUNK_SIZE) and then copies only the
+// chunks it changes.
+class AnimalCohorts {
+  public:
+    using size_type = CowArray<AnimalCohort>::size_type;
+
+    // What Compact maps the indices of the cohorts it drops to.
+    static constexpr size_type NO_COHORT =
+        std::numeric_limits<size_type>::max();
+
+    AnimalCohorts() {}
+
+    size_type size() const { return cohorts_.size(); }
+    const AnimalCohort &operator[](size_type i) const { return cohorts_[i]; }
+
+    // Calls f with each cohort, in order, empty ones included.
+    template <class F>
+    void ForEach(F f) const { cohorts_.ForEach(f); }
+    bool IsAdult(size_type i) const { return adult_[i] != 0; }
+    unsigned long NumberOfAdults() const { return adults_.Total(); }
+    unsigned long NumberOfAnimals() const { return animals_.Total(); }
+    size_type NumberOfEmptyCohorts() const { return n_empty_; }
+    bool WorthCompacting() const {
+      return n_empty_ > cohorts_.size() * MAX_EMPTY_COHORT_FRACTION;
+    }
+
+    size_type Add(AnimalSpecies s, long birth_day, unsigned long count,
+                  bool adult);
+    void Clear();
+    const CowArray<size_type> &Compact();
+    size_type FindAdult(unsigned long k) const { return adults_.Find(k); }
+    size_type FindAnimal(unsigned long k) const { return animals_.Find(k); }
+    Option<size_type> FindFirst(AnimalSpecies s, long birth_day) const;
+    void MarkAdult(size_type i);
+    void Remove(size_type i, unsigned long count);
+    void RemoveOne(size_type i) { Remove(i, 1); }
+    void Reserve(size_type n);
+
+  private:
+    CowArray<AnimalCohort> cohorts_;
+    // Whether each cohort is counted in adults_ (1) or not (0).
+    CowArray<unsigned char> adult_;
+    // For FindFirst: each species's cohorts as (birth day, index) pairs,
+    // sorted. Cohorts mostly arrive in birth-day order, so this is
+    // usually appended to, and found by binary search.
+    using BirthDayEntry = std::pair<long, size_type>;
+    std::array<CowArray<BirthDayEntry>, NUMBER_OF_SPECIES> by_birth_day_;
+    // How many cohorts have a count of zero.
+    size_type n_empty_ = 0;
+    // What the last Compact returned.
+    CowArray<size_type> remap_;
+
+    FenwickTree<unsigned long> animals_;
+    FenwickTree<unsigned long> adults_;
+};
+
+// A min-heap of cohorts keyed by a day (the day they grow up, say),
+// soonest first, that can follow its cohorts through
+// AnimalCohorts::Compact. Like AnimalCohorts, it is held in a CowArray,
+// and a change to a copy copies the O(log n) chunks it sifts through.
+class CohortHeap {
+  public:
+    using Entry = std::pair<long, AnimalCohorts::size_type>;
+    using size_type = CowArray<Entry>::size_type;
+
+    CohortHeap() {}
+
+    bool empty() const { return heap_.empty(); }
+    const Entry &top() const { return heap_.front(); }
+
+    void clear() { heap_.clear(); }
+    void pop();
+    void push(long day, AnimalCohorts::size_type c);
+    void reserve(size_type n) { heap_.reserve(n); }
+    void Remap(const CowArray<AnimalCohorts::size_type> &remap);
+
+  private:
+    // heap_[0] is the soonest entry, and each entry is no later than
+    // its children, heap_[2 * i + 1] and heap_[2 * i + 2].
+    CowArray<Entry> heap_;
+
+    void SiftDown(size_type i);
+};
+
+
+#endif //ZOO_TYCOON_ANIMALCOHORTS_H
@@ -19,13 +19,16 @@ const ActionStringMap<AnimalSpecies> AnimalSpeciesToStringMap = {
 
 /*********************************************************************
 ** Function: AllSpecies
-** Description: Returns all possible AnimalSpecies enumeration values.
+** Description: Returns all possible AnimalSpecies enumeration values,
+ * built once.
 ** Parameters: None
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
-std::vector<AnimalSpecies> AllSpecies() {
-  return ActionStringMapKeys(AnimalSpeciesToStringMap);
+const std::vector<AnimalSpecies> &AllSpecies() {
+  static const std::vector<AnimalSpecies> species =
+      ActionStringMapKeys(AnimalSpeciesToStringMap);
+  return species;
 }
 
 /*********************************************************************
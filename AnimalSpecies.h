@@ -10,6 +10,8 @@
 *********************************************************************/
 
 
+#include <array>
+#include <utility>
 #include "Utils.h"
 #include "Monkey.h"
 #include "SeaOtter.h"
@@ -23,6 +25,27 @@ enum class AnimalSpecies {
   Elephant,
 };
 
+// The number of AnimalSpecies values; they are numbered from 0, so a
+// species can be used directly as an index (see SpeciesIndex).
+static constexpr unsigned NUMBER_OF_SPECIES = 4;
+
+// The number of adults and babies (in that order) of each species, indexed
+// by SpeciesIndex. Like every count of animals, they are unsigned long, so
+// that zoos of billions of animals do not wrap around.
+using SpeciesCounts =
+    std::array<std::pair<unsigned long, unsigned long>, NUMBER_OF_SPECIES>;
+
+/*********************************************************************
+** Function: SpeciesIndex
+** Description: Returns the array index used for the given species.
+** Parameters: s is the species.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+inline unsigned SpeciesIndex(AnimalSpecies s) {
+  return static_cast<unsigned>(s);
+}
+
 // SpeciesToType is used to map AnimalSpecies values to their corresponding
 // Animal subclass type, since we can't partially specialize template aliases.
 // Example of usage: SpeciesToType<AnimalSpecies::Monkey>::type
@@ -92,7 +115,7 @@ using CreateStaticAnimal = CreateAnimalS<typename SpeciesToType<A>::type>;
 
 extern const ActionStringMap<AnimalSpecies> AnimalSpeciesToStringMap;
 
-std::vector<AnimalSpecies> AllSpecies();
+const std::vector<AnimalSpecies> &AllSpecies();
 std::string AnimalSpeciesToString(AnimalSpecies s);
 std::unique_ptr<Animal> CreateFromSpecies(AnimalSpecies s, unsigned age);
 
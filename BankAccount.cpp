@@ -7,12 +7,53 @@
 ** Input: None
 ** Output: None
 *********************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <iostream>
 #include "BankAccount.h"
+#include "TurnProfile.h"
+#include "Utils.h"
+
+/*********************************************************************
+** Function: LedgerDigestStep
+** Description: Adds a transaction to a digest of the transactions before
+ * it.
+** Parameters: digest is the digest so far; t is the transaction.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+static std::uint64_t LedgerDigestStep(std::uint64_t digest,
+                                      const BankAccountTransaction &t) {
+  double amount = t.amount();
+  std::uint64_t amount_bits;
+  std::memcpy(&amount_bits, &amount, sizeof(amount));
+  const std::string &desc = t.description();
+  return Mix64(digest ^ Checksum64(desc.data(), desc.size()) ^
+               Mix64(amount_bits + static_cast<std::uint64_t>(t.type())));
+}
+
+/*********************************************************************
+** Function: BankAccount
+** Description: Constructor for the BankAccount class that takes over an
+ * existing ledger.
+** Parameters: balance is the account's balance; transactions is its
+ * ledger.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+BankAccount::BankAccount(double balance,
+                         std::vector<BankAccountTransaction> &&transactions):
+    balance_(balance) {
+  for (const auto &t : transactions)
+    ledger_digest_ = LedgerDigestStep(ledger_digest_, t);
+  transactions_ = Ledger(std::move(transactions));
+}
 
 /*********************************************************************
 ** Function: Deposit
-** Description: Deposits the given amount into the bank account.
+** Description: Deposits the given amount into the bank account, logging
+ * it if the account keeps a ledger.
 ** Parameters: amount is the amount to deposit; reason is a description
  * of the deposit.
 ** Pre-Conditions: None
@@ -20,6 +61,7 @@
 *********************************************************************/
 void BankAccount::Deposit(double amount, const std::string &reason) {
   balance_ += amount;
+  if (!keeps_ledger_) return;
   BankAccountTransaction t = BankAccountTransaction(
       BankTransactionType::Deposit,
       amount,
@@ -36,12 +78,29 @@ void BankAccount::Deposit(double amount, const std::string &reason) {
 ** Post-Conditions: None
 *********************************************************************/
 void BankAccount::LogTransaction(BankAccountTransaction t) {
-  transactions_.push_back(t);
+  ZT_PROFILE_COUNT(transactions_logged, 1);
+  ledger_digest_ = LedgerDigestStep(ledger_digest_, t);
+  transactions_.push_back(std::move(t));
+}
+
+/*********************************************************************
+** Function: Note
+** Description: Records something that happened in the ledger, if the
+ * account keeps one, without moving any money.
+** Parameters: event is a description of what happened.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void BankAccount::Note(const std::string &event) {
+  if (!keeps_ledger_) return;
+  LogTransaction(BankAccountTransaction(BankTransactionType::Note, 0.0,
+                                        event));
 }
 
 /*********************************************************************
 ** Function: Withdraw
-** Description: Removes the specified amount from the bank account.
+** Description: Removes the specified amount from the bank account,
+ * logging it if the account keeps a ledger.
 ** Parameters: amount is the amount to remove; reason is a description
  * of the withdrawal; returns false if the account has insufficient
  * funds.
@@ -52,6 +111,7 @@ bool BankAccount::Withdraw(double amount, const std::string &reason) {
   if (!CanAfford(amount)) return false;
 
   balance_ -= amount;
+  if (!keeps_ledger_) return true;
   BankAccountTransaction t = BankAccountTransaction(
       BankTransactionType::Withdrawal,
       amount,
@@ -61,6 +121,27 @@ bool BankAccount::Withdraw(double amount, const std::string &reason) {
   return true;
 }
 
+/*********************************************************************
+** Function: CountAffordable
+** Description: Returns how many of count things, costing unit_cost each,
+ * can be paid for out of balance with a single withdrawal. Shared by
+ * Player and LockstepEngine so that both round the same way.
+** Parameters: balance is the money available; unit_cost is the cost of
+ * one; count is the number of them.
+** Pre-Conditions: unit_cost >= 0
+** Post-Conditions: None
+*********************************************************************/
+unsigned long CountAffordable(double balance, double unit_cost,
+                              unsigned long count) {
+  if (!(unit_cost <= balance)) return 0;
+  if (unit_cost == 0 || unit_cost * count <= balance) return count;
+
+  unsigned long n = static_cast<unsigned long>(std::min(
+      static_cast<double>(count), std::floor(balance / unit_cost)));
+  while (n && !(unit_cost * n <= balance)) --n;
+  return n;
+}
+
 /*********************************************************************
 ** Function: operator<<
 ** Description: Overloads the insertion operator to print out account
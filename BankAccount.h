@@ -11,8 +11,14 @@
 
 
 #include <string>
+#include <utility>
 #include <vector>
 #include "BankAccountTransaction.h"
+#include "CowVector.h"
+
+// Copies of a BankAccount share the ledger entries they have in common;
+// see CowVector.
+using Ledger = CowVector<BankAccountTransaction>;
 
 class BankAccount
 {
@@ -20,23 +26,35 @@ class BankAccount
 
   public:
     explicit BankAccount(double balance = 0.0): balance_(balance) {}
+    BankAccount(double balance,
+                std::vector<BankAccountTransaction> &&transactions);
 
     double balance() const { return balance_; }
-    std::vector<BankAccountTransaction> transactions() const
-        { return transactions_; }
+    const Ledger &transactions() const { return transactions_; }
+    // A digest of the ledger, kept up to date as transactions are logged.
+    std::uint64_t ledger_digest() const { return ledger_digest_; }
+    // Whether deposits, withdrawals and notes are logged in the ledger;
+    // they are unless the game is headless (see Game::set_headless).
+    bool keeps_ledger() const { return keeps_ledger_; }
+    void set_keeps_ledger(bool on) { keeps_ledger_ = on; }
 
     bool CanAfford(double amount) const { return amount <= balance_; };
 
     void Deposit(double amount, const std::string &reason);
     void LogTransaction(BankAccountTransaction t);
+    void Note(const std::string &event);
     bool Withdraw(double amount, const std::string &reason);
 
   private:
     double balance_;
 
-    std::vector<BankAccountTransaction> transactions_;
+    Ledger transactions_;
+    std::uint64_t ledger_digest_ = 0;
+    bool keeps_ledger_ = true;
 };
 
+unsigned long CountAffordable(double balance, double unit_cost,
+                              unsigned long count);
 std::ostream &operator<<(std::ostream &os, const BankAccount &b);
 
 
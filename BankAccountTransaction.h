@@ -14,7 +14,9 @@
 
 enum class BankTransactionType {
   Deposit,
-  Withdrawal
+  Withdrawal,
+  // Moves no money; records something that happened, like a death.
+  Note
 };
 
 class BankAccountTransaction
@@ -0,0 +1,495 @@
+/*********************************************************************
+** Program Filename: Checkpoint.cpp
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Implements the Checkpointer class and RestoreCheckpoint.
+** Input: None
+** Output: None
+*********************************************************************/
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include "Checkpoint.h"
+
+namespace {
+
+// Flags in the tag of a group of ledger entries; the rest of the tag is
+// the entries' description index and type.
+static constexpr std::uint64_t GROUP_REPEATED = 1;
+static constexpr std::uint64_t GROUP_NEW_AMOUNT = 2;
+static constexpr unsigned GROUP_TYPE_SHIFT = 2;
+// Enough for every BankTransactionType.
+static constexpr std::uint64_t GROUP_TYPE_MASK = 3;
+static constexpr unsigned GROUP_DESCRIPTION_SHIFT = 4;
+
+/*********************************************************************
+** Function: PutVarint
+** Description: Appends a number to a delta body, seven bits per byte,
+ * low bits first.
+** Parameters: body is the body being built; v is the number.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void PutVarint(std::string &body, std::uint64_t v) {
+  for (; v >= 0x80; v >>= 7)
+    body.push_back(static_cast<char>((v & 0x7f) | 0x80));
+  body.push_back(static_cast<char>(v));
+}
+
+/*********************************************************************
+** Function: PutRaw
+** Description: Appends a value to a delta body byte for byte.
+** Parameters: body is the body being built; t is the value.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+template <class T>
+void PutRaw(std::string &body, const T &t) {
+  body.append(reinterpret_cast<const char *>(&t), sizeof(t));
+}
+
+/*********************************************************************
+** Function: SameAmount
+** Description: Checks whether two amounts are bit for bit the same, as
+ * a restored ledger has to be.
+** Parameters: a and b are the amounts.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+bool SameAmount(double a, double b) {
+  return std::memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+/*********************************************************************
+** Function: LastAmounts
+** Description: Finds the last amount recorded under each description of
+ * an image's ledger, which the deltas that follow it are encoded against.
+** Parameters: image is the image.
+** Pre-Conditions: None
+** Post-Conditions: Descriptions never used have an amount of 0.
+*********************************************************************/
+std::vector<double> LastAmounts(const GameImage &image) {
+  std::vector<double> amounts(image.descriptions.size(), 0.0);
+  for (const auto &t : image.transactions)
+    if (t.description < amounts.size()) amounts[t.description] = t.amount;
+
+  return amounts;
+}
+
+/*********************************************************************
+** Function: AppendRun
+** Description: Appends a run of animals to a list of runs, merging it
+ * with the last run if they are of the same species and age.
+** Parameters: runs is the list; run is the run.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void AppendRun(std::vector<SavedAnimalRun> &runs, const SavedAnimalRun &run) {
+  if (run.count == 0) return;
+  if (!runs.empty() && runs.back().species == run.species &&
+      runs.back().age == run.age) {
+    runs.back().count += run.count;
+  } else {
+    runs.push_back(run);
+  }
+}
+
+// Reads a delta body, failing instead of reading past its end.
+class DeltaReader {
+  public:
+    DeltaReader(const char *data, std::size_t size):
+        p_(data), end_(data + size) {}
+
+    bool AtEnd() const { return p_ == end_; }
+
+    bool Varint(std::uint64_t &v) {
+      v = 0;
+      for (unsigned shift = 0; p_ != end_ && shift < 64; shift += 7) {
+        unsigned char c = static_cast<unsigned char>(*p_++);
+        v |= static_cast<std::uint64_t>(c & 0x7f) << shift;
+        if (!(c & 0x80)) return true;
+      }
+      return false;
+    }
+
+    template <class T>
+    bool Raw(T &t) {
+      if (static_cast<std::size_t>(end_ - p_) < sizeof(t)) return false;
+      std::memcpy(&t, p_, sizeof(t));
+      p_ += sizeof(t);
+      return true;
+    }
+
+    bool Bytes(std::string &s, std::uint64_t n) {
+      if (static_cast<std::uint64_t>(end_ - p_) < n) return false;
+      s.assign(p_, static_cast<std::size_t>(n));
+      p_ += n;
+      return true;
+    }
+
+  private:
+    const char *p_;
+    const char *end_;
+};
+
+/*********************************************************************
+** Function: ApplyDelta
+** Description: Turns the game as of one checkpoint into the game as of
+ * the next; see Checkpointer::WriteDelta for the format.
+** Parameters: image is the game; last_amounts is the last amount
+ * recorded under each description; data and size describe the body.
+** Pre-Conditions: The body's checksum has been checked.
+** Post-Conditions: Returns false if the body cannot be decoded, leaving
+ * image in an unspecified state.
+*********************************************************************/
+bool ApplyDelta(GameImage &image, std::vector<double> &last_amounts,
+                const char *data, std::size_t size) {
+  DeltaReader in(data, size);
+  std::uint64_t days, food_type, n;
+  if (!in.Varint(days) || !in.Varint(food_type) || !in.Raw(image.balance) ||
+      !in.Raw(image.base_food_cost) || !in.Varint(n))
+    return false;
+  image.day += static_cast<std::uint32_t>(days);
+  image.food_type = static_cast<std::uint32_t>(food_type);
+
+  std::ostringstream rng_os;
+  for (std::uint64_t i = 0; i != n; ++i) {
+    std::uint32_t word;
+    if (!in.Raw(word)) return false;
+    if (i) rng_os << ' ';
+    rng_os << word;
+  }
+  image.rng_state = rng_os.str();
+
+  // The runs that lost animals, then every run a day older per day.
+  std::vector<SavedAnimalRun> &runs = image.animals;
+  if (!in.Varint(n)) return false;
+  std::uint64_t index = 0;
+  for (std::uint64_t i = 0; i != n; ++i, ++index) {
+    std::uint64_t skip, kept;
+    if (!in.Varint(skip) || !in.Varint(kept)) return false;
+    index += skip;
+    if (index >= runs.size() || kept > runs[index].count) return false;
+    runs[index].count = kept;
+  }
+
+  std::vector<SavedAnimalRun> old_runs;
+  old_runs.swap(runs);
+  for (auto &r : old_runs) {
+    r.age += static_cast<std::uint32_t>(days);
+    AppendRun(runs, r);
+  }
+
+  if (!in.Varint(n)) return false;
+  for (std::uint64_t i = 0; i != n; ++i) {
+    std::uint64_t species, age, count;
+    if (!in.Varint(species) || !in.Varint(age) || !in.Varint(count))
+      return false;
+    AppendRun(runs, SavedAnimalRun{static_cast<std::uint32_t>(species),
+                                   static_cast<std::uint32_t>(age), count});
+  }
+
+  // New descriptions, then the new ledger entries in groups.
+  if (!in.Varint(n)) return false;
+  for (std::uint64_t i = 0; i != n; ++i) {
+    std::uint64_t length;
+    std::string description;
+    if (!in.Varint(length) || !in.Bytes(description, length)) return false;
+    image.descriptions.push_back(std::move(description));
+    last_amounts.push_back(0.0);
+  }
+
+  if (!in.Varint(n)) return false;
+  for (std::uint64_t i = 0; i != n; ++i) {
+    std::uint64_t tag, count = 1;
+    if (!in.Varint(tag)) return false;
+    std::uint64_t description = tag >> GROUP_DESCRIPTION_SHIFT;
+    if (description >= image.descriptions.size()) return false;
+    if ((tag & GROUP_NEW_AMOUNT) && !in.Raw(last_amounts[description]))
+      return false;
+    if (tag & GROUP_REPEATED) {
+      if (!in.Varint(count)) return false;
+      count += 2;
+    }
+
+    SavedTransaction t{
+        last_amounts[description], static_cast<std::uint32_t>(description),
+        static_cast<std::uint32_t>((tag >> GROUP_TYPE_SHIFT) &
+                                   GROUP_TYPE_MASK)};
+    image.transactions.insert(image.transactions.end(), count, t);
+  }
+
+  // The calendar is small, so each delta holds all of it.
+  if (!in.Varint(n)) return false;
+  image.scheduled_events.clear();
+  for (std::uint64_t i = 0; i != n; ++i) {
+    std::uint64_t days_ahead, type, species, count;
+    if (!in.Varint(days_ahead) || !in.Varint(type) || !in.Varint(species) ||
+        !in.Varint(count))
+      return false;
+    image.scheduled_events.push_back(SavedScheduledEvent{
+        static_cast<std::uint32_t>(image.day + days_ahead),
+        static_cast<std::uint32_t>(type), static_cast<std::uint32_t>(species),
+        0, count});
+  }
+
+  return in.AtEnd();
+}
+
+}
+
+/*********************************************************************
+** Function: Checkpointer
+** Description: Constructor for the Checkpointer class. The first
+ * checkpoint is always a base.
+** Parameters: prefix names the checkpoint files; full_every is how many
+ * checkpoints make up a base and its deltas.
+** Pre-Conditions: full_every > 0
+** Post-Conditions: None
+*********************************************************************/
+Checkpointer::Checkpointer(const std::string &prefix, unsigned full_every):
+    prefix_(prefix), full_every_(full_every), deltas_(full_every) {}
+
+/*********************************************************************
+** Function: Checkpoint
+** Description: Checkpoints a game, as a delta from the last checkpoint
+ * unless it is time for a new base.
+** Parameters: player and state are the game's player and state.
+** Pre-Conditions: None
+** Post-Conditions: Returns false if the checkpoint could not be written;
+ * the next one will then be a base.
+*********************************************************************/
+bool Checkpointer::Checkpoint(const Player &player, const GameState &state) {
+  bool ok;
+  if (deltas_ + 1 >= full_every_ || state.day < last_.day ||
+      player.bank_account().transactions().size() <
+          last_.transactions.size()) {
+    ok = WriteBase(player, state);
+  } else {
+    ok = WriteDelta(player, state);
+  }
+
+  if (!ok) deltas_ = full_every_;
+  return ok;
+}
+
+/*********************************************************************
+** Function: WriteBase
+** Description: Saves the game to the base file and empties the deltas
+ * file. The base is renamed into place first, so deltas left behind by
+ * a crash in between belong to the old base and are ignored.
+** Parameters: player and state are the game's player and state.
+** Pre-Conditions: None
+** Post-Conditions: Returns false if either file could not be written.
+*********************************************************************/
+bool Checkpointer::WriteBase(const Player &player, const GameState &state) {
+  GameImage image = MakeGameImage(player, state);
+  if (!WriteGameImage(prefix_ + ".base", image, &base_id_)) return false;
+  if (!std::ofstream(prefix_ + ".deltas", std::ios::binary | std::ios::trunc))
+    return false;
+
+  description_ids_.clear();
+  for (std::uint32_t i = 0; i != image.descriptions.size(); ++i)
+    description_ids_.emplace(image.descriptions[i], i);
+  last_amounts_ = LastAmounts(image);
+  last_ = std::move(image);
+  deltas_ = 0;
+  return true;
+}
+
+/*********************************************************************
+** Function: WriteDelta
+** Description: Appends the changes since the last checkpoint to the
+ * deltas file. The body is, in order: the days passed and the food type
+ * (varints); the balance and base food cost (raw doubles); the number of
+ * words in the random engine's state and the words (raw); the number of
+ * runs that lost animals and, for each, the runs skipped since the last
+ * one and the animals kept (varints); the number of runs added and their
+ * species, age and count (varints); the number of new descriptions and
+ * each one's length and text; the number of groups of identical ledger
+ * entries and, for each, a tag, the amount if it is not the last one
+ * recorded under the description (raw), and the count less two if the
+ * entry is repeated (varint); and the number of events pending on the
+ * calendar and, for each, the days until it is due, its type, species
+ * and count (varints).
+** Parameters: player and state are the game's player and state.
+** Pre-Conditions: A base has been written; the game has not gone back in
+ * time and its ledger has only grown since the last checkpoint.
+** Post-Conditions: Returns false if the file could not be written.
+*********************************************************************/
+bool Checkpointer::WriteDelta(const Player &player, const GameState &state) {
+  std::string body;
+  std::uint32_t days = state.day - last_.day;
+  PutVarint(body, days);
+  PutVarint(body, static_cast<std::uint32_t>(state.food_type));
+  PutRaw(body, player.MoneyRemaining());
+  PutRaw(body, state.base_food_cost);
+
+  std::ostringstream rng_os;
+  rng_os << state.rng_engine;
+  std::istringstream rng_is(rng_os.str());
+  std::vector<std::uint32_t> words{std::istream_iterator<std::uint32_t>(rng_is),
+                                   std::istream_iterator<std::uint32_t>()};
+  PutVarint(body, words.size());
+  body.append(reinterpret_cast<const char *>(words.data()),
+              words.size() * sizeof(std::uint32_t));
+
+  // Every animal has aged by the days passed; those removed since are
+  // missing from their runs, and those added since are at the end. Runs
+  // are matched greedily: any split of the zoo into kept and added
+  // animals decodes to the same zoo.
+  std::vector<SavedAnimalRun> runs = AnimalRuns(player.zoo());
+  std::string kept;
+  std::size_t n_changed = 0, last_changed = 0, j = 0;
+  std::uint64_t left = runs.empty() ? 0 : runs[0].count;
+  for (std::size_t i = 0; i != last_.animals.size(); ++i) {
+    const SavedAnimalRun &r = last_.animals[i];
+    std::uint64_t n = 0;
+    if (j != runs.size() && runs[j].species == r.species &&
+        runs[j].age == r.age + days) {
+      n = std::min(r.count, left);
+      left -= n;
+      if (left == 0 && ++j != runs.size()) left = runs[j].count;
+    }
+    if (n != r.count) {
+      PutVarint(kept, i - last_changed);
+      PutVarint(kept, n);
+      ++n_changed;
+      last_changed = i + 1;
+    }
+  }
+  PutVarint(body, n_changed);
+  body += kept;
+
+  PutVarint(body, runs.size() - j);
+  for (std::size_t k = j; k != runs.size(); ++k) {
+    PutVarint(body, runs[k].species);
+    PutVarint(body, runs[k].age);
+    PutVarint(body, k == j ? left : runs[k].count);
+  }
+
+  const Ledger &ledger = player.bank_account().transactions();
+  std::size_t first_new = last_.transactions.size();
+  std::size_t first_new_description = last_.descriptions.size();
+  for (std::size_t k = first_new; k != ledger.size(); ++k) {
+    const BankAccountTransaction &t = ledger[k];
+    auto it = description_ids_.emplace(
+        t.description(), static_cast<std::uint32_t>(description_ids_.size()));
+    if (it.second) {
+      last_.descriptions.push_back(t.description());
+      last_amounts_.push_back(0.0);
+    }
+    last_.transactions.push_back(SavedTransaction{
+        t.amount(), it.first->second, static_cast<std::uint32_t>(t.type())});
+  }
+
+  PutVarint(body, last_.descriptions.size() - first_new_description);
+  for (std::size_t k = first_new_description; k != last_.descriptions.size();
+       ++k) {
+    PutVarint(body, last_.descriptions[k].size());
+    body += last_.descriptions[k];
+  }
+
+  std::string groups;
+  std::size_t n_groups = 0;
+  for (std::size_t k = first_new; k != last_.transactions.size(); ++n_groups) {
+    const SavedTransaction &t = last_.transactions[k];
+    std::size_t end = k + 1;
+    while (end != last_.transactions.size() &&
+           last_.transactions[end].description == t.description &&
+           last_.transactions[end].type == t.type &&
+           SameAmount(last_.transactions[end].amount, t.amount))
+      ++end;
+
+    bool new_amount = !SameAmount(last_amounts_[t.description], t.amount);
+    PutVarint(groups,
+              static_cast<std::uint64_t>(t.description)
+                  << GROUP_DESCRIPTION_SHIFT |
+              static_cast<std::uint64_t>(t.type) << GROUP_TYPE_SHIFT |
+              (new_amount ? GROUP_NEW_AMOUNT : 0) |
+              (end - k > 1 ? GROUP_REPEATED : 0));
+    if (new_amount) PutRaw(groups, t.amount);
+    if (end - k > 1) PutVarint(groups, end - k - 2);
+    last_amounts_[t.description] = t.amount;
+    k = end;
+  }
+  PutVarint(body, n_groups);
+  body += groups;
+
+  std::vector<SavedScheduledEvent> events = ScheduledEvents(state.calendar);
+  PutVarint(body, events.size());
+  for (const SavedScheduledEvent &e : events) {
+    PutVarint(body, e.due_day - state.day);
+    PutVarint(body, e.type);
+    PutVarint(body, e.species);
+    PutVarint(body, e.count);
+  }
+
+  last_.balance = player.MoneyRemaining();
+  last_.base_food_cost = state.base_food_cost;
+  last_.day = state.day;
+  last_.food_type = static_cast<std::uint32_t>(state.food_type);
+  last_.animals = std::move(runs);
+  last_.scheduled_events = std::move(events);
+  last_.rng_state = rng_os.str();
+
+  CheckpointDeltaHeader header;
+  header.magic = CHECKPOINT_DELTA_MAGIC;
+  header.body_size = static_cast<std::uint32_t>(body.size());
+  header.base_id = base_id_;
+  header.body_checksum = Checksum64(body.data(), body.size());
+
+  std::ofstream out(prefix_ + ".deltas", std::ios::binary | std::ios::app);
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.write(body.data(), static_cast<std::streamsize>(body.size()));
+  out.flush();
+  if (!out) return false;
+
+  ++deltas_;
+  return true;
+}
+
+/*********************************************************************
+** Function: RestoreCheckpoint
+** Description: Restores a game from its last checkpoint: the base, and
+ * then every delta written since. A delta cut short or damaged, as a
+ * crash while writing it would leave it, ends the chain.
+** Parameters: prefix names the checkpoint files; error receives a
+ * description of what went wrong, if anything.
+** Pre-Conditions: None
+** Post-Conditions: Returns None if the base could not be read, or a
+ * delta that passed its checksum could not be decoded.
+*********************************************************************/
+Option<SavedGame> RestoreCheckpoint(const std::string &prefix,
+                                    std::string &error) {
+  GameImage image;
+  std::uint64_t base_id;
+  if (!ReadGameImage(prefix + ".base", image, error, &base_id)) return None;
+  std::vector<double> last_amounts = LastAmounts(image);
+
+  std::ifstream in(prefix + ".deltas", std::ios::binary);
+  std::string deltas{std::istreambuf_iterator<char>(in),
+                     std::istreambuf_iterator<char>()};
+
+  CheckpointDeltaHeader header;
+  for (std::size_t p = 0; deltas.size() - p >= sizeof(header);) {
+    std::memcpy(&header, deltas.data() + p, sizeof(header));
+    p += sizeof(header);
+    const char *body = deltas.data() + p;
+    if (header.magic != CHECKPOINT_DELTA_MAGIC ||
+        header.body_size > deltas.size() - p ||
+        header.body_checksum != Checksum64(body, header.body_size))
+      break;
+    p += header.body_size;
+
+    if (header.base_id != base_id) continue;
+    if (!ApplyDelta(image, last_amounts, body, header.body_size)) {
+      error = "the checkpoint is corrupt";
+      return None;
+    }
+  }
+
+  return GameFromImage(image, error);
+}
@@ -0,0 +1,79 @@
+#ifndef ZOO_TYCOON_CHECKPOINT_H
+#define ZOO_TYCOON_CHECKPOINT_H
+/*********************************************************************
+** Program Filename: Checkpoint.h
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Declares the Checkpointer class, which checkpoints a long
+ * game as a full save file followed by small deltas, and the function
+ * that restores a game from its checkpoints.
+** Input: None
+** Output: None
+*********************************************************************/
+
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "SaveFile.h"
+
+// A checkpoint with prefix P is the save file P.base and the append-only
+// file P.deltas. Each record in P.deltas is a CheckpointDeltaHeader and a
+// body that turns the game as of the previous checkpoint into the game as
+// of this one: the day and age delta, the balance and base food cost, the
+// random engine's state, the animals kept of each run that lost some, the
+// animals added, the ledger entries added, and the events pending on the
+// game's calendar. Numbers in the body are varints wherever they are
+// usually small.
+//
+// Every full_every-th checkpoint writes a new base and empties P.deltas,
+// so the files never hold more than full_every checkpoints' worth, and
+// restoring never replays more than full_every - 1 deltas.
+static constexpr std::uint32_t CHECKPOINT_DELTA_MAGIC = 0x544c445a;
+static constexpr unsigned DEFAULT_CHECKPOINT_FULL_EVERY = 16;
+// How often ZooTycoon checkpoints a game by default, in days.
+static constexpr unsigned DEFAULT_CHECKPOINT_DAYS = 200;
+
+struct CheckpointDeltaHeader {
+  std::uint32_t magic;
+  std::uint32_t body_size;
+  // The header checksum of the base the delta applies to; deltas left
+  // over from an older base are ignored.
+  std::uint64_t base_id;
+  // Checksum64 of the body.
+  std::uint64_t body_checksum;
+};
+
+class Checkpointer {
+  public:
+    explicit Checkpointer(
+        const std::string &prefix,
+        unsigned full_every = DEFAULT_CHECKPOINT_FULL_EVERY);
+
+    const std::string &prefix() const { return prefix_; }
+
+    bool Checkpoint(const Player &player, const GameState &state);
+
+  private:
+    std::string prefix_;
+    unsigned full_every_;
+    // Deltas written since the last base, or full_every_ if there is none.
+    unsigned deltas_;
+    std::uint64_t base_id_ = 0;
+
+    // The game as of the last checkpoint, and what the encoder needs to
+    // carry on from it.
+    GameImage last_;
+    std::unordered_map<std::string, std::uint32_t> description_ids_;
+    std::vector<double> last_amounts_;
+
+    bool WriteBase(const Player &player, const GameState &state);
+    bool WriteDelta(const Player &player, const GameState &state);
+};
+
+Option<SavedGame> RestoreCheckpoint(const std::string &prefix,
+                                    std::string &error);
+
+
+#endif //ZOO_TYCOON_CHECKPOINT_H
@@ -0,0 +1,397 @@
+#ifndef ZOO_TYCOON_COWARRAY_H
+#define ZOO_TYCOON_COWARRAY_H
+/*********************************************************************
+** Program Filename: CowArray.h
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Declares the CowArray template class and its related
+ * members.
+** Input: None
+** Output: None
+*********************************************************************/
+
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+static constexpr std::size_t COW_ARRAY_CHUNK_BITS = 9;
+static constexpr std::size_t COW_ARRAY_CHUNK_SIZE =
+    std::size_t(1) << COW_ARRAY_CHUNK_BITS;
+
+// CowArray holds a list of plain values in chunks of COW_ARRAY_CHUNK_SIZE
+// elements (the last one may be shorter), which copies of the list share
+// until one of them changes a chunk (copy on write), like CowVector. Its
+// chunks all have the same size, so element i is found in O(1), by shift
+// and mask, for the structures that index their elements all the time
+// (FenwickTree, CohortHeap, AnimalCohorts). Copying a CowArray costs
+// O(chunks), and each change afterwards copies at most the chunk it
+// touches. Elements are only ever changed through Mutable and the other
+// non-const members; once a CowArray has been copied, any of those may
+// move its elements, so references to them obtained earlier must not be
+// used.
+//
+// Each chunk is one allocation, its reference count followed by its
+// elements, so that indexing costs the same two loads as a vector of
+// vectors and checking that a chunk is unshared touches nothing else.
+// Like std::vector, clear, pop_back and Truncate keep the memory the
+// elements used (unless other copies share it), so adding the elements
+// back does not allocate.
+template <class T>
+class CowArray {
+    static_assert(std::is_trivially_destructible<T>::value,
+                  "CowArray never destroys its elements");
+
+  public:
+    using size_type = std::size_t;
+    using value_type = T;
+
+    CowArray() {}
+    CowArray(const CowArray &other);
+    CowArray(CowArray &&other) noexcept;
+    ~CowArray();
+    CowArray &operator=(CowArray other) noexcept;
+
+    size_type size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const T &front() const { return chunks_[0]->data()[0]; }
+    const T &back() const { return (*this)[size_ - 1]; }
+    const T &operator[](size_type i) const {
+      return chunks_[i >> COW_ARRAY_CHUNK_BITS]
+          ->data()[i & (COW_ARRAY_CHUNK_SIZE - 1)];
+    }
+    template <class F>
+    void ForEach(F f) const;
+    template <class F>
+    size_type PartitionPoint(F f) const;
+
+    void clear() { Truncate(0); }
+    void EraseFront(size_type n);
+    void Insert(size_type i, const T &t);
+    T &Mutable(size_type i) {
+      return MutableData(i >> COW_ARRAY_CHUNK_BITS)
+          [i & (COW_ARRAY_CHUNK_SIZE - 1)];
+    }
+    void pop_back() { Truncate(size_ - 1); }
+    void push_back(const T &t);
+    void reserve(size_type n);
+    void Truncate(size_type n);
+
+  private:
+    // A chunk's elements follow it in the same allocation; only the
+    // first Count(c) of chunk c's capacity are constructed.
+    struct Chunk {
+      std::atomic<long> refs;
+      size_type capacity;
+
+      explicit Chunk(size_type capacity) : refs(1), capacity(capacity) {}
+      T *data() { return reinterpret_cast<T *>(this + 1); }
+    };
+    static_assert(alignof(T) <= alignof(Chunk),
+                  "CowArray elements follow their Chunk unpadded");
+
+    // Chunks past the ones holding elements are either null or unshared,
+    // kept for the memory they reserved.
+    std::vector<Chunk *> chunks_;
+    size_type size_ = 0;
+
+    // The elements of chunk c, which this CowArray holds alone.
+    T *MutableData(size_type c) {
+      Chunk *chunk = chunks_[c];
+      if (chunk->refs.load(std::memory_order_acquire) != 1)
+        chunk = Reallocate(c, chunk->capacity);
+      return chunk->data();
+    }
+    size_type Count(size_type c) const;
+    Chunk *Reallocate(size_type c, size_type capacity);
+    static void Release(Chunk *chunk);
+};
+
+/*********************************************************************
+** Function: CowArray
+** Description: Copy constructor; shares other's chunks, in O(chunks).
+** Parameters: other is the CowArray to copy.
+** Pre-Conditions: None
+** Post-Conditions: The CowArray has the same elements as other.
+*********************************************************************/
+template <class T>
+CowArray<T>::CowArray(const CowArray &other)
+    : chunks_(other.chunks_.begin(),
+              other.chunks_.begin() +
+                  ((other.size_ + COW_ARRAY_CHUNK_SIZE - 1) >>
+                   COW_ARRAY_CHUNK_BITS)),
+      size_(other.size_) {
+  for (Chunk *chunk : chunks_)
+    chunk->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+/*********************************************************************
+** Function: CowArray
+** Description: Move constructor; takes other's chunks.
+** Parameters: other is the CowArray to move from.
+** Pre-Conditions: None
+** Post-Conditions: other is empty.
+*********************************************************************/
+template <class T>
+CowArray<T>::CowArray(CowArray &&other) noexcept
+    : chunks_(std::move(other.chunks_)), size_(other.size_) {
+  other.chunks_.clear();
+  other.size_ = 0;
+}
+
+/*********************************************************************
+** Function: ~CowArray
+** Description: Destructor; frees the chunks no other copy shares.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+template <class T>
+CowArray<T>::~CowArray() {
+  for (Chunk *chunk : chunks_) Release(chunk);
+}
+
+/*********************************************************************
+** Function: operator=
+** Description: Assignment operator, by copy (or move) and swap.
+** Parameters: other is the CowArray to assign from.
+** Pre-Conditions: None
+** Post-Conditions: The CowArray has the same elements as other.
+*********************************************************************/
+template <class T>
+CowArray<T> &CowArray<T>::operator=(CowArray other) noexcept {
+  chunks_.swap(other.chunks_);
+  std::swap(size_, other.size_);
+  return *this;
+}
+
+/*********************************************************************
+** Function: ForEach
+** Description: Calls f with each element, in order, a chunk at a time,
+ * which is quicker than indexing them one by one.
+** Parameters: f is the function to call.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+template <class T>
+template <class F>
+void CowArray<T>::ForEach(F f) const {
+  for (size_type c = 0; c << COW_ARRAY_CHUNK_BITS < size_; ++c)
+    for (const T *t = chunks_[c]->data(), *end = t + Count(c); t != end; ++t)
+      f(*t);
+}
+
+/*********************************************************************
+** Function: PartitionPoint
+** Description: Returns the index of the first element f is false for,
+ * in O(log size()), like std::partition_point.
+** Parameters: f is called with elements.
+** Pre-Conditions: f is true for the elements before some index and false
+ * for the rest.
+** Post-Conditions: None
+*********************************************************************/
+template <class T>
+template <class F>
+typename CowArray<T>::size_type CowArray<T>::PartitionPoint(F f) const {
+  size_type first = 0, count = size_;
+  while (count) {
+    size_type half = count / 2;
+    if (f((*this)[first + half])) {
+      first += half + 1;
+      count -= half + 1;
+    } else {
+      count = half;
+    }
+  }
+  return first;
+}
+
+/*********************************************************************
+** Function: EraseFront
+** Description: Removes the first n elements, moving the rest down, in
+ * O(size()).
+** Parameters: n is the number of elements to remove.
+** Pre-Conditions: n <= size().
+** Post-Conditions: size() has shrunk by n.
+*********************************************************************/
+template <class T>
+void CowArray<T>::EraseFront(size_type n) {
+  if (n == 0) return;
+  // Copy runs that stay within one chunk on both sides.
+  for (size_type to = 0, from = n; from != size_;) {
+    T *dst = MutableData(to >> COW_ARRAY_CHUNK_BITS) +
+             (to & (COW_ARRAY_CHUNK_SIZE - 1));
+    const T *src = chunks_[from >> COW_ARRAY_CHUNK_BITS]->data() +
+                   (from & (COW_ARRAY_CHUNK_SIZE - 1));
+    size_type run = std::min({COW_ARRAY_CHUNK_SIZE -
+                                  (to & (COW_ARRAY_CHUNK_SIZE - 1)),
+                              COW_ARRAY_CHUNK_SIZE -
+                                  (from & (COW_ARRAY_CHUNK_SIZE - 1)),
+                              size_ - from});
+    std::copy(src, src + run, dst);
+    to += run;
+    from += run;
+  }
+  Truncate(size_ - n);
+}
+
+/*********************************************************************
+** Function: Insert
+** Description: Inserts an element before element i, moving the ones
+ * after it up, in O(size() - i).
+** Parameters: i is where the element goes; t is the element.
+** Pre-Conditions: i <= size().
+** Post-Conditions: None
+*********************************************************************/
+template <class T>
+void CowArray<T>::Insert(size_type i, const T &t) {
+  push_back(t);
+  // Copy runs that stay within one chunk on both sides, last first; to
+  // and from are one past the ends of the runs.
+  for (size_type to = size_, from = size_ - 1; from != i;) {
+    T *dst = MutableData((to - 1) >> COW_ARRAY_CHUNK_BITS) +
+             ((to - 1) & (COW_ARRAY_CHUNK_SIZE - 1)) + 1;
+    const T *src = chunks_[(from - 1) >> COW_ARRAY_CHUNK_BITS]->data() +
+                   ((from - 1) & (COW_ARRAY_CHUNK_SIZE - 1)) + 1;
+    size_type run = std::min({((to - 1) & (COW_ARRAY_CHUNK_SIZE - 1)) + 1,
+                              ((from - 1) & (COW_ARRAY_CHUNK_SIZE - 1)) + 1,
+                              from - i});
+    std::copy_backward(src - run, src, dst);
+    to -= run;
+    from -= run;
+  }
+  Mutable(i) = t;
+}
+
+/*********************************************************************
+** Function: push_back
+** Description: Appends an element. The last chunk grows by doubling,
+ * up to COW_ARRAY_CHUNK_SIZE elements.
+** Parameters: t is the element.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+template <class T>
+void CowArray<T>::push_back(const T &t) {
+  size_type c = size_ >> COW_ARRAY_CHUNK_BITS;
+  size_type offset = size_ & (COW_ARRAY_CHUNK_SIZE - 1);
+  if (c == chunks_.size()) chunks_.push_back(nullptr);
+  Chunk *chunk = chunks_[c];
+  if (!chunk || chunk->capacity == offset ||
+      chunk->refs.load(std::memory_order_acquire) != 1) {
+    size_type capacity = !chunk ? (c ? COW_ARRAY_CHUNK_SIZE : 1) :
+        chunk->capacity != offset ? chunk->capacity :
+        offset * 2 < COW_ARRAY_CHUNK_SIZE ? offset * 2 :
+        COW_ARRAY_CHUNK_SIZE;
+    chunk = Reallocate(c, capacity);
+  }
+  new (chunk->data() + offset) T(t);
+  ++size_;
+}
+
+/*********************************************************************
+** Function: reserve
+** Description: Makes room for n elements, in the chunks no other copy
+ * shares.
+** Parameters: n is the number of elements.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+template <class T>
+void CowArray<T>::reserve(size_type n) {
+  size_type n_chunks = (n + COW_ARRAY_CHUNK_SIZE - 1) >> COW_ARRAY_CHUNK_BITS;
+  if (chunks_.size() < n_chunks) chunks_.resize(n_chunks, nullptr);
+  for (size_type c = 0; c != n_chunks; ++c) {
+    Chunk *chunk = chunks_[c];
+    size_type first = c << COW_ARRAY_CHUNK_BITS;
+    size_type capacity = n - first < COW_ARRAY_CHUNK_SIZE ?
+                         n - first : COW_ARRAY_CHUNK_SIZE;
+    if (!chunk || (chunk->capacity < capacity &&
+                   chunk->refs.load(std::memory_order_acquire) == 1))
+      Reallocate(c, capacity);
+  }
+}
+
+/*********************************************************************
+** Function: Truncate
+** Description: Removes the elements from index n on. The chunks left
+ * empty are kept for their memory, unless other copies share them.
+** Parameters: n is the number of elements to keep.
+** Pre-Conditions: n <= size().
+** Post-Conditions: size() is n.
+*********************************************************************/
+template <class T>
+void CowArray<T>::Truncate(size_type n) {
+  for (size_type c = (n + COW_ARRAY_CHUNK_SIZE - 1) >> COW_ARRAY_CHUNK_BITS;
+       c != chunks_.size(); ++c) {
+    Chunk *&chunk = chunks_[c];
+    if (chunk && chunk->refs.load(std::memory_order_acquire) != 1) {
+      Release(chunk);
+      chunk = nullptr;
+    }
+  }
+  size_ = n;
+}
+
+/*********************************************************************
+** Function: Count
+** Description: Returns the number of elements chunk c holds.
+** Parameters: c is the index of the chunk.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+template <class T>
+typename CowArray<T>::size_type CowArray<T>::Count(size_type c) const {
+  size_type first = c << COW_ARRAY_CHUNK_BITS;
+  if (size_ <= first) return 0;
+  return size_ - first < COW_ARRAY_CHUNK_SIZE ?
+         size_ - first : COW_ARRAY_CHUNK_SIZE;
+}
+
+/*********************************************************************
+** Function: Reallocate
+** Description: Replaces chunk c (which may be null) with a chunk of its
+ * own with room for capacity elements, copying its elements over;
+ * the slow path of the members that change elements.
+** Parameters: c is the index of the chunk; capacity is its new capacity.
+** Pre-Conditions: c < the number of chunks; capacity >= Count(c).
+** Post-Conditions: Only this CowArray holds chunk c.
+*********************************************************************/
+template <class T>
+typename CowArray<T>::Chunk *CowArray<T>::Reallocate(size_type c,
+                                                     size_type capacity) {
+  Chunk *copy = new (::operator new(sizeof(Chunk) + capacity * sizeof(T)))
+      Chunk(capacity);
+  Chunk *&chunk = chunks_[c];
+  if (chunk) {
+    const T *from = chunk->data();
+    T *to = copy->data();
+    for (size_type i = 0, n = Count(c); i != n; ++i) new (to + i) T(from[i]);
+    Release(chunk);
+  }
+  chunk = copy;
+  return copy;
+}
+
+/*********************************************************************
+** Function: Release
+** Description: Drops a reference to chunk, freeing it if it was the
+ * last one.
+** Parameters: chunk is the chunk, or null.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+template <class T>
+void CowArray<T>::Release(Chunk *chunk) {
+  if (chunk && chunk->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    chunk->~Chunk();
+    ::operator delete(chunk);
+  }
+}
+
+
+#endif //ZOO_TYCOON_COWARRAY_H
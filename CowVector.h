@@ -0,0 +1,288 @@
+#ifndef ZOO_TYCOON_COWVECTOR_H
+#define ZOO_TYCOON_COWVECTOR_H
+/*********************************************************************
+** Program Filename: CowVector.h
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Declares the CowVector template class and its related
+ * members.
+** Input: None
+** Output: None
+*********************************************************************/
+
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+static constexpr std::size_t COW_VECTOR_CHUNK_SIZE = 512;
+
+// Copies a CowVector element when its chunk stops being shared; element
+// types that cannot simply be copy-constructed provide their own.
+template <class T>
+struct CowCopy {
+  T operator()(const T &t) const { return t; }
+};
+
+// CowVector holds a list of T in chunks of up to COW_VECTOR_CHUNK_SIZE
+// elements, which copies of the list share until one of them changes a
+// chunk (copy on write). Copying a CowVector costs O(chunks), and each
+// change afterwards copies at most the chunk it touches, with Copy.
+// Elements are only ever changed through push_back, erase, EraseIf and
+// ForEachMutable; once a CowVector has been copied, any of those may move
+// its elements, so references to them obtained earlier must not be used.
+template <class T, class Copy = CowCopy<T>>
+class CowVector {
+  public:
+    using size_type = std::size_t;
+    using value_type = T;
+    class const_iterator;
+
+    CowVector() {}
+    explicit CowVector(std::vector<T> &&v);
+
+    size_type size() const { return ends_.empty() ? 0 : ends_.back(); }
+    bool empty() const { return ends_.empty(); }
+    const T &back() const { return chunks_.back()->back(); }
+    const_iterator begin() const { return const_iterator(this, 0, 0); }
+    const_iterator end() const
+        { return const_iterator(this, chunks_.size(), 0); }
+    const T &operator[](size_type i) const;
+
+    const_iterator erase(const_iterator it);
+    template <class F>
+    void EraseIf(F f);
+    template <class F>
+    void ForEachMutable(F f);
+    void push_back(T t);
+    void reserve(size_type n);
+
+  private:
+    using Chunk = std::vector<T>;
+
+    std::vector<std::shared_ptr<Chunk>> chunks_;
+    // ends_[c] is the index one past the last element of chunk c; no
+    // chunk is ever empty.
+    std::vector<size_type> ends_;
+
+    Chunk &MutableChunk(size_type c);
+};
+
+template <class T, class Copy>
+class CowVector<T, Copy>::const_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T *;
+    using reference = const T &;
+
+    const_iterator(): v_(nullptr), chunk_(0), offset_(0) {}
+
+    reference operator*() const { return (*v_->chunks_[chunk_])[offset_]; }
+    pointer operator->() const { return &**this; }
+    const_iterator &operator++() {
+      if (++offset_ == v_->chunks_[chunk_]->size()) {
+        ++chunk_;
+        offset_ = 0;
+      }
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator it = *this;
+      ++*this;
+      return it;
+    }
+    bool operator==(const const_iterator &rhs) const
+        { return chunk_ == rhs.chunk_ && offset_ == rhs.offset_; }
+    bool operator!=(const const_iterator &rhs) const
+        { return !(*this == rhs); }
+
+  private:
+    friend class CowVector;
+
+    const_iterator(const CowVector *v, size_type chunk, size_type offset):
+        v_(v), chunk_(chunk), offset_(offset) {}
+
+    const CowVector *v_;
+    size_type chunk_;
+    size_type offset_;
+};
+
+/*********************************************************************
+** Function: CowVector
+** Description: Constructor for the CowVector class that takes over the
+ * elements of a vector.
+** Parameters: v is the vector.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+template <class T, class Copy>
+CowVector<T, Copy>::CowVector(std::vector<T> &&v) {
+  reserve(v.size());
+  for (auto &t : v)
+    push_back(std::move(t));
+}
+
+/*********************************************************************
+** Function: operator[]
+** Description: Returns the i-th element, in O(log chunks).
+** Parameters: i is the index of the element.
+** Pre-Conditions: i < size().
+** Post-Conditions: None
+*********************************************************************/
+template <class T, class Copy>
+const T &CowVector<T, Copy>::operator[](size_type i) const {
+  size_type c = std::upper_bound(ends_.begin(), ends_.end(), i) -
+                ends_.begin();
+  return (*chunks_[c])[i - (c ? ends_[c - 1] : 0)];
+}
+
+/*********************************************************************
+** Function: erase
+** Description: Removes an element, copying its chunk first if it is
+ * shared. A chunk left empty is dropped.
+** Parameters: it points to the element.
+** Pre-Conditions: it is a valid iterator into this CowVector, other than
+ * end().
+** Post-Conditions: Returns an iterator to the element after the one
+ * removed.
+*********************************************************************/
+template <class T, class Copy>
+typename CowVector<T, Copy>::const_iterator
+CowVector<T, Copy>::erase(const_iterator it) {
+  size_type c = it.chunk_;
+  Chunk &chunk = MutableChunk(c);
+  chunk.erase(chunk.begin() + it.offset_);
+  for (size_type i = c; i != ends_.size(); ++i)
+    --ends_[i];
+
+  if (chunk.empty()) {
+    chunks_.erase(chunks_.begin() + c);
+    ends_.erase(ends_.begin() + c);
+    return const_iterator(this, c, 0);
+  }
+  if (it.offset_ == chunk.size()) return const_iterator(this, c + 1, 0);
+  return it;
+}
+
+/*********************************************************************
+** Function: EraseIf
+** Description: Removes the elements f picks, keeping the others in
+ * order, in O(size()). Chunks that lose no elements are left alone (and
+ * stay shared); the others are copied first if they are shared. Chunks
+ * left empty are dropped.
+** Parameters: f is called with the index of each element, and returns
+ * whether to remove it.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+template <class T, class Copy>
+template <class F>
+void CowVector<T, Copy>::EraseIf(F f) {
+  std::vector<bool> erased(size());
+  for (size_type i = 0; i != erased.size(); ++i)
+    erased[i] = f(i);
+
+  size_type kept_chunks = 0, first = 0, end = 0;
+  for (size_type c = 0; c != chunks_.size(); ++c) {
+    // The chunk's elements were [first, last) before any were erased.
+    size_type last = first + chunks_[c]->size();
+    if (std::find(erased.begin() + first, erased.begin() + last, true) !=
+        erased.begin() + last) {
+      Chunk &chunk = MutableChunk(c);
+      size_type n = 0;
+      for (size_type j = 0; j != chunk.size(); ++j)
+        if (!erased[first + j]) chunk[n++] = std::move(chunk[j]);
+      chunk.erase(chunk.begin() + n, chunk.end());
+    }
+    first = last;
+
+    if (chunks_[c]->empty()) continue;
+    end += chunks_[c]->size();
+    chunks_[kept_chunks] = std::move(chunks_[c]);
+    ends_[kept_chunks++] = end;
+  }
+
+  chunks_.resize(kept_chunks);
+  ends_.resize(kept_chunks);
+}
+
+/*********************************************************************
+** Function: ForEachMutable
+** Description: Calls f with a reference to every element, in order,
+ * copying each shared chunk first.
+** Parameters: f is the function to call.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+template <class T, class Copy>
+template <class F>
+void CowVector<T, Copy>::ForEachMutable(F f) {
+  for (size_type c = 0; c != chunks_.size(); ++c)
+    for (auto &t : MutableChunk(c))
+      f(t);
+}
+
+/*********************************************************************
+** Function: push_back
+** Description: Appends an element, to the last chunk if it has room.
+** Parameters: t is the element.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+template <class T, class Copy>
+void CowVector<T, Copy>::push_back(T t) {
+  if (chunks_.empty() || chunks_.back()->size() == COW_VECTOR_CHUNK_SIZE) {
+    size_type n = size();
+    chunks_.push_back(std::make_shared<Chunk>());
+    chunks_.back()->reserve(COW_VECTOR_CHUNK_SIZE);
+    ends_.push_back(n);
+  }
+
+  MutableChunk(chunks_.size() - 1).push_back(std::move(t));
+  ++ends_.back();
+}
+
+/*********************************************************************
+** Function: reserve
+** Description: Makes room for the chunks n elements need.
+** Parameters: n is the number of elements.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+template <class T, class Copy>
+void CowVector<T, Copy>::reserve(size_type n) {
+  size_type n_chunks = (n + COW_VECTOR_CHUNK_SIZE - 1) / COW_VECTOR_CHUNK_SIZE;
+  chunks_.reserve(n_chunks);
+  ends_.reserve(n_chunks);
+}
+
+/*********************************************************************
+** Function: MutableChunk
+** Description: Returns chunk c, first replacing it with a copy of its
+ * own if another CowVector shares it.
+** Parameters: c is the index of the chunk.
+** Pre-Conditions: c < the number of chunks.
+** Post-Conditions: Only this CowVector holds chunk c.
+*********************************************************************/
+template <class T, class Copy>
+typename CowVector<T, Copy>::Chunk &
+CowVector<T, Copy>::MutableChunk(size_type c) {
+  if (chunks_[c].use_count() != 1) {
+    const Chunk &shared = *chunks_[c];
+    std::shared_ptr<Chunk> copy = std::make_shared<Chunk>();
+    copy->reserve(std::max(shared.size(), COW_VECTOR_CHUNK_SIZE));
+    Copy copy_element;
+    for (const auto &t : shared)
+      copy->push_back(copy_element(t));
+    chunks_[c] = std::move(copy);
+  }
+
+  return *chunks_[c];
+}
+
+
+#endif //ZOO_TYCOON_COWVECTOR_H
@@ -8,6 +8,7 @@
 ** Output: None
 *********************************************************************/
 #include "Elephant.h"
+#include "AnimalSpecies.h"
 
 /*********************************************************************
 ** Function: Elephant
@@ -17,8 +18,10 @@
 ** Post-Conditions: None
 *********************************************************************/
 Elephant::Elephant(unsigned age):
-    Animal("Elephant", age, ELEPHANT_UNIT_COST,
+    Animal(AnimalSpecies::Elephant, "Elephant", age, ELEPHANT_UNIT_COST,
            ELEPHANT_BABIES_PER_BIRTH, ELEPHANT_FOOD_COST_MULTIPLIER,
+           ELEPHANT_DAILY_BIRTH_CHANCE, ELEPHANT_DAILY_SICKNESS_CHANCE,
+           ELEPHANT_GESTATION_DAYS, ELEPHANT_LIFESPAN,
            ELEPHANT_REVENUE_PCT) {}
 
 /*********************************************************************
@@ -15,6 +15,10 @@
 static constexpr unsigned ELEPHANT_UNIT_COST = 24000;
 static constexpr unsigned ELEPHANT_BABIES_PER_BIRTH = 1;
 static constexpr unsigned ELEPHANT_FOOD_COST_MULTIPLIER = 8;
+static constexpr double ELEPHANT_DAILY_BIRTH_CHANCE = 0.0005;
+static constexpr double ELEPHANT_DAILY_SICKNESS_CHANCE = 0.0015;
+static constexpr unsigned ELEPHANT_GESTATION_DAYS = 660;
+static constexpr unsigned ELEPHANT_LIFESPAN = 365 * 60;
 static constexpr double ELEPHANT_REVENUE_PCT = 0.16;
 
 class Elephant: public Animal {
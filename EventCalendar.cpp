@@ -0,0 +1,109 @@
+/*********************************************************************
+** Program Filename: EventCalendar.cpp
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Implements functions declared by the EventCalendar class.
+** Input: None
+** Output: None
+*********************************************************************/
+#include "EventCalendar.h"
+#include "Utils.h"
+
+/*********************************************************************
+** Function: Schedule
+** Description: Schedules an event for a later day; an event due on a
+ * day whose events have already been taken is due the next day instead.
+** Parameters: due_day is the day the event is due; e is the event.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void EventCalendar::Schedule(unsigned due_day, const ScheduledEvent &e) {
+  if (due_day <= day_) due_day = day_ + 1;
+  Entry entry{due_day, e};
+  Place(entry);
+  ++size_;
+  digest_ += EntryDigest(entry);
+}
+
+/*********************************************************************
+** Function: TakeDue
+** Description: Takes the events due on the days after day() up to the
+ * given one, moving the calendar on to that day. The events of a day
+ * come in no particular order, though always the same one for the same
+ * schedule.
+** Parameters: day is the day to move on to.
+** Pre-Conditions: None
+** Post-Conditions: day() is at least day.
+*********************************************************************/
+std::vector<ScheduledEvent> EventCalendar::TakeDue(unsigned day) {
+  std::vector<ScheduledEvent> due;
+  // Without pending events, the wheels are empty wherever the day is.
+  if (size_ == 0 && day > day_) day_ = day;
+
+  while (day_ < day) {
+    ++day_;
+    // Spread the slots the day has just carried into, from the highest
+    // wheel down, so that their events end up in the first wheel.
+    unsigned top = 0;
+    while (top + 1 != CALENDAR_WHEELS && SlotOf(day_, top) == 0) ++top;
+    for (unsigned w = top; w != 0; --w) {
+      Slot slot;
+      slot.swap(wheels_[w][SlotOf(day_, w)]);
+      for (const Entry &entry : slot) Place(entry);
+    }
+
+    Slot &today = wheels_[0][SlotOf(day_, 0)];
+    for (const Entry &entry : today) {
+      due.push_back(entry.event);
+      digest_ -= EntryDigest(entry);
+    }
+    size_ -= today.size();
+    today.clear();
+  }
+
+  return due;
+}
+
+/*********************************************************************
+** Function: Place
+** Description: Puts an event in the slot for its day, on the wheel of
+ * the highest group of bits in which its day differs from day().
+** Parameters: entry is the event and its day.
+** Pre-Conditions: entry.due_day >= day().
+** Post-Conditions: None
+*********************************************************************/
+void EventCalendar::Place(const Entry &entry) {
+  unsigned wheel = 0;
+  for (unsigned diff = (entry.due_day ^ day_) >> CALENDAR_SLOT_BITS; diff;
+       diff >>= CALENDAR_SLOT_BITS)
+    ++wheel;
+  wheels_[wheel][SlotOf(entry.due_day, wheel)].push_back(entry);
+}
+
+/*********************************************************************
+** Function: EntryDigest
+** Description: Returns the digest of one pending event; the calendar's
+ * digest is the sum of these (mod 2^64), so that it does not depend on
+ * the order events were scheduled or placed in.
+** Parameters: entry is the event and its day.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+std::uint64_t EventCalendar::EntryDigest(const Entry &entry) {
+  const ScheduledEvent &e = entry.event;
+  std::uint64_t h = Mix64(
+      entry.due_day | static_cast<std::uint64_t>(e.type) << 32);
+  h = Mix64(h ^ SpeciesIndex(e.species));
+  return Mix64(h ^ e.count);
+}
+
+/*********************************************************************
+** Function: SlotOf
+** Description: Returns the slot a day falls in on a wheel.
+** Parameters: day is the day; wheel is the wheel.
+** Pre-Conditions: wheel < CALENDAR_WHEELS.
+** Post-Conditions: None
+*********************************************************************/
+unsigned EventCalendar::SlotOf(unsigned day, unsigned wheel) {
+  return (day >> (wheel * CALENDAR_SLOT_BITS)) & (CALENDAR_SLOTS - 1);
+}
@@ -0,0 +1,89 @@
+#ifndef ZOO_TYCOON_EVENTCALENDAR_H
+#define ZOO_TYCOON_EVENTCALENDAR_H
+/*********************************************************************
+** Program Filename: EventCalendar.h
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Declares the EventCalendar class, which holds the events
+ * scheduled for a game's future days, and its related members.
+** Input: None
+** Output: None
+*********************************************************************/
+
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "AnimalSpecies.h"
+
+static constexpr unsigned CALENDAR_SLOT_BITS = 8;
+static constexpr unsigned CALENDAR_SLOTS = 1 << CALENDAR_SLOT_BITS;
+// Enough wheels for every unsigned day.
+static constexpr unsigned CALENDAR_WHEELS = 32 / CALENDAR_SLOT_BITS;
+
+enum class ScheduledEventType {
+  // count parents of the species give birth (see Zoo::AnimalsGiveBirth).
+  Birth
+};
+
+// Something that happens to some animals of one species on a later day.
+struct ScheduledEvent {
+  ScheduledEventType type;
+  AnimalSpecies species;
+  unsigned long count;
+};
+
+// An EventCalendar is a hierarchical timing wheel of ScheduledEvents keyed
+// by the day they are due. Wheel w has a slot per value of the w-th group
+// of CALENDAR_SLOT_BITS bits of a day; an event lies in the slot of the
+// highest group in which its day differs from the calendar's, so the
+// first wheel holds the events of the next CALENDAR_SLOTS days. Whenever
+// the calendar's day carries into a group, the matching slot of that
+// group's wheel is spread over the wheels below. Scheduling an event is
+// O(1), and each event is moved at most CALENDAR_WHEELS - 1 times before
+// it is taken, so taking a day's events costs in proportion to their
+// number, however many more are pending. The calendar also keeps a digest
+// of its pending events, as a multiset, up to date in O(1) per event.
+class EventCalendar {
+  public:
+    EventCalendar() {}
+
+    // The last day whose events have been taken.
+    unsigned day() const { return day_; }
+    std::size_t size() const { return size_; }
+    // A digest of the pending events and their days, whatever order they
+    // were scheduled in; 0 when none are pending.
+    std::uint64_t digest() const { return digest_; }
+
+    void Schedule(unsigned due_day, const ScheduledEvent &e);
+    std::vector<ScheduledEvent> TakeDue(unsigned day);
+
+    // Calls f(due_day, event) for every pending event, in no particular
+    // order.
+    template <class F>
+    void ForEachPending(F f) const {
+      for (const auto &wheel : wheels_)
+        for (const Slot &slot : wheel)
+          for (const Entry &entry : slot) f(entry.due_day, entry.event);
+    }
+
+  private:
+    struct Entry {
+      unsigned due_day;
+      ScheduledEvent event;
+    };
+    using Slot = std::vector<Entry>;
+
+    std::array<std::array<Slot, CALENDAR_SLOTS>, CALENDAR_WHEELS> wheels_;
+    unsigned day_ = 0;
+    std::size_t size_ = 0;
+    std::uint64_t digest_ = 0;
+
+    void Place(const Entry &entry);
+    static std::uint64_t EntryDigest(const Entry &entry);
+    static unsigned SlotOf(unsigned day, unsigned wheel);
+};
+
+
+#endif //ZOO_TYCOON_EVENTCALENDAR_H
@@ -0,0 +1,163 @@
+#ifndef ZOO_TYCOON_FENWICKTREE_H
+#define ZOO_TYCOON_FENWICKTREE_H
+/*********************************************************************
+** Program Filename: FenwickTree.h
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Declares the FenwickTree template class and its related
+ * members.
+** Input: None
+** Output: None
+*********************************************************************/
+
+
+#include <cstddef>
+#include "CowArray.h"
+
+// FenwickTree (a binary indexed tree) holds a growable list of
+// non-negative counts and answers prefix sums, and "which slot holds the
+// k-th unit", in O(log n). Slots are numbered from 0. The tree is a
+// CowArray, so copies of it share its memory until they change, and a
+// change then copies the O(log n) chunks along its path.
+template <class T>
+class FenwickTree {
+  public:
+    using size_type = typename CowArray<T>::size_type;
+
+    FenwickTree() {}
+
+    size_type size() const { return tree_.size(); }
+    T Total() const { return total_; }
+
+    void Add(size_type i, T delta);
+    void Clear();
+    void DropFront(size_type n);
+    size_type Find(T k) const;
+    T PrefixSum(size_type n) const;
+    void Push(T value);
+    void Reserve(size_type n) { tree_.reserve(n); }
+
+  private:
+    // tree_[i - 1] holds the sum of the slots (i - lowbit(i), i].
+    CowArray<T> tree_;
+    T total_ = T();
+};
+
+/*********************************************************************
+** Function: Add
+** Description: Adds delta to the count in slot i.
+** Parameters: i is the slot; delta is the (possibly negative, for signed
+ * T, or wrapping, for unsigned T) change.
+** Pre-Conditions: i < size().
+** Post-Conditions: None
+*********************************************************************/
+template <class T>
+void FenwickTree<T>::Add(size_type i, T delta) {
+  total_ += delta;
+  for (++i; i <= tree_.size(); i += i & (~i + 1))
+    tree_.Mutable(i - 1) += delta;
+}
+
+/*********************************************************************
+** Function: Clear
+** Description: Removes every slot, keeping the memory they used for the
+ * slots pushed next.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: size() is 0.
+*********************************************************************/
+template <class T>
+void FenwickTree<T>::Clear() {
+  tree_.clear();
+  total_ = T();
+}
+
+/*********************************************************************
+** Function: DropFront
+** Description: Removes the first n slots, renumbering the rest from 0,
+ * in O(size()) and without allocating: the tree is turned back into
+ * plain counts, shifted down and rebuilt in place.
+** Parameters: n is the number of slots to remove.
+** Pre-Conditions: n <= size().
+** Post-Conditions: size() has shrunk by n.
+*********************************************************************/
+template <class T>
+void FenwickTree<T>::DropFront(size_type n) {
+  size_type size = tree_.size();
+  for (size_type i = size; i; --i) {
+    size_type parent = i + (i & (~i + 1));
+    if (parent <= size) tree_.Mutable(parent - 1) -= tree_[i - 1];
+  }
+  for (size_type i = 0; i != n; ++i)
+    total_ -= tree_[i];
+
+  tree_.EraseFront(n);
+  size = tree_.size();
+  for (size_type i = 1; i <= size; ++i) {
+    size_type parent = i + (i & (~i + 1));
+    if (parent <= size) tree_.Mutable(parent - 1) += tree_[i - 1];
+  }
+}
+
+/*********************************************************************
+** Function: Find
+** Description: Returns the slot holding the k-th unit (counting from 0),
+ * i.e. the smallest i such that PrefixSum(i + 1) > k.
+** Parameters: k is the unit to look for.
+** Pre-Conditions: k < Total().
+** Post-Conditions: None
+*********************************************************************/
+template <class T>
+typename FenwickTree<T>::size_type FenwickTree<T>::Find(T k) const {
+  size_type step = 1;
+  while (step * 2 <= tree_.size()) step *= 2;
+
+  size_type pos = 0;
+  for (; step; step /= 2) {
+    if (pos + step <= tree_.size() && tree_[pos + step - 1] <= k) {
+      pos += step;
+      k -= tree_[pos - 1];
+    }
+  }
+
+  return pos;
+}
+
+/*********************************************************************
+** Function: PrefixSum
+** Description: Returns the sum of the first n slots.
+** Parameters: n is the number of slots to sum.
+** Pre-Conditions: n <= size().
+** Post-Conditions: None
+*********************************************************************/
+template <class T>
+T FenwickTree<T>::PrefixSum(size_type n) const {
+  T sum = T();
+  for (; n; n -= n & (~n + 1))
+    sum += tree_[n - 1];
+  return sum;
+}
+
+/*********************************************************************
+** Function: Push
+** Description: Appends a new slot holding the given count, in
+ * amortized O(1).
+** Parameters: value is the count of the new slot.
+** Pre-Conditions: None
+** Post-Conditions: size() has grown by one.
+*********************************************************************/
+template <class T>
+void FenwickTree<T>::Push(T value) {
+  size_type i = tree_.size() + 1;
+  size_type low = i & (~i + 1);
+  // The new node covers (i - low, i]: value plus the nodes that cover
+  // (i - low, i - 1], which is amortized O(1) of them.
+  T sum = value;
+  for (size_type j = i - 1; j != i - low; j -= j & (~j + 1))
+    sum += tree_[j - 1];
+  tree_.push_back(sum);
+  total_ += value;
+}
+
+
+#endif //ZOO_TYCOON_FENWICKTREE_H
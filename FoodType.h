@@ -16,5 +16,8 @@ enum class FoodType {
   Cheap
 };
 
+// The number of FoodType values, numbered from 0.
+static constexpr unsigned NUMBER_OF_FOOD_TYPES = 3;
+
 
 #endif //ZOO_TYCOON_FOODTYPE_H
@@ -7,40 +7,371 @@
 ** Input: None
 ** Output: None
 *********************************************************************/
+#include <cstring>
+#include <iomanip>
+#include <iostream>
 #include "Game.h"
+#include "Checkpoint.h"
 #include "GameTurn.h"
+#include "InputLog.h"
+#include "MetricsSink.h"
+#include "SaveFile.h"
+#include "SpecialEvent.h"
+#include "Trace.h"
+#include "TurnProfile.h"
+
+static constexpr const char *NEXT_DAY_PROMPT_MSG =
+    "\nHit enter to continue to the next day...";
+
+/*********************************************************************
+** Function: Game
+** Description: Constructor for the Game class; the game draws its
+ * special events with the weights set at the time.
+** Parameters: player is the player of the game; os is the sink all of
+ * the game's output is written to; rng_engine is the source of all of
+ * the game's randomness (seed it to make the game reproducible).
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+Game::Game(Player &&player, OutputSink &os, std::mt19937 rng_engine):
+    player_(std::move(player)), zoo_(player_.zoo()),
+    state_(DEFAULT_BASE_FOOD_COST, rng_engine), os_(os) {
+  state_.rules.event_weights = SpecialEvent::EventWeightsDigest();
+}
+
+/*********************************************************************
+** Function: Game
+** Description: Constructor for the Game class that carries on with a
+ * saved game.
+** Parameters: saved is the game loaded from a save file; os is the sink
+ * to write all of the game's output to.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+Game::Game(SavedGame &&saved, OutputSink &os):
+    player_(std::move(saved.player)), zoo_(player_.zoo()),
+    state_(saved.state), os_(os) {}
+
+/*********************************************************************
+** Function: ~Game
+** Description: Destructor for the Game class; defined here since GameTurn
+ * is incomplete in the header.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+Game::~Game() {}
+
+/*********************************************************************
+** Function: Input
+** Description: Feeds one line of player input to the game, advancing it
+ * up to the next prompt.
+** Parameters: line is the line of input, without its newline.
+** Pre-Conditions: Start has been called.
+** Post-Conditions: None
+*********************************************************************/
+void Game::Input(const std::string &line) {
+  if (over_ || !turn_) return;
+  if (input_recorder_) input_recorder_->Record(line);
+
+  if (awaiting_next_day_) NextDay();
+  else HandleTurnResult(turn_->Input(line));
+}
 
 /*********************************************************************
 ** Function: Run
-** Description: Initiates the game loop, continuing until the player is
- * bankrupt.
+** Description: Plays the game interactively, reading lines from std::cin
+ * until the player quits, goes bankrupt or input runs out. A game that
+ * has already started (say, by replaying a log) carries on from where it
+ * is, asking for the input it is waiting for again.
 ** Parameters: None
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
 void Game::Run() {
-  for (;;) {
-    GameTurnResult result = GameTurn(player_, base_food_cost_).Run();
-
-    switch (result) {
-      case GameTurnResult::Quit:
-        std::cout << "Thanks for playing!" << std::endl;
-        return;
-
-      case GameTurnResult::PlayerBankrupt:
-        std::cout << "GAME OVER: Your zoo has gone bankrupt!" << std::endl;
-        return;
-
-      default:
-        std::cout << "\nHit enter to continue to the next day...";
-        std::cin.ignore();
-        std::cout << "\n\n\n==============================\n\n\n" << std::endl;
-        SetNewBaseFoodCost();
-        break;
-    }
+  if (!turn_) Start();
+  else if (awaiting_next_day_)
+    os_ << NEXT_DAY_PROMPT_MSG << std::flush;
+  else turn_->Reprompt();
+
+  std::string line;
+  while (!IsOver() && std::getline(std::cin, line))
+    Input(line);
+}
+
+/*********************************************************************
+** Function: Digest
+** Description: Returns a digest of the game's state; see the header.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+std::uint64_t Game::Digest() const {
+  double parts[] = {player_.MoneyRemaining(), state_.base_food_cost};
+  std::uint64_t bits[2];
+  std::memcpy(bits, parts, sizeof(bits));
+
+  std::uint64_t h = Mix64(state_.day);
+  h = Mix64(h ^ bits[0]);
+  h = Mix64(h ^ bits[1]);
+  h = Mix64(h ^ zoo_.Digest());
+  h = Mix64(h ^ state_.calendar.digest());
+  return Mix64(h ^ player_.bank_account().ledger_digest());
+}
+
+/*********************************************************************
+** Function: Save
+** Description: Saves the game to a file; see WriteSaveFile.
+** Parameters: path is the file to write.
+** Pre-Conditions: None
+** Post-Conditions: Returns false if the file could not be written.
+*********************************************************************/
+bool Game::Save(const std::string &path) const {
+  return WriteSaveFile(path, player_, state_);
+}
+
+/*********************************************************************
+** Function: Start
+** Description: Starts the first turn of the game.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: The game waits for the player's first input.
+*********************************************************************/
+void Game::Start() {
+  NextTurn();
+}
+
+/*********************************************************************
+** Function: ChooseFood
+** Description: Typed input: picks the day's food.
+** Parameters: t is the type of food.
+** Pre-Conditions: Start has been called.
+** Post-Conditions: None
+*********************************************************************/
+void Game::ChooseFood(FoodType t) {
+  if (over_ || !turn_ || awaiting_next_day_) return;
+  HandleTurnResult(turn_->ChooseFood(t));
+}
+
+/*********************************************************************
+** Function: ChooseMainAction
+** Description: Typed input: picks an action from the main menu.
+** Parameters: action is the action to take.
+** Pre-Conditions: Start has been called.
+** Post-Conditions: None
+*********************************************************************/
+void Game::ChooseMainAction(PlayerMainAction action) {
+  if (over_ || !turn_ || awaiting_next_day_) return;
+  HandleTurnResult(turn_->ChooseMainAction(action));
+}
+
+/*********************************************************************
+** Function: ChooseQuantity
+** Description: Typed input: picks how many animals to buy.
+** Parameters: qty is the quantity, or None to cancel.
+** Pre-Conditions: Start has been called.
+** Post-Conditions: None
+*********************************************************************/
+void Game::ChooseQuantity(Option<unsigned> qty) {
+  if (over_ || !turn_ || awaiting_next_day_) return;
+  HandleTurnResult(turn_->ChooseQuantity(qty));
+}
+
+/*********************************************************************
+** Function: ChooseSpecies
+** Description: Typed input: picks which species to buy.
+** Parameters: s is the species, or None to cancel.
+** Pre-Conditions: Start has been called.
+** Post-Conditions: None
+*********************************************************************/
+void Game::ChooseSpecies(Option<AnimalSpecies> s) {
+  if (over_ || !turn_ || awaiting_next_day_) return;
+  HandleTurnResult(turn_->ChooseSpecies(s));
+}
+
+/*********************************************************************
+** Function: ChooseListingAction
+** Description: Typed input: picks what to do while paging through the
+ * zoo's animals.
+** Parameters: action is the action to take.
+** Pre-Conditions: Start has been called.
+** Post-Conditions: None
+*********************************************************************/
+void Game::ChooseListingAction(ZooListingAction action) {
+  if (over_ || !turn_ || awaiting_next_day_) return;
+  HandleTurnResult(turn_->ChooseListingAction(action));
+}
+
+/*********************************************************************
+** Function: ChooseListingSpecies
+** Description: Typed input: picks which species to page through.
+** Parameters: s is the species, or None for all of them.
+** Pre-Conditions: Start has been called.
+** Post-Conditions: None
+*********************************************************************/
+void Game::ChooseListingSpecies(Option<AnimalSpecies> s) {
+  if (over_ || !turn_ || awaiting_next_day_) return;
+  HandleTurnResult(turn_->ChooseListingSpecies(s));
+}
+
+/*********************************************************************
+** Function: NextDay
+** Description: Moves on to the next day once the current turn is over;
+ * a new turn begins.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void Game::NextDay() {
+  if (over_ || !awaiting_next_day_) return;
+
+  {
+    ZT_PROFILE_PHASE(Rendering);
+    os_ << "\n\n\n==============================\n\n\n\n";
+  }
+  NextTurn();
+}
+
+/*********************************************************************
+** Function: set_checkpoint
+** Description: Makes the game checkpoint itself every few days.
+** Parameters: prefix names the checkpoint files; every_days is how often
+ * to checkpoint, in days.
+** Pre-Conditions: every_days > 0
+** Post-Conditions: None
+*********************************************************************/
+void Game::set_checkpoint(const std::string &prefix, unsigned every_days) {
+  checkpointer_ = make_unique<Checkpointer>(prefix);
+  checkpoint_days_ = every_days;
+}
+
+/*********************************************************************
+** Function: set_input_recorder
+** Description: Makes the game record its input.
+** Parameters: recorder is the recorder to use.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void Game::set_input_recorder(std::unique_ptr<InputRecorder> recorder) {
+  input_recorder_ = std::move(recorder);
+}
+
+/*********************************************************************
+** Function: EndTurn
+** Description: Handles the result of a finished turn; the game ends when
+ * the player quits or is bankrupt, and otherwise the base food cost
+ * changes, the game is autosaved and checkpointed if asked to be, and
+ * the game waits for the player to continue to the next day. Either way,
+ * the day's digest is logged if asked to be.
+** Parameters: result is the result of the finished turn.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void Game::EndTurn(GameTurnResult result) {
+  ZT_PROFILE_PHASE(Saving);
+  ZT_PROFILE_COUNT(turns, 1);
+  ZT_TRACE_SCOPE("End of day", "day", state_.day);
+  // Before the next day's base food cost is drawn.
+  if (metrics_sink_) RecordMetrics();
+  switch (result) {
+    case GameTurnResult::Quit:
+      os_ << "Thanks for playing!" << std::endl;
+      over_ = true;
+      break;
+
+    case GameTurnResult::PlayerBankrupt:
+      TraceInstant("Bankrupt", "day", state_.day);
+      os_ << "GAME OVER: Your zoo has gone bankrupt!" << std::endl;
+      over_ = true;
+      break;
+
+    default:
+      // Drawn now rather than in NextDay so that a game saved between
+      // days carries on exactly as it would have.
+      SetNewBaseFoodCost();
+      if (autosave_path_.IsSome()) {
+        const std::string &path = autosave_path_.CUnwrapRef();
+        ZT_TRACE_SCOPE("Autosave");
+        if (Save(path)) os_ << "\nGame saved to " << path << '.';
+        else os_ << "\nCould not save the game to " << path << '!';
+      }
+      if (checkpointer_ && state_.day % checkpoint_days_ == 0) {
+        const std::string &prefix = checkpointer_->prefix();
+        ZT_TRACE_SCOPE("Checkpoint");
+        if (checkpointer_->Checkpoint(player_, state_))
+          os_ << "\nCheckpoint written to " << prefix << '.';
+        else
+          os_ << "\nCould not write the checkpoint to " << prefix << '!';
+      }
+
+      os_ << NEXT_DAY_PROMPT_MSG << std::flush;
+      awaiting_next_day_ = true;
+      break;
+  }
+
+  if (digest_os_) {
+    *digest_os_ << state_.day << ' ' << std::hex << std::setfill('0')
+                << std::setw(16) << Digest() << std::dec << '\n';
   }
 }
 
+/*********************************************************************
+** Function: HandleTurnResult
+** Description: Ends the turn if the last input finished it.
+** Parameters: result is what the turn returned for the last input.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void Game::HandleTurnResult(Option<GameTurnResult> result) {
+  if (result.IsSome()) EndTurn(result.Unwrap());
+}
+
+/*********************************************************************
+** Function: NextTurn
+** Description: Starts the next turn, restarting the finished one rather
+ * than allocating a new one.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void Game::NextTurn() {
+  ZT_PROFILE_PHASE(Other);
+  awaiting_next_day_ = false;
+  if (turn_)
+    turn_->Restart(state_.rules.population_events);
+  else
+    turn_.reset(new GameTurn(player_, state_, os_,
+                             state_.rules.population_events));
+  turn_->Begin();
+}
+
+/*********************************************************************
+** Function: RecordMetrics
+** Description: Appends the day that just ended to the metrics sink.
+** Parameters: None
+** Pre-Conditions: metrics_sink_ is set and the turn is over.
+** Post-Conditions: None
+*********************************************************************/
+void Game::RecordMetrics() {
+  DayMetrics m;
+  m.balance = player_.MoneyRemaining();
+  m.revenue = turn_->revenue_;
+  m.feeding_cost = turn_->feeding_cost_;
+  m.base_food_cost = state_.base_food_cost;
+  m.day = state_.day;
+  m.reserved = 0;
+  m.n_animals = zoo_.NumberOfAnimals();
+
+  SpeciesCounts counts = zoo_.AdultsAndBabiesBySpecies();
+  for (unsigned s = 0; s != NUMBER_OF_SPECIES; ++s) {
+    m.adults[s] = counts[s].first;
+    m.babies[s] = counts[s].second;
+    m.deaths[s] = turn_->deaths_[s];
+  }
+
+  metrics_sink_->Append(m);
+}
+
 /*********************************************************************
 ** Function: SetNewBaseFoodCost
 ** Description: Sets the base food cost to 75-125% of its current value.
@@ -49,9 +380,25 @@ void Game::Run() {
 ** Post-Conditions: None
 *********************************************************************/
 void Game::SetNewBaseFoodCost() {
+  state_.base_food_cost =
+      DrawBaseFoodCost(state_.base_food_cost, state_.rng_engine);
+}
+
+/*********************************************************************
+** Function: DrawBaseFoodCost
+** Description: Returns a random 75-125% of the given base food cost; the
+ * day-to-day random walk of food prices, shared with engines that play
+ * the game without a Game object (see LockstepEngine).
+** Parameters: base_food_cost is the current base food cost; rng_engine is
+ * the game's random engine.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+double Game::DrawBaseFoodCost(double base_food_cost,
+                              std::mt19937 &rng_engine) {
   std::uniform_int_distribution<unsigned> uni(
       BASE_FOOD_COST_MIN_PCT_CHANGE, BASE_FOOD_COST_MAX_PCT_CHANGE);
-  unsigned pct_change = uni(rng_engine_);
+  unsigned pct_change = uni(rng_engine);
   double dec = static_cast<double>(pct_change) / 100;
-  base_food_cost_ = base_food_cost_ * dec;
+  return base_food_cost * dec;
 }
\ No newline at end of file
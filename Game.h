@@ -11,31 +11,120 @@
 
 
 #include <map>
+#include <memory>
+#include <ostream>
+#include "OutputSink.h"
 #include "Zoo.h"
 #include "Player.h"
+#include "GameState.h"
 
 static constexpr unsigned DEFAULT_BASE_FOOD_COST = 50;
 static constexpr unsigned BASE_FOOD_COST_MIN_PCT_CHANGE = 75;
 static constexpr unsigned BASE_FOOD_COST_MAX_PCT_CHANGE = 125;
 
+class Checkpointer;
+class GameTurn;
+class InputRecorder;
+class MetricsSink;
+enum class GameTurnResult;
+struct SavedGame;
+
+// A Game is driven either by Run(), which blocks on std::cin, or by calling
+// Start() once and then Input() with each line the player types (or the
+// typed Choose*/NextDay events); all output goes to the sink given at
+// construction.
 class Game {
   public:
-    explicit Game(Player &&player):
-        player_(std::move(player)), zoo_(player_.zoo()),
-        base_food_cost_(DEFAULT_BASE_FOOD_COST) {}
-    Game(): Game(Player()) {}
+    explicit Game(
+        Player &&player,
+        OutputSink &os = TerminalOutput(),
+        std::mt19937 rng_engine = MakeRngEngine());
+    explicit Game(OutputSink &os = TerminalOutput()): Game(Player(), os) {}
+    // Carries on with a game loaded by ReadSaveFile, from the start of the
+    // day after the one it was saved at.
+    explicit Game(SavedGame &&saved, OutputSink &os = TerminalOutput());
+    ~Game();
+
+    const Player &player() const { return player_; }
+    const GameState &state() const { return state_; }
+    bool IsOver() const { return over_; }
+    // Whether the day is over and the game is waiting for the player to
+    // continue to the next one.
+    bool awaiting_next_day() const { return awaiting_next_day_; }
+
+    // A digest of the day, balance, base food cost, zoo, ledger and
+    // scheduled events, in O(1); two games that agree on it are, barring
+    // collisions, in the same state.
+    std::uint64_t Digest() const;
 
+    bool Save(const std::string &path) const;
+    // Saves the game to path at the end of every day.
+    void set_autosave_path(const std::string &path) { autosave_path_ = path; }
+    // Checkpoints the game (see Checkpointer) at the end of every
+    // every_days-th day.
+    void set_checkpoint(const std::string &prefix, unsigned every_days);
+    // Writes the day and the game's Digest() to os, as "<day> <digest in
+    // hex>", at the end of every day.
+    void set_digest_log(std::ostream *os) { digest_os_ = os; }
+    // Appends the day's DayMetrics to sink at the end of every day.
+    void set_metrics_sink(MetricsSink *sink) { metrics_sink_ = sink; }
+    // Makes the game headless, as ZooBatchEnv's are: played by a program
+    // that reads nothing but its balance and animals, it keeps no ledger,
+    // so that a day formats no transaction descriptions and logs no
+    // transactions. Its Digest() then covers an empty ledger.
+    void set_headless(bool on) { player_.set_keeps_ledger(!on); }
+    // Makes every animal fall sick and conceive on its own (see
+    // PopulationEvents), giving birth once its gestation is over, from the
+    // next turn on, instead of special events befalling one animal a day;
+    // the setting is one of the game's rules (see GameRules).
+    void set_population_events(bool on) {
+      state_.rules.population_events = on;
+    }
+    // Records every line passed to Input() (see InputRecorder).
+    void set_input_recorder(std::unique_ptr<InputRecorder> recorder);
+
+    void Input(const std::string &line);
     void Run();
+    void Start();
 
-  private:
-    std::mt19937 rng_engine_ = MakeRngEngine();
+    void ChooseFood(FoodType t);
+    void ChooseMainAction(PlayerMainAction action);
+    void ChooseQuantity(Option<unsigned> qty);
+    void ChooseSpecies(Option<AnimalSpecies> s);
+    void ChooseListingAction(ZooListingAction action);
+    void ChooseListingSpecies(Option<AnimalSpecies> s);
+    void NextDay();
 
+    static double DrawBaseFoodCost(double base_food_cost,
+                                   std::mt19937 &rng_engine);
+
+  private:
     Player player_;
 
     Zoo &zoo_;
 
-    double base_food_cost_;
+    GameState state_;
+
+    OutputSink &os_;
+
+    // The turn currently being played; restarted every day.
+    std::unique_ptr<GameTurn> turn_;
+    // Whether the last turn is over and the game is waiting for the player
+    // to continue to the next day.
+    bool awaiting_next_day_ = false;
+    bool over_ = false;
+
+    Option<std::string> autosave_path_;
+    std::unique_ptr<Checkpointer> checkpointer_;
+    unsigned checkpoint_days_ = 0;
+    std::unique_ptr<InputRecorder> input_recorder_;
+    std::ostream *digest_os_ = nullptr;
+    MetricsSink *metrics_sink_ = nullptr;
 
+    void EndTurn(GameTurnResult result);
+    void HandleTurnResult(Option<GameTurnResult> result);
+    void NextTurn();
+    void RecordMetrics();
     void SetNewBaseFoodCost();
 };
 
@@ -0,0 +1,190 @@
+/*********************************************************************
+** Program Filename: GameServer.cpp
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Implements functions declared by the GameServer class.
+** Input: None
+** Output: None
+*********************************************************************/
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "GameServer.h"
+
+/*********************************************************************
+** Function: GameServer
+** Description: Constructor for the GameServer class.
+** Parameters: socket_path is the filesystem path of the socket to listen
+ * on; n_threads is the number of worker threads (at least one).
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+GameServer::GameServer(const std::string &socket_path, unsigned n_threads):
+    socket_path_(socket_path) {
+  if (n_threads == 0) n_threads = 1;
+  for (unsigned i = 0; i != n_threads; ++i)
+    workers_.push_back(make_unique<ServerWorker>());
+}
+
+/*********************************************************************
+** Function: ~GameServer
+** Description: Destructor for the GameServer class; stops the workers
+ * and removes the socket file.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+GameServer::~GameServer() {
+  Stop();
+  for (auto &t : threads_) t.join();
+
+  if (listen_fd_ != -1) {
+    close(listen_fd_);
+    unlink(socket_path_.c_str());
+  }
+  if (spare_fd_ != -1) close(spare_fd_);
+}
+
+/*********************************************************************
+** Function: NumberOfSessions
+** Description: Returns the number of sessions currently being served.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+std::size_t GameServer::NumberOfSessions() const {
+  std::size_t n = 0;
+  for (const auto &w : workers_) n += w->NumberOfSessions();
+  return n;
+}
+
+/*********************************************************************
+** Function: Listen
+** Description: Binds the listening socket (replacing a stale socket file
+ * at the same path) and starts the worker threads.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: Returns false, with errno set, on failure.
+*********************************************************************/
+bool GameServer::Listen() {
+  sockaddr_un addr = {};
+  addr.sun_family = AF_UNIX;
+  if (socket_path_.size() >= sizeof(addr.sun_path)) {
+    errno = ENAMETOOLONG;
+    return false;
+  }
+  std::strcpy(addr.sun_path, socket_path_.c_str());
+
+  listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (listen_fd_ == -1) return false;
+  spare_fd_ = open("/dev/null", O_RDONLY | O_CLOEXEC);
+  if (spare_fd_ == -1) return false;
+
+  unlink(socket_path_.c_str());
+  if (bind(listen_fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0
+      || listen(listen_fd_, SOMAXCONN) != 0)
+    return false;
+
+  for (const auto &w : workers_)
+    if (!w->Init()) return false;
+
+  running_.store(true);
+  for (const auto &w : workers_) {
+    ServerWorker *worker = w.get();
+    threads_.push_back(
+        std::thread([this, worker]() { worker->Run(running_); }));
+  }
+
+  return true;
+}
+
+/*********************************************************************
+** Function: Run
+** Description: Accepts connections until Stop is called, handing each one
+ * to the next worker in turn.
+** Parameters: None
+** Pre-Conditions: Listen has succeeded.
+** Post-Conditions: None
+*********************************************************************/
+void GameServer::Run() {
+  std::vector<std::unique_ptr<ServerWorker>>::size_type next = 0;
+
+  while (running_.load()) {
+    pollfd pfd = {};
+    pfd.fd = listen_fd_;
+    pfd.events = POLLIN;
+    if (poll(&pfd, 1, SERVER_POLL_TIMEOUT_MS) <= 0) continue;
+
+    while (AcceptOne(next)) {}
+  }
+}
+
+/*********************************************************************
+** Function: AcceptOne
+** Description: Accepts a waiting connection and hands it to the next
+ * worker. If the process is out of file descriptors, the connection is
+ * closed instead (see RejectOne); on any other error, other than an
+ * interrupted call or a connection aborted while waiting, the server
+ * waits a little before trying again, so that it does not spin.
+** Parameters: next is the index of the worker to hand the connection
+ * to; it moves on to the worker after it.
+** Pre-Conditions: Listen has succeeded.
+** Post-Conditions: Returns false once there are no more connections to
+ * accept for now.
+*********************************************************************/
+bool GameServer::AcceptOne(
+    std::vector<std::unique_ptr<ServerWorker>>::size_type &next) {
+  int fd = accept4(listen_fd_, nullptr, nullptr,
+                   SOCK_NONBLOCK | SOCK_CLOEXEC);
+  if (fd != -1) {
+    workers_[next]->AddConnection(fd);
+    next = (next + 1) % workers_.size();
+    return true;
+  }
+
+  switch (errno) {
+    case EINTR:
+    case ECONNABORTED:
+      return true;
+    case EAGAIN:
+#if EWOULDBLOCK != EAGAIN
+    case EWOULDBLOCK:
+#endif
+      return false;
+    case EMFILE:
+    case ENFILE:
+      if (spare_fd_ == -1) spare_fd_ = open("/dev/null", O_RDONLY | O_CLOEXEC);
+      if (spare_fd_ != -1) {
+        RejectOne();
+        return true;
+      }
+      break;
+    default:
+      break;
+  }
+
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(SERVER_POLL_TIMEOUT_MS));
+  return false;
+}
+
+/*********************************************************************
+** Function: RejectOne
+** Description: Frees the spare file descriptor to accept a waiting
+ * connection and close it straight away, then takes the spare back.
+** Parameters: None
+** Pre-Conditions: The spare file descriptor is open.
+** Post-Conditions: If the spare cannot be taken back, it stays closed
+ * until AcceptOne next runs out of file descriptors and retries it.
+*********************************************************************/
+void GameServer::RejectOne() {
+  close(spare_fd_);
+  int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+  if (fd != -1) close(fd);
+  spare_fd_ = open("/dev/null", O_RDONLY | O_CLOEXEC);
+}
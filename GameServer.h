@@ -0,0 +1,61 @@
+#ifndef ZOO_TYCOON_GAMESERVER_H
+#define ZOO_TYCOON_GAMESERVER_H
+/*********************************************************************
+** Program Filename: GameServer.h
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Declares the GameServer class, which serves one Game per
+ * connection over a Unix domain socket.
+** Input: None
+** Output: None
+*********************************************************************/
+
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ServerWorker.h"
+
+static constexpr const char *DEFAULT_SERVER_SOCKET_PATH =
+    "/tmp/zoo_tycoon.sock";
+static constexpr unsigned DEFAULT_SERVER_THREADS = 4;
+
+// The thread calling Run() accepts connections and deals them out
+// round-robin to a fixed pool of ServerWorker threads. A spare file
+// descriptor is kept open so that, when the process runs out of them, the
+// server can still accept the waiting connections and close them, rather
+// than leave them queued and spin on a listening socket that stays
+// readable.
+class GameServer {
+  public:
+    GameServer(const std::string &socket_path, unsigned n_threads);
+    GameServer(const GameServer &) = delete;
+    GameServer &operator=(const GameServer &) = delete;
+    ~GameServer();
+
+    std::size_t NumberOfSessions() const;
+
+    bool Listen();
+    void Run();
+    // Safe to call from a signal handler.
+    void Stop() { running_.store(false); }
+
+  private:
+    std::string socket_path_;
+    int listen_fd_ = -1;
+    int spare_fd_ = -1;
+
+    std::atomic<bool> running_{false};
+
+    std::vector<std::unique_ptr<ServerWorker>> workers_;
+    std::vector<std::thread> threads_;
+
+    bool AcceptOne(std::vector<std::unique_ptr<ServerWorker>>::size_type
+                       &next);
+    void RejectOne();
+};
+
+
+#endif //ZOO_TYCOON_GAMESERVER_H
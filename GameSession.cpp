@@ -0,0 +1,153 @@
+/*********************************************************************
+** Program Filename: GameSession.cpp
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Implements functions declared by the GameSession class.
+** Input: Lines of player input read from the client socket.
+** Output: The game's output, written to the client socket.
+*********************************************************************/
+#include <cerrno>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "GameSession.h"
+
+/*********************************************************************
+** Function: GameSession
+** Description: Constructor for the GameSession class.
+** Parameters: fd is the connected, non-blocking client socket; the
+ * session takes ownership of it.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+GameSession::GameSession(int fd): fd_(fd), game_(os_) {}
+
+/*********************************************************************
+** Function: ~GameSession
+** Description: Destructor for the GameSession class; closes the socket.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+GameSession::~GameSession() {
+  close(fd_);
+}
+
+/*********************************************************************
+** Function: WantsRead
+** Description: Returns whether the session is ready to take more input,
+ * i.e. the game is still going and the client is keeping up with output.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+bool GameSession::WantsRead() const {
+  return !game_.IsOver() &&
+         out_buf_.size() - out_pos_ < MAX_SESSION_OUTPUT_BACKLOG;
+}
+
+/*********************************************************************
+** Function: OnReadable
+** Description: Reads what the client sent and feeds every complete line
+ * to the game.
+** Parameters: None
+** Pre-Conditions: The socket is readable.
+** Post-Conditions: Returns false if the session should be closed.
+*********************************************************************/
+bool GameSession::OnReadable() {
+  char buf[SESSION_READ_CHUNK];
+  ssize_t n = recv(fd_, buf, sizeof(buf), 0);
+
+  if (n == 0) return false;
+  if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+
+  in_buf_.append(buf, static_cast<std::string::size_type>(n));
+  return ProcessLines();
+}
+
+/*********************************************************************
+** Function: OnWritable
+** Description: Writes as much pending output as the socket accepts,
+ * then resumes any input that was held back by a full backlog.
+** Parameters: None
+** Pre-Conditions: The socket is writable.
+** Post-Conditions: Returns false if the session should be closed.
+*********************************************************************/
+bool GameSession::OnWritable() {
+  while (WantsWrite()) {
+    ssize_t n = send(fd_, out_buf_.data() + out_pos_,
+                     out_buf_.size() - out_pos_, MSG_NOSIGNAL);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+      return false;
+    }
+    out_pos_ += static_cast<std::string::size_type>(n);
+  }
+
+  if (!WantsWrite()) {
+    out_buf_.clear();
+    out_pos_ = 0;
+  } else if (out_pos_ > out_buf_.size() / 2) {
+    out_buf_.erase(0, out_pos_);
+    out_pos_ = 0;
+  }
+
+  return ProcessLines() && !Done();
+}
+
+/*********************************************************************
+** Function: Start
+** Description: Greets the client and starts the game.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: The game's first prompt is waiting to be written.
+*********************************************************************/
+void GameSession::Start() {
+  os_ << "Welcome to Zoo Tycoon!\n";
+  game_.Start();
+  CollectOutput();
+}
+
+/*********************************************************************
+** Function: CollectOutput
+** Description: Moves everything the game has written into the output
+ * buffer.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: text_ is empty.
+*********************************************************************/
+void GameSession::CollectOutput() {
+  out_buf_ += text_.str();
+  text_.str(std::string());
+}
+
+/*********************************************************************
+** Function: ProcessLines
+** Description: Feeds buffered complete lines to the game, one at a time,
+ * until none are left or the output backlog is full.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: Returns false if the client sent an overlong line.
+ * Lines held back by a full backlog stay buffered; that is bounded by
+ * one read chunk since no more is read until the backlog drains.
+*********************************************************************/
+bool GameSession::ProcessLines() {
+  std::string::size_type start = 0;
+  std::string::size_type end;
+
+  while (WantsRead() &&
+         (end = in_buf_.find('\n', start)) != std::string::npos) {
+    std::string line = in_buf_.substr(start, end - start);
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    start = end + 1;
+
+    game_.Input(line);
+    CollectOutput();
+  }
+
+  in_buf_.erase(0, start);
+  if (game_.IsOver()) in_buf_.clear();
+
+  return in_buf_.size() <= MAX_SESSION_LINE_LENGTH ||
+         in_buf_.find('\n') != std::string::npos;
+}
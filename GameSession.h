@@ -0,0 +1,67 @@
+#ifndef ZOO_TYCOON_GAMESESSION_H
+#define ZOO_TYCOON_GAMESESSION_H
+/*********************************************************************
+** Program Filename: GameSession.h
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Declares the GameSession class, which connects one Game
+ * to one client socket of the game server.
+** Input: Lines of player input read from the client socket.
+** Output: The game's output, written to the client socket.
+*********************************************************************/
+
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include "Game.h"
+
+// Longest line of input a client may send; clients that send longer lines
+// are disconnected.
+static constexpr std::size_t MAX_SESSION_LINE_LENGTH = 256;
+// Once this much output is waiting to be sent, the session stops handling
+// input until the client has read some of it.
+static constexpr std::size_t MAX_SESSION_OUTPUT_BACKLOG = 1 << 16;
+// Amount read from the socket in one go.
+static constexpr std::size_t SESSION_READ_CHUNK = 4096;
+
+// A GameSession never blocks: the socket must be non-blocking, and the
+// owner calls OnReadable()/OnWritable() when the socket is ready. A session
+// is only ever touched by the thread that owns it.
+class GameSession {
+  public:
+    explicit GameSession(int fd);
+    GameSession(const GameSession &) = delete;
+    GameSession &operator=(const GameSession &) = delete;
+    ~GameSession();
+
+    int fd() const { return fd_; }
+    bool WantsRead() const;
+    bool WantsWrite() const { return out_pos_ != out_buf_.size(); }
+
+    bool OnReadable();
+    bool OnWritable();
+    void Start();
+
+  private:
+    int fd_;
+
+    // The game writes to os_, which keeps the text in text_ until
+    // CollectOutput moves it to out_buf_.
+    std::stringbuf text_;
+    OutputSink os_{&text_};
+    Game game_;
+
+    // Received bytes that do not form a complete line yet.
+    std::string in_buf_;
+    // Output not yet written to the socket, starting at out_pos_.
+    std::string out_buf_;
+    std::string::size_type out_pos_ = 0;
+
+    void CollectOutput();
+    bool Done() const { return game_.IsOver() && !WantsWrite(); }
+    bool ProcessLines();
+};
+
+
+#endif //ZOO_TYCOON_GAMESESSION_H
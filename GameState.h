@@ -0,0 +1,63 @@
+#ifndef ZOO_TYCOON_GAMESTATE_H
+#define ZOO_TYCOON_GAMESTATE_H
+/*********************************************************************
+** Program Filename: GameState.h
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Declares the GameState struct, which holds the mutable
+ * state belonging to a single game.
+** Input: None
+** Output: None
+*********************************************************************/
+
+
+#include <cstdint>
+#include <random>
+#include "EventCalendar.h"
+#include "FoodType.h"
+
+// The options a game was started with that change how it plays out. A
+// game saved, checkpointed or recorded with some rules can only be
+// carried on with the same ones, so they are kept with it.
+struct GameRules {
+  // Whether sicknesses and births are PopulationEvents rather than
+  // special events.
+  bool population_events;
+  // SpecialEvent::EventWeightsDigest() of the weights special events are
+  // drawn with.
+  std::uint64_t event_weights;
+
+  bool operator==(const GameRules &other) const {
+    return population_events == other.population_events &&
+           event_weights == other.event_weights;
+  }
+  bool operator!=(const GameRules &other) const { return !(*this == other); }
+};
+
+// Everything that changes from day to day in one game (apart from the
+// player's zoo and bank account) lives here. Each Game owns exactly one
+// GameState and hands it to every GameTurn, so separate games never share
+// anything and can run side by side, even on different threads.
+struct GameState {
+  GameState(double base_food_cost, std::mt19937 rng_engine):
+      day(0), food_type(FoodType::Regular), base_food_cost(base_food_cost),
+      rng_engine(rng_engine), rules() {}
+
+  // The current day of the game.
+  unsigned day;
+  // The type of food to feed the animals this turn.
+  FoodType food_type;
+  // The base cost of animal food for the current day.
+  double base_food_cost;
+  // Every random choice in the game draws from this engine, so two games
+  // seeded alike and given the same input play out exactly the same.
+  std::mt19937 rng_engine;
+  // The events scheduled for later days, such as the births of animals
+  // that conceived with --population-events.
+  EventCalendar calendar;
+  // These never change once the game has started.
+  GameRules rules;
+};
+
+
+#endif //ZOO_TYCOON_GAMESTATE_H
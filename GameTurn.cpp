@@ -7,75 +7,360 @@
 ** Input: None
 ** Output: None
 *********************************************************************/
-#include <iostream>
+#include <array>
 #include "GameTurn.h"
 #include "MenuPrompt.h"
-
-unsigned GameTurn::day_ = 0;
-FoodType GameTurn::food_type_ = FoodType::Regular;
+#include "Trace.h"
+#include "TurnProfile.h"
 
 /*********************************************************************
 ** Function: GameTurn
 ** Description: Constructor for the GameTurn class.
-** Parameters: player is the player of the current game; base_food_cost
- * is the base cost of animal food for the turn.
+** Parameters: player is the player of the current game; state is the
+ * per-game state (day, food type, base food cost) the turn reads and
+ * updates; os is the sink all of the turn's output is written to;
+ * population_events is whether sicknesses and births are PopulationEvents.
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
-GameTurn::GameTurn(Player &player, double base_food_cost):
-    player_(player), zoo_(player.zoo()),
-    special_event_(SpecialEvent(player.zoo(), food_type_)),
-    base_food_cost_(base_food_cost), monkey_bonus_revenue_(None) {
-  food_type_= PromptPlayerFoodType();
-  std::cout << "\n\n" << std::endl;
-  ++day_;
+GameTurn::GameTurn(Player &player, GameState &state, OutputSink &os,
+                   bool population_events):
+    player_(player), zoo_(player.zoo()), state_(state), os_(os),
+    population_events_(population_events), monkey_bonus_revenue_(None) {}
+
+/*********************************************************************
+** Function: Input
+** Description: Feeds one line of player input to the turn. The line is
+ * parsed against the menu of the current phase; invalid input re-prompts
+ * the player without advancing the turn.
+** Parameters: line is the line of input, without its newline.
+** Pre-Conditions: Begin has been called.
+** Post-Conditions: The turn has advanced up to its next prompt.
+*********************************************************************/
+Option<GameTurnResult> GameTurn::Input(const std::string &line) {
+  ZT_PROFILE_PHASE(Other);
+  switch (phase_) {
+    case GameTurnPhase::ChooseFood: {
+      Option<FoodType> food;
+      if (!food_prompt_.Select(line, food)) return Reprompt();
+      return ChooseFood(food.Unwrap());
+    }
+
+    case GameTurnPhase::MainMenu: {
+      Option<PlayerMainAction> action;
+      if (!main_prompt_.Select(line, action)) return Reprompt();
+      return ChooseMainAction(action.Unwrap());
+    }
+
+    case GameTurnPhase::ChooseSpecies: {
+      Option<AnimalSpecies> species;
+      if (!species_prompt_.Select(line, species)) return Reprompt();
+      return ChooseSpecies(species);
+    }
+
+    case GameTurnPhase::ChooseQuantity: {
+      Option<unsigned> qty;
+      if (!quantity_prompt_.Select(line, qty)) return Reprompt();
+      return ChooseQuantity(qty);
+    }
+
+    case GameTurnPhase::BrowseAnimals: {
+      Option<ZooListingAction> action;
+      if (!listing_prompt_.Select(line, action)) return Reprompt();
+      return ChooseListingAction(action.Unwrap());
+    }
+
+    case GameTurnPhase::ChooseListingSpecies: {
+      Option<AnimalSpecies> species;
+      if (!listing_species_prompt_.Select(line, species)) return Reprompt();
+      return ChooseListingSpecies(species);
+    }
+
+    default: return result_;
+  }
 }
 
 /*********************************************************************
-** Function: Run
-** Description: Carries out of the flow of each turn; from incrementing
- * the animals' ages to feeding them to giving the player the daily revenue,
- * this function handles the entire turn. It initiates an infinite loop
- * that prompts the player to select from a variety of menu options until
- * they either go bankrupt or choose to end the turn.
-** Parameters: None
+** Function: ChooseFood
+** Description: Handles the player's choice of food, then carries out the
+ * start of the day: deaths of old age, aging, feeding, the events
+ * scheduled for the day and the special event, stopping at the main menu.
+** Parameters: t is the type of food to feed the animals today.
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
-GameTurnResult GameTurn::Run() {
-  zoo_.IncrementAnimalAges();
+Option<GameTurnResult> GameTurn::ChooseFood(FoodType t) {
+  if (phase_ != GameTurnPhase::ChooseFood || !food_prompt_.Accepts(t))
+    return Reprompt();
+
+  SetTraceDay(state_.day + 1);
+  ZT_TRACE_SCOPE("Start of day", "day", state_.day + 1);
+  ZT_PROFILE_PHASE(Other);
+  state_.food_type = t;
+  {
+    ZT_PROFILE_PHASE(Rendering);
+    os_ << "\n\n\n";
+  }
+  ++state_.day;
+
+  {
+    // Before the special event is drawn, so that it never befalls an
+    // animal that died of old age this morning.
+    ZT_PROFILE_PHASE(Aging);
+    deaths_ = zoo_.RemoveExpiredAnimals();
+  }
+
+  {
+    ZT_PROFILE_PHASE(SpecialEvent);
+    ZT_TRACE_SCOPE("Draw special event");
+    if (special_event_)
+      special_event_->Redraw(state_.food_type);
+    else
+      special_event_ = make_unique<SpecialEvent>(
+          zoo_, state_.food_type, state_.rng_engine);
+  }
+
+  {
+    ZT_PROFILE_PHASE(Aging);
+    zoo_.IncrementAnimalAges();
+    ZT_PROFILE_COUNT(animals_processed, zoo_.NumberOfAnimals());
+  }
   PrintGameState();
+  RecordDeaths();
   FeedAnimals();
 
-  GameTurnResult handle_result = HandleSpecialEvent()
-      .UnwrapOr(GameTurnResult::Continue);
-  if (handle_result == GameTurnResult::PlayerBankrupt) return handle_result;
+  Option<GameTurnResult> event_result = HandleScheduledEvents();
+  if (event_result.IsNone())
+    event_result = population_events_ ?
+        HandlePopulationEvents() : HandleSpecialEvent();
+  GameTurnResult handle_result =
+      event_result.UnwrapOr(GameTurnResult::Continue);
+  if (handle_result == GameTurnResult::PlayerBankrupt)
+    return Finish(handle_result);
 
-  for (;;) {
-    PlayerMainAction action = PromptPlayerMainMenu();
+  PromptPlayerMainMenu();
+  return None;
+}
 
-    if (action == PlayerMainAction::EndTurn) break;
-    else if (action == PlayerMainAction::QuitGame) return GameTurnResult::Quit;
-    else {
-      GameTurnResult result = HandleMainAction(action)
-          .UnwrapOr(GameTurnResult::Continue);
+/*********************************************************************
+** Function: ChooseMainAction
+** Description: Handles a selection from the main action menu.
+** Parameters: action is the action the player would like to take.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+Option<GameTurnResult> GameTurn::ChooseMainAction(PlayerMainAction action) {
+  if (phase_ != GameTurnPhase::MainMenu || !main_prompt_.Accepts(action))
+    return Reprompt();
 
-      switch (result) {
-        case GameTurnResult::InsufficientFunds:
-          std::cout << "\nUnable to make purchase due to insufficient funds.\n";
-          break;
+  ZT_PROFILE_PHASE(Action);
+  ZT_TRACE_SCOPE("Main action", "action", static_cast<int>(action));
+  switch (action) {
+    case PlayerMainAction::EndTurn:
+      GivePlayerRevenue();
+      return Finish(GameTurnResult::Continue);
+
+    case PlayerMainAction::QuitGame:
+      return Finish(GameTurnResult::Quit);
 
-        case GameTurnResult::PlayerBankrupt:
-          return result;
+    case PlayerMainAction::BuyAnimal:
+      PromptPlayerBuyAnimal();
+      return None;
 
-        default: break;
+    case PlayerMainAction::ViewZooAnimals:
+      if (zoo_.NumberOfAnimals() > ZOO_LISTING_PAGE_SIZE) {
+        if (os_.enabled()) {
+          os_ << '\n';
+          zoo_.PrintSummary(os_);
+          os_ << '\n';
+        }
+        BrowseAnimals(None);
+      } else {
+        HandleMainAction(action);
+        PromptPlayerMainMenu();
       }
+      return None;
+
+    default:
+      HandleMainAction(action);
+      PromptPlayerMainMenu();
+      return None;
+  }
+}
+
+/*********************************************************************
+** Function: ChooseQuantity
+** Description: Handles the number of animals the player wants to buy of
+ * the species they chose, then returns to the main menu.
+** Parameters: qty is the number of animals to buy, or None to cancel.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+Option<GameTurnResult> GameTurn::ChooseQuantity(Option<unsigned> qty) {
+  if (phase_ != GameTurnPhase::ChooseQuantity ||
+      !quantity_prompt_.Accepts(qty))
+    return Reprompt();
+
+  ZT_PROFILE_PHASE(Action);
+  ZT_TRACE_SCOPE("Buy animals", "quantity",
+                 qty.IsSome() ? qty.CUnwrapRef() : 0);
+  if (qty.IsSome()) {
+    GameTurnResult result = PlayerBuyAnimal(species_choice_, qty.Unwrap())
+        .UnwrapOr(GameTurnResult::Continue);
+
+    switch (result) {
+      case GameTurnResult::InsufficientFunds:
+        os_ << "\nUnable to make purchase due to insufficient funds.\n";
+        break;
+
+      case GameTurnResult::PlayerBankrupt:
+        return Finish(result);
+
+      default: break;
     }
   }
 
-  GivePlayerRevenue();
+  PromptPlayerMainMenu();
+  return None;
+}
+
+/*********************************************************************
+** Function: ChooseSpecies
+** Description: Handles the species the player wants to buy, moving on to
+ * ask how many they want.
+** Parameters: s is the chosen species, or None to cancel.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+Option<GameTurnResult> GameTurn::ChooseSpecies(Option<AnimalSpecies> s) {
+  if (phase_ != GameTurnPhase::ChooseSpecies || !species_prompt_.Accepts(s))
+    return Reprompt();
+
+  ZT_PROFILE_PHASE(Action);
+  if (s.IsNone() || !CanBuyAnimal()) PromptPlayerMainMenu();
+  else PromptPlayerQuantity(s.Unwrap());
+
+  return None;
+}
+
+/*********************************************************************
+** Function: ChooseListingAction
+** Description: Handles a selection from the menu shown while paging
+ * through the zoo's animals.
+** Parameters: action is the action the player would like to take.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+Option<GameTurnResult>
+GameTurn::ChooseListingAction(ZooListingAction action) {
+  if (phase_ != GameTurnPhase::BrowseAnimals ||
+      !listing_prompt_.Accepts(action))
+    return Reprompt();
+
+  ZT_PROFILE_PHASE(Rendering);
+  switch (action) {
+    case ZooListingAction::NextPage:
+      ++listing_page_;
+      break;
+
+    case ZooListingAction::PreviousPage:
+      --listing_page_;
+      break;
+
+    case ZooListingAction::FilterBySpecies:
+      PromptPlayerListingSpecies();
+      return None;
+
+    case ZooListingAction::Back:
+      PromptPlayerMainMenu();
+      return None;
+  }
+
+  PrintListingPage();
+  PromptPlayerListing();
+  return None;
+}
 
-  return GameTurnResult::Continue;
+/*********************************************************************
+** Function: ChooseListingSpecies
+** Description: Handles the species the player wants to list, going back
+ * to the first page.
+** Parameters: s is the species, or None to list them all.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+Option<GameTurnResult>
+GameTurn::ChooseListingSpecies(Option<AnimalSpecies> s) {
+  if (phase_ != GameTurnPhase::ChooseListingSpecies ||
+      !listing_species_prompt_.Accepts(s))
+    return Reprompt();
+
+  ZT_PROFILE_PHASE(Rendering);
+  BrowseAnimals(std::move(s));
+  return None;
+}
+
+/*********************************************************************
+** Function: Begin
+** Description: Starts the turn by asking the player for the day's food.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void GameTurn::Begin() {
+  PromptPlayerFoodType();
+}
+
+/*********************************************************************
+** Function: Finish
+** Description: Ends the turn with the given result.
+** Parameters: result is the outcome of the turn.
+** Pre-Conditions: None
+** Post-Conditions: Further input is ignored.
+*********************************************************************/
+Option<GameTurnResult> GameTurn::Finish(GameTurnResult result) {
+  phase_ = GameTurnPhase::Finished;
+  result_ = result;
+  return result_;
+}
+
+/*********************************************************************
+** Function: Restart
+** Description: Readies a finished turn to play the next day, as a new
+ * GameTurn for the same player and state would be.
+** Parameters: population_events is whether sicknesses and births are
+ * PopulationEvents.
+** Pre-Conditions: None
+** Post-Conditions: Begin may be called.
+*********************************************************************/
+void GameTurn::Restart(bool population_events) {
+  animals_bought_ = None;
+  phase_ = GameTurnPhase::ChooseFood;
+  result_ = None;
+  species_choice_ = AnimalSpecies::Monkey;
+  listing_filter_ = ZooListingFilter();
+  listing_page_ = 0;
+  listing_size_ = 0;
+  population_events_ = population_events;
+  monkey_bonus_revenue_ = None;
+  revenue_ = 0.0;
+  feeding_cost_ = 0.0;
+  deaths_ = SpeciesDeaths{};
+}
+
+/*********************************************************************
+** Function: Reprompt
+** Description: Asks the player to enter an option again after invalid
+ * input.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+Option<GameTurnResult> GameTurn::Reprompt() const {
+  if (phase_ == GameTurnPhase::Finished) return result_;
+  ZT_PROFILE_PHASE(Rendering);
+  os_ << MENU_PROMPT_INPUT_MSG << std::flush;
+  return None;
 }
 
 /*********************************************************************
@@ -87,20 +372,67 @@ GameTurnResult GameTurn::Run() {
 ** Post-Conditions: None
 *********************************************************************/
 void GameTurn::PrintGameState() const {
-  using Map = std::unordered_map<std::string, std::pair<unsigned, unsigned>>;
-
-  std::cout << "Day " << day_ << " -- CURRENT STATE OF THE GAME: " << '\n'
-            << "\tBank Account Balance: " << player_.MoneyRemaining() << '\n'
-            << "\t# of Adult Animals: " << zoo_.NumberOfAdultAnimals() << '\n'
-            << "\t# of Baby Animals: " << zoo_.NumberOfBabyAnimals() << '\n'
-            << "\t# of Adults/Babies of Each Species:\n";
+  if (!os_.enabled()) return;
+  ZT_PROFILE_PHASE(Rendering);
+  ZT_TRACE_SCOPE("Print game state");
+  using Map = std::unordered_map<std::string,
+                                 std::pair<unsigned long, unsigned long>>;
+
+  os_ << "Day " << state_.day << " -- CURRENT STATE OF THE GAME: " << '\n'
+      << "\tBank Account Balance: " << player_.MoneyRemaining() << '\n'
+      << "\t# of Adult Animals: " << zoo_.NumberOfAdultAnimals() << '\n'
+      << "\t# of Baby Animals: " << zoo_.NumberOfBabyAnimals() << '\n'
+      << "\t# of Adults/Babies of Each Species:\n";
 
   Map counts = zoo_.AdultsAndBabiesForEachSpecies();
   for (const auto &c : counts)
-    std::cout << "\t\t" << c.first << ": " << c.second.first << " adults and "
-              << c.second.second << " babies." << '\n';
+    os_ << "\t\t" << c.first << ": " << c.second.first << " adults and "
+        << c.second.second << " babies." << '\n';
+
+  os_ << "\n\n";
+}
+
+/*********************************************************************
+** Function: BrowseAnimals
+** Description: Starts paging through the zoo's animals, from the first
+ * page.
+** Parameters: s is the species to list, or None to list them all.
+** Pre-Conditions: None
+** Post-Conditions: The turn waits in the BrowseAnimals phase.
+*********************************************************************/
+void GameTurn::BrowseAnimals(Option<AnimalSpecies> s) {
+  listing_filter_ = ZooListingFilter();
+  listing_filter_.species = std::move(s);
+  listing_page_ = 0;
+  listing_size_ = zoo_.CountAnimals(listing_filter_);
+
+  PrintListingPage();
+  PromptPlayerListing();
+}
 
-  std::cout << '\n' << std::endl;
+/*********************************************************************
+** Function: PrintListingPage
+** Description: Prints the page of the zoo's animals being browsed.
+** Parameters: None
+** Pre-Conditions: The listing's filter, page and size are set.
+** Post-Conditions: None
+*********************************************************************/
+void GameTurn::PrintListingPage() const {
+  if (!os_.enabled()) return;
+
+  AnimalsVec::size_type n_pages = std::max<AnimalsVec::size_type>(
+      (listing_size_ + ZOO_LISTING_PAGE_SIZE - 1) / ZOO_LISTING_PAGE_SIZE, 1);
+  os_ << "\nAnimals in your zoo";
+  if (listing_filter_.species.IsSome())
+    os_ << " (" << AnimalSpeciesToString(listing_filter_.species.CUnwrapRef())
+        << "s only)";
+  os_ << ", page " << listing_page_ + 1 << " of " << n_pages << ":\n";
+
+  if (listing_size_ == 0) os_ << "\tNone.";
+  zoo_.PrintAnimals(os_, listing_filter_,
+                    listing_page_ * ZOO_LISTING_PAGE_SIZE,
+                    ZOO_LISTING_PAGE_SIZE);
+  os_ << '\n';
 }
 
 /*********************************************************************
@@ -112,22 +444,25 @@ void GameTurn::PrintGameState() const {
 ** Post-Conditions: None
 *********************************************************************/
 Option<GameTurnResult> GameTurn::AnimalBirth(CAnimalRef parent) {
-  std::cout << "An adult " << parent.get().name() << " gave birth to "
-            << parent.get().babies_per_birth() << " babies!\n";
+  TraceInstant("Birth", "babies", parent.get().babies_per_birth());
+  os_ << "An adult " << parent.get().name() << " gave birth to "
+      << parent.get().babies_per_birth() << " babies!\n";
 
   std::vector<CAnimalRef> babies = zoo_.AnimalGiveBirth(parent);
   for (const auto &b : babies) {
-    if (!player_.FeedAnimal(b, food_type_, base_food_cost_)) {
-      std::cout << "You don't have enough money to feed your newborn "
-                << b.get().name() << "!\n";
+    if (!player_.FeedAnimal(b, state_.food_type, state_.base_food_cost)) {
+      os_ << "You don't have enough money to feed your newborn "
+          << b.get().name() << "!\n";
 
       return GameTurnResult::PlayerBankrupt;
     }
+    feeding_cost_ += b.get().FoodCost(state_.food_type, state_.base_food_cost);
   }
 
-  double feeding_cost = parent.get().FoodCost(food_type_, base_food_cost_);
-  std::cout << "Successfully fed " << parent.get().babies_per_birth()
-            << " newborns; paid $" << feeding_cost << ".\n";
+  double feeding_cost =
+      parent.get().FoodCost(state_.food_type, state_.base_food_cost);
+  os_ << "Successfully fed " << parent.get().babies_per_birth()
+      << " newborns; paid $" << feeding_cost << ".\n";
 
   return None;
 }
@@ -141,13 +476,18 @@ Option<GameTurnResult> GameTurn::AnimalBirth(CAnimalRef parent) {
 ** Post-Conditions: None
 *********************************************************************/
 Option<GameTurnResult> GameTurn::FeedAnimals() {
-  if (!player_.FeedAnimals(food_type_, base_food_cost_))
+  ZT_PROFILE_PHASE(Feeding);
+  ZT_PROFILE_COUNT(animals_processed, zoo_.NumberOfAnimals());
+  ZT_TRACE_SCOPE("Feed animals");
+  if (!player_.FeedAnimals(state_.food_type, state_.base_food_cost))
     return GameTurnResult::PlayerBankrupt;
 
-  double feeding_cost = zoo_.FeedingCost(food_type_, base_food_cost_);
+  double feeding_cost =
+      zoo_.FeedingCost(state_.food_type, state_.base_food_cost);
+  feeding_cost_ += feeding_cost;
   if (feeding_cost > 0)
-    std::cout << "Successfully fed all the animals; paid $" << feeding_cost
-              << '.' << std::endl;
+    os_ << "Successfully fed all the animals; paid $" << feeding_cost
+        << ".\n";
 
   return None;
 }
@@ -161,14 +501,39 @@ Option<GameTurnResult> GameTurn::FeedAnimals() {
 ** Post-Conditions: None
 *********************************************************************/
 void GameTurn::GivePlayerRevenue() {
-  std::string n_animals = std::to_string(zoo_.NumberOfAnimals());
-  std::string desc = "Daily zoo revenue from " + n_animals + " animals";
+  ZT_PROFILE_PHASE(Revenue);
+  ZT_PROFILE_COUNT(animals_processed, zoo_.NumberOfAnimals());
+  ZT_TRACE_SCOPE("Collect revenue");
+  std::string desc;
+  if (player_.keeps_ledger())
+    desc = "Daily zoo revenue from " +
+           std::to_string(zoo_.NumberOfAnimals()) + " animals";
   double total_revenue = zoo_.TotalDailyRevenue(monkey_bonus_revenue_);
 
   player_.AddMoney(total_revenue, desc);
+  revenue_ = total_revenue;
+
+  os_ << "\nThe zoo made $" << total_revenue << " today, bringing your "
+      << "bank balance to $" << player_.MoneyRemaining() << ".\n";
+}
 
-  std::cout << "\nThe zoo made $" << total_revenue << " today, bringing your "
-            << "bank balance to $" << player_.MoneyRemaining() << ".\n";
+/*********************************************************************
+** Function: HandlePopulationEvents
+** Description: Handles the day's attendance boom, if there is one, and
+ * then its conceptions and sicknesses (see PopulationEvents).
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+Option<GameTurnResult> GameTurn::HandlePopulationEvents() {
+  if (special_event_->type() == SpecialEventType::ZooAttendanceBoom)
+    HandleSpecialEvent();
+
+  ZT_PROFILE_PHASE(SpecialEvent);
+  PopulationEvents events(zoo_, state_.food_type, state_.rng_engine);
+  Conceive(events.births());
+  PopulationSicknesses(events.sicknesses());
+  return None;
 }
 
 /*********************************************************************
@@ -180,20 +545,25 @@ void GameTurn::GivePlayerRevenue() {
 ** Post-Conditions: None
 *********************************************************************/
 Option<GameTurnResult> GameTurn::HandleSpecialEvent() {
-  switch (special_event_.type()) {
+  ZT_PROFILE_PHASE(SpecialEvent);
+  ZT_TRACE_SCOPE("Special event", "type",
+                 static_cast<int>(special_event_->type()));
+  switch (special_event_->type()) {
     case SpecialEventType::AnimalBirth:
-      return special_event_.animal_birth().AndThen<GameTurnResult>(
+      return special_event_->animal_birth().AndThen<GameTurnResult>(
           [&](CAnimalRef parent) { return AnimalBirth(parent); });
 
     case SpecialEventType::SickAnimal:
-      return special_event_.sick_animal().AndThen<GameTurnResult>(
+      return special_event_->sick_animal().AndThen<GameTurnResult>(
           [&](CAnimalRef animal) { return SickAnimal(animal); });
 
     case SpecialEventType::ZooAttendanceBoom:
-      monkey_bonus_revenue_ = special_event_.monkey_bonus_revenue();
-      std::cout << "There is a zoo attendance boom today! Each monkey will "
-                << "generate an extra $" << monkey_bonus_revenue_.CUnwrapRef()
-                << " in revenue today!\n";
+      monkey_bonus_revenue_ = special_event_->monkey_bonus_revenue();
+      TraceInstant("Attendance boom", "bonus",
+                   monkey_bonus_revenue_.CUnwrapRef());
+      os_ << "There is a zoo attendance boom today! Each monkey will "
+          << "generate an extra $" << monkey_bonus_revenue_.CUnwrapRef()
+          << " in revenue today!\n";
       return None;
 
     default: return None;
@@ -202,41 +572,35 @@ Option<GameTurnResult> GameTurn::HandleSpecialEvent() {
 
 /*********************************************************************
 ** Function: HandleMainAction
-** Description: Handles the main player menu; checks their choice and
- * carries out the appropriate actions.
+** Description: Carries out the main menu actions that only print
+ * information (buying animals and ending the turn are handled by
+ * ChooseMainAction).
 ** Parameters: action is the action the player would like to take.
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
-Option<GameTurnResult> GameTurn::HandleMainAction(PlayerMainAction action) {
+void GameTurn::HandleMainAction(PlayerMainAction action) {
+  if (!os_.enabled()) return;
+  ZT_PROFILE_PHASE(Rendering);
   switch (action) {
-    case PlayerMainAction::BuyAnimal:
-      return PromptPlayerBuyAnimal().AndThen<GameTurnResult>(
-          [&](std::pair<AnimalSpecies, unsigned> purchase) {
-              return PlayerBuyAnimal(purchase.first, purchase.second);
-          }
-      );
-
     case PlayerMainAction::ViewZooAnimals:
-      std::cout << zoo_ << std::endl;
+      os_ << zoo_ << '\n';
       break;
 
     case PlayerMainAction::CheckBank:
-      std::cout << "Your Bank Account Information: " << "\n\n";
-      player_.PrintBankAccountInformation();
-      std::cout << '\n' << std::endl;
+      os_ << "Your Bank Account Information: " << "\n\n";
+      player_.PrintBankAccountInformation(os_);
+      os_ << "\n\n";
       break;
 
     case PlayerMainAction::PrintGameState:
       PrintGameState();
-      std::cout << std::endl;
+      os_ << '\n';
       break;
 
     default:
       break;
   }
-
-  return None;
 }
 
 /*********************************************************************
@@ -252,22 +616,23 @@ GameTurn::PlayerBuyAnimal(AnimalSpecies s, unsigned qty) {
       player_.BuyAnimals(s, qty);
   if (!result.first) return GameTurnResult::InsufficientFunds;
 
-  std::cout << "\nYou purchased " << qty << ' ' << AnimalSpeciesToString(s)
-            << "s!\n";
+  os_ << "\nYou purchased " << qty << ' ' << AnimalSpeciesToString(s)
+      << "s!\n";
 
   double food_cost = 0;
   for (const auto &i : result.second.CUnwrapRef()) {
-    if (!player_.FeedAnimal(i.get(), food_type_, base_food_cost_)) {
-      std::cout << "You don't have enough money to feed your newly purchased "
-                << i.get().name() << "!\n";
+    if (!player_.FeedAnimal(i.get(), state_.food_type, state_.base_food_cost)) {
+      os_ << "You don't have enough money to feed your newly purchased "
+          << i.get().name() << "!\n";
       return GameTurnResult::PlayerBankrupt;
     }
 
-    food_cost = i.get().FoodCost(food_type_, base_food_cost_);
+    food_cost = i.get().FoodCost(state_.food_type, state_.base_food_cost);
   }
 
-  std::cout << "You paid $" << food_cost * qty << " to feed your "
-            << qty << " new " << AnimalSpeciesToString(s) << "s.\n";
+  feeding_cost_ += food_cost * qty;
+  os_ << "You paid $" << food_cost * qty << " to feed your "
+      << qty << " new " << AnimalSpeciesToString(s) << "s.\n";
 
   if (animals_bought_.IsSome())
     animals_bought_.UnwrapRef().second += qty;
@@ -278,95 +643,209 @@ GameTurn::PlayerBuyAnimal(AnimalSpecies s, unsigned qty) {
 }
 
 /*********************************************************************
-** Function: SickAnimal
-** Description: Handles a sick animal event, making sure the player can
- * afford to care for the sick animal.
-** Parameters: sick_animal is the animal that is sick.
+** Function: Conceive
+** Description: Handles the day's births by scheduling them: each
+ * species' parents give birth together once its gestation is over.
+** Parameters: births are the cohorts of adults that conceived.
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
-Option<GameTurnResult> GameTurn::SickAnimal(CAnimalRef sick_animal) {
-  std::cout << "A " << sick_animal.get().name() << " fell sick!\n";
+void GameTurn::Conceive(const std::vector<CohortEvent> &births) {
+  std::array<unsigned long, NUMBER_OF_SPECIES> parents{};
+  for (const CohortEvent &e : births)
+    parents[SpeciesIndex(e.animal.get().species())] += e.count;
+
+  for (unsigned i = 0; i != NUMBER_OF_SPECIES; ++i) {
+    unsigned long n = parents[i];
+    if (!n) continue;
+    AnimalSpecies s = static_cast<AnimalSpecies>(i);
+    std::unique_ptr<Animal> parent = CreateFromSpecies(s, ANIMAL_ADULT_AGE);
+    unsigned due_day = state_.day + parent->gestation_days();
+    state_.calendar.Schedule(due_day,
+                             ScheduledEvent{ScheduledEventType::Birth, s, n});
+
+    TraceInstant("Conceived", "parents", n);
+    os_ << n << " adult " << parent->name() << (n == 1 ? "" : "s")
+        << " conceived; their babies are due on day " << due_day << ".\n";
+  }
+}
 
-  if (!player_.CareForSickAnimal(sick_animal)) {
-    std::cout << "Since you cannot afford to pay for their medical costs, "
-              << "the " << sick_animal.get().name() << " has died.\n";
-    zoo_.RemoveAnimal(sick_animal);
-  } else {
-    std::cout << "You paid $" << sick_animal.get().SickCareCost()
-              << " in medical costs to treat the " << sick_animal.get().name()
-              << ".\n";
+/*********************************************************************
+** Function: HandleScheduledEvents
+** Description: Handles the events scheduled for today (see
+ * EventCalendar); each species' births are handled together, making
+ * sure the newborns are fed.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+Option<GameTurnResult> GameTurn::HandleScheduledEvents() {
+  std::vector<ScheduledEvent> due = state_.calendar.TakeDue(state_.day);
+  if (due.empty()) return None;
+
+  ZT_PROFILE_PHASE(SpecialEvent);
+  ZT_TRACE_SCOPE("Scheduled events", "events", due.size());
+  std::array<unsigned long, NUMBER_OF_SPECIES> parents{};
+  for (const ScheduledEvent &e : due) {
+    switch (e.type) {
+      case ScheduledEventType::Birth:
+        parents[SpeciesIndex(e.species)] += e.count;
+        break;
+    }
+  }
+
+  for (unsigned i = 0; i != NUMBER_OF_SPECIES; ++i) {
+    unsigned long n_parents = parents[i];
+    if (!n_parents) continue;
+    AnimalSpecies s = static_cast<AnimalSpecies>(i);
+    std::unique_ptr<Animal> parent = CreateFromSpecies(s, ANIMAL_ADULT_AGE);
+    Option<CAnimalRef> baby = zoo_.AnimalsGiveBirth(*parent, n_parents);
+    if (baby.IsNone()) continue;
+
+    const Animal &b = baby.CUnwrapRef();
+    unsigned long n = n_parents * parent->babies_per_birth();
+    unsigned long fed =
+        player_.FeedCohort(b, n, state_.food_type, state_.base_food_cost);
+    double food_cost = fed * b.FoodCost(state_.food_type,
+                                        state_.base_food_cost);
+    feeding_cost_ += food_cost;
+    if (fed != n) {
+      os_ << "You don't have enough money to feed your newborn "
+          << b.name() << "s!\n";
+      return GameTurnResult::PlayerBankrupt;
+    }
+
+    TraceInstant("Births", "babies", n);
+    os_ << n_parents << " adult " << b.name()
+        << (n_parents == 1 ? " gave" : "s gave") << " birth to " << n
+        << " babies; paid $" << food_cost << " to feed them.\n";
   }
 
   return None;
 }
 
 /*********************************************************************
-** Function: BuildAnimalPurchase
-** Description: Takes the species the player wants to buy and prompts
- * them for the quantity, building a transaction with species and
- * quantity.
-** Parameters: s is the species the player wants to purchase.
+** Function: PopulationSicknesses
+** Description: Handles the day's sicknesses: treats as many of the sick
+ * animals as the player can afford, and the rest die.
+** Parameters: sicknesses are the cohorts of sick animals.
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
-Option<GameTurn::AnimalPurchase>
-GameTurn::BuildAnimalPurchase(AnimalSpecies s) const {
-  if (!CanBuyAnimal()) return None;
-
-  std::string animal_type = AnimalSpeciesToString(s);
-  std::cout << "\nHow many " << animal_type << "s would you like to buy?\n";
-
-  MenuPrompt<unsigned> prompt(true);
-  prompt.AddOptions({1,2});
-  ActionStringMap<unsigned> options_map = {
-      {1, "One"},
-      {2, "Two"}
-  };
+void GameTurn::PopulationSicknesses(
+    const std::vector<CohortEvent> &sicknesses) {
+  std::array<unsigned long, NUMBER_OF_SPECIES> sick{}, deaths{};
+  std::array<double, NUMBER_OF_SPECIES> care_costs{};
+  for (const CohortEvent &e : sicknesses) {
+    const Animal &a = e.animal;
+    unsigned long treated = player_.CareForSickAnimals(a, e.count);
+    unsigned long died = zoo_.RemoveAnimals(a, e.count - treated);
+
+    unsigned s = SpeciesIndex(a.species());
+    sick[s] += e.count;
+    deaths[s] += died;
+    care_costs[s] += treated * a.SickCareCost();
+  }
 
-  if (animals_bought_.IsSome()) prompt.RemoveOption(2);
-  prompt.OverrideStrings(options_map);
-  return prompt().Map<AnimalPurchase>([s](unsigned qty) {
-      return std::make_pair(s, qty);
-  });
+  for (unsigned s = 0; s != NUMBER_OF_SPECIES; ++s) {
+    if (!sick[s]) continue;
+    TraceInstant("Sick animals", "count", sick[s]);
+    std::string name = AnimalSpeciesToString(static_cast<AnimalSpecies>(s));
+    os_ << sick[s] << ' ' << name << (sick[s] == 1 ? " fell" : "s fell")
+        << " sick; you paid $" << care_costs[s] << " in medical costs.\n";
+    if (deaths[s]) {
+      TraceInstant("Deaths", "count", deaths[s]);
+      os_ << "Since you could not afford to treat them all, " << deaths[s]
+          << ' ' << name << (deaths[s] == 1 ? " has" : "s have")
+          << " died.\n";
+    }
+  }
 }
 
 /*********************************************************************
-** Function: PromptPlayerBuyAnimal
-** Description: Asks the player which species they would like to purchase,
- * then how many they want to buy.
+** Function: RecordDeaths
+** Description: Tells the player about the animals that died of old age
+ * this morning, and records them in the ledger.
 ** Parameters: None
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
-Option<GameTurn::AnimalPurchase> GameTurn::PromptPlayerBuyAnimal() {
-  if (!CanBuyAnimal()) return None;
-
-  std::vector<AnimalSpecies> animal_options;
-  Option<std::string> prompt_msg = animals_bought_.MapCRef<std::string>(
-      [&](const AnimalPurchase &p) {
-          // small side effect
-          animal_options.push_back(p.first);
+void GameTurn::RecordDeaths() {
+  for (unsigned s = 0; s != NUMBER_OF_SPECIES; ++s) {
+    unsigned long n = deaths_[s];
+    if (!n) continue;
+    AnimalSpecies species = static_cast<AnimalSpecies>(s);
+    TraceInstant("Deaths of old age", "count", n);
+    player_.RecordDeaths(species, n);
+    if (n == 1)
+      os_ << "A " << AnimalSpeciesToString(species)
+          << " died of old age.\n";
+    else
+      os_ << n << ' ' << AnimalSpeciesToString(species)
+          << "s died of old age.\n";
+  }
+}
 
-          std::string animal_type = AnimalSpeciesToString(p.first);
-          std::ostringstream oss;
+/*********************************************************************
+** Function: SickAnimal
+** Description: Handles a sick animal event, making sure the player can
+ * afford to care for the sick animal.
+** Parameters: sick_animal is the animal that is sick.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+Option<GameTurnResult> GameTurn::SickAnimal(CAnimalRef sick_animal) {
+  TraceInstant("Sick animal", "species",
+               static_cast<int>(sick_animal.get().species()));
+  os_ << "A " << sick_animal.get().name() << " fell sick!\n";
 
-          oss << "\nYou've already purchased " << p.second << ' '
-              << animal_type << " this turn, so the only thing you can buy is "
-              << MAX_ANIMAL_PURCHASES - p.second << " more " << animal_type
-              << ".\n"
-              << "What would you like to do?";
+  if (!player_.CareForSickAnimal(sick_animal)) {
+    os_ << "Since you cannot afford to pay for their medical costs, "
+        << "the " << sick_animal.get().name() << " has died.\n";
+    TraceInstant("Death", "species",
+                 static_cast<int>(sick_animal.get().species()));
+    zoo_.RemoveAnimal(sick_animal);
+  } else {
+    os_ << "You paid $" << sick_animal.get().SickCareCost()
+        << " in medical costs to treat the " << sick_animal.get().name()
+        << ".\n";
+  }
 
-          return oss.str();
-      }
-  );
+  return None;
+}
 
-  if (animal_options.empty()) animal_options = AllSpecies();
+/*********************************************************************
+** Function: PromptPlayerBuyAnimal
+** Description: Asks the player which species they would like to purchase.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: The turn waits in the ChooseSpecies phase.
+*********************************************************************/
+void GameTurn::PromptPlayerBuyAnimal() {
+  ZT_PROFILE_PHASE(Rendering);
+  species_prompt_.Reset(true);
+  Option<std::string> prompt_msg = None;
+  if (animals_bought_.IsNone()) {
+    species_prompt_.AddOptions(AllSpecies());
+  } else {
+    const AnimalPurchase &p = animals_bought_.CUnwrapRef();
+    species_prompt_.AddOption(p.first);
+
+    if (os_.enabled()) {
+      std::string animal_type = AnimalSpeciesToString(p.first);
+      std::ostringstream oss;
+
+      oss << "\nYou've already purchased " << p.second << ' '
+          << animal_type << " this turn, so the only thing you can buy is "
+          << MAX_ANIMAL_PURCHASES - p.second << " more " << animal_type
+          << ".\n"
+          << "What would you like to do?";
+      prompt_msg = oss.str();
+    }
+  }
 
-  MenuPrompt<AnimalSpecies> prompt(true);
-  prompt.AddOptions(animal_options);
-  return prompt(prompt_msg).AndThen<AnimalPurchase>(
-      [&](AnimalSpecies s) { return BuildAnimalPurchase(s); });
+  ShowPrompt(species_prompt_, prompt_msg);
+  phase_ = GameTurnPhase::ChooseSpecies;
 }
 
 /*********************************************************************
@@ -375,13 +854,56 @@ Option<GameTurn::AnimalPurchase> GameTurn::PromptPlayerBuyAnimal() {
  * animals this turn.
 ** Parameters: None
 ** Pre-Conditions: None
-** Post-Conditions: None
+** Post-Conditions: The turn waits in the ChooseFood phase.
+*********************************************************************/
+void GameTurn::PromptPlayerFoodType() {
+  ZT_PROFILE_PHASE(Rendering);
+  food_prompt_.Reset();
+  food_prompt_.AddOptions(AllFoodOptions());
+  os_ << "\nWhat food would you like to feed your animals today?\n";
+  ShowPrompt(food_prompt_);
+  phase_ = GameTurnPhase::ChooseFood;
+}
+
+/*********************************************************************
+** Function: PromptPlayerListing
+** Description: Asks the player what to do while paging through the zoo's
+ * animals; only the pages that exist are offered.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: The turn waits in the BrowseAnimals phase.
+*********************************************************************/
+void GameTurn::PromptPlayerListing() {
+  ZT_PROFILE_PHASE(Rendering);
+  listing_prompt_.Reset();
+  listing_prompt_.AddOptions(AllListingActions());
+  if (listing_page_ == 0)
+    listing_prompt_.RemoveOption(ZooListingAction::PreviousPage);
+  if ((listing_page_ + 1) * ZOO_LISTING_PAGE_SIZE >= listing_size_)
+    listing_prompt_.RemoveOption(ZooListingAction::NextPage);
+  ShowPrompt(listing_prompt_);
+  phase_ = GameTurnPhase::BrowseAnimals;
+}
+
+/*********************************************************************
+** Function: PromptPlayerListingSpecies
+** Description: Asks the player which species they would like to list.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: The turn waits in the ChooseListingSpecies phase.
 *********************************************************************/
-FoodType GameTurn::PromptPlayerFoodType() const {
-  MenuPrompt<FoodType> prompt;
-  prompt.AddOptions(AllFoodOptions());
-  std::cout << "\nWhat food would you like to feed your animals today?\n";
-  return prompt().Unwrap();
+void GameTurn::PromptPlayerListingSpecies() {
+  ZT_PROFILE_PHASE(Rendering);
+  listing_species_prompt_.Reset(true);
+  listing_species_prompt_.AddOptions(AllSpecies());
+  Option<std::string> prompt_msg = None;
+  if (os_.enabled()) {
+    listing_species_prompt_.OverrideStrings(AnimalSpeciesToStringMap);
+    prompt_msg = std::string("\nWhich species would you like to list? "
+                             "Cancel to list all of them.");
+  }
+  ShowPrompt(listing_species_prompt_, prompt_msg);
+  phase_ = GameTurnPhase::ChooseListingSpecies;
 }
 
 /*********************************************************************
@@ -389,13 +911,64 @@ FoodType GameTurn::PromptPlayerFoodType() const {
 ** Description: Prompts the player with the main action menu.
 ** Parameters: None
 ** Pre-Conditions: None
-** Post-Conditions: None
+** Post-Conditions: The turn waits in the MainMenu phase.
 *********************************************************************/
-PlayerMainAction GameTurn::PromptPlayerMainMenu() {
-  MenuPrompt<PlayerMainAction> prompt;
-  prompt.AddOptions(AllMainActions());
-  if (!CanBuyAnimal()) prompt.RemoveOption(PlayerMainAction::BuyAnimal);
-  return prompt().Unwrap();
+void GameTurn::PromptPlayerMainMenu() {
+  ZT_PROFILE_PHASE(Rendering);
+  main_prompt_.Reset();
+  main_prompt_.AddOptions(AllMainActions());
+  if (!CanBuyAnimal()) main_prompt_.RemoveOption(PlayerMainAction::BuyAnimal);
+  ShowPrompt(main_prompt_);
+  phase_ = GameTurnPhase::MainMenu;
+}
+
+/*********************************************************************
+** Function: PromptPlayerQuantity
+** Description: Takes the species the player wants to buy and asks them
+ * how many they want.
+** Parameters: s is the species the player wants to purchase.
+** Pre-Conditions: None
+** Post-Conditions: The turn waits in the ChooseQuantity phase.
+*********************************************************************/
+void GameTurn::PromptPlayerQuantity(AnimalSpecies s) {
+  ZT_PROFILE_PHASE(Rendering);
+  if (os_.enabled())
+    os_ << "\nHow many " << AnimalSpeciesToString(s)
+        << "s would you like to buy?\n";
+
+  quantity_prompt_.Reset(true);
+  quantity_prompt_.AddOptions({1,2});
+  if (animals_bought_.IsSome()) quantity_prompt_.RemoveOption(2);
+  if (os_.enabled()) {
+    ActionStringMap<unsigned> options_map = {
+        {1, "One"},
+        {2, "Two"}
+    };
+    quantity_prompt_.OverrideStrings(options_map);
+  }
+  ShowPrompt(quantity_prompt_);
+
+  species_choice_ = s;
+  phase_ = GameTurnPhase::ChooseQuantity;
+}
+
+/*********************************************************************
+** Function: ShowPrompt
+** Description: Shows the player a menu and asks them to enter an option;
+ * when nobody reads the output, only readies the menu for input.
+** Parameters: prompt is the menu; prompt_msg is an optional message to
+ * show instead of the menu's default one.
+** Pre-Conditions: None
+** Post-Conditions: The menu accepts input.
+*********************************************************************/
+template <class T>
+void GameTurn::ShowPrompt(MenuPrompt<T> &prompt,
+                          Option<std::string> prompt_msg) {
+  if (!os_.enabled()) {
+    prompt.Prepare();
+    return;
+  }
+  os_ << prompt.Render(prompt_msg) << MENU_PROMPT_INPUT_MSG << std::flush;
 }
 
 /*********************************************************************
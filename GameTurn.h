@@ -4,21 +4,29 @@
 ** Program Filename: GameTurn.h
 ** Author: Jason Chen
 ** Date: 02/19/2018
-** Description: Declares the GameTurn class and its related members. 
+** Description: Declares the GameTurn class and its related members.
 ** Input: None
 ** Output: None
 *********************************************************************/
 
 
 #include <map>
+#include <memory>
 #include <string>
 #include "Option.h"
 #include "AnimalSpecies.h"
+#include "MenuPrompt.h"
+#include "OutputSink.h"
+#include "PopulationEvents.h"
 #include "SpecialEvent.h"
 #include "Player.h"
 #include "PlayerAction.h"
+#include "GameState.h"
 
 static constexpr unsigned MAX_ANIMAL_PURCHASES = 2;
+// Zoos with more animals than this are listed as a summary followed by
+// pages of this many animals, rather than in full.
+static constexpr unsigned ZOO_LISTING_PAGE_SIZE = 20;
 
 enum class GameTurnResult {
   Continue,
@@ -27,47 +35,120 @@ enum class GameTurnResult {
   Quit
 };
 
+// The menu a turn is waiting on the player to answer.
+enum class GameTurnPhase {
+  ChooseFood,
+  MainMenu,
+  ChooseSpecies,
+  ChooseQuantity,
+  BrowseAnimals,
+  ChooseListingSpecies,
+  Finished
+};
+
+// A GameTurn is a resumable state machine: it never reads input itself.
+// Begin() writes the first prompt, and every call to Input() (or one of the
+// typed Choose* events) advances the turn up to the next prompt. Once the
+// turn is over, those calls return the turn's result. A Game plays all of
+// its days with one GameTurn, which Restart() readies for the next day
+// while keeping its menus' and special event's memory.
 class GameTurn {
   friend class Game;
 
   public:
-    GameTurnResult Run();
+    GameTurnPhase phase() const { return phase_; }
+    Option<GameTurnResult> result() const { return result_; }
+
+    Option<GameTurnResult> Input(const std::string &line);
+
+    Option<GameTurnResult> ChooseFood(FoodType t);
+    Option<GameTurnResult> ChooseMainAction(PlayerMainAction action);
+    Option<GameTurnResult> ChooseQuantity(Option<unsigned> qty);
+    Option<GameTurnResult> ChooseSpecies(Option<AnimalSpecies> s);
+    Option<GameTurnResult> ChooseListingAction(ZooListingAction action);
+    Option<GameTurnResult> ChooseListingSpecies(Option<AnimalSpecies> s);
 
     void PrintGameState() const;
 
   private:
     using AnimalPurchase = std::pair<AnimalSpecies, unsigned>;
 
-    GameTurn(Player &player, double base_food_cost);
-
-    // The current day of the game.
-    static unsigned day_;
-    // The type of food to feed the animals this turn.
-    static FoodType food_type_;
+    GameTurn(Player &player, GameState &state, OutputSink &os,
+             bool population_events = false);
 
     // Keeps track of what, if any, and how many animals the player has
     // purchased this turn.
     Option<AnimalPurchase> animals_bought_ = None;
     Player &player_;
     Zoo &zoo_;
+    // Per-game state owned by the Game running this turn.
+    GameState &state_;
+    // Where all of the turn's output goes.
+    OutputSink &os_;
+
+    GameTurnPhase phase_ = GameTurnPhase::ChooseFood;
+    Option<GameTurnResult> result_ = None;
+
+    // The menus for each phase; only the current phase's menu is rendered.
+    MenuPrompt<FoodType> food_prompt_;
+    MenuPrompt<PlayerMainAction> main_prompt_;
+    MenuPrompt<AnimalSpecies> species_prompt_;
+    MenuPrompt<unsigned> quantity_prompt_;
+    MenuPrompt<ZooListingAction> listing_prompt_;
+    MenuPrompt<AnimalSpecies> listing_species_prompt_;
+    // The species picked in the ChooseSpecies phase.
+    AnimalSpecies species_choice_ = AnimalSpecies::Monkey;
+    // The animals being browsed in the BrowseAnimals phase, and the page
+    // shown, from 0; listing_size_ is how many animals the filter matches.
+    ZooListingFilter listing_filter_;
+    AnimalsVec::size_type listing_page_ = 0;
+    AnimalsVec::size_type listing_size_ = 0;
+
+    // Only chosen once the player has picked the day's food; created on
+    // the first day and redrawn on the ones after.
+    std::unique_ptr<SpecialEvent> special_event_;
+    // Whether sicknesses and births are PopulationEvents rather than
+    // special events; attendance booms are special events either way.
+    bool population_events_;
 
-    SpecialEvent special_event_;
-
-    double base_food_cost_;
     Option<unsigned> monkey_bonus_revenue_;
 
+    // The day's revenue, and what it spent on food; see DayMetrics.
+    double revenue_ = 0.0;
+    double feeding_cost_ = 0.0;
+    // The animals that died of old age today.
+    SpeciesDeaths deaths_{};
+
+    void Begin();
+    Option<GameTurnResult> Finish(GameTurnResult result);
+    void Restart(bool population_events);
+    Option<GameTurnResult> Reprompt() const;
+
     Option<GameTurnResult> AnimalBirth(CAnimalRef parent);
+    void Conceive(const std::vector<CohortEvent> &births);
     Option<GameTurnResult> FeedAnimals();
     void GivePlayerRevenue();
+    Option<GameTurnResult> HandlePopulationEvents();
+    Option<GameTurnResult> HandleScheduledEvents();
     Option<GameTurnResult> HandleSpecialEvent();
-    Option<GameTurnResult> HandleMainAction(PlayerMainAction action);
+    void HandleMainAction(PlayerMainAction action);
     Option<GameTurnResult> PlayerBuyAnimal(AnimalSpecies s, unsigned qty);
+    void RecordDeaths();
+    void PopulationSicknesses(const std::vector<CohortEvent> &sicknesses);
     Option<GameTurnResult> SickAnimal(CAnimalRef sick_animal);
 
-    Option<AnimalPurchase> BuildAnimalPurchase(AnimalSpecies s) const;
-    Option<AnimalPurchase> PromptPlayerBuyAnimal();
-    FoodType PromptPlayerFoodType() const;
-    PlayerMainAction PromptPlayerMainMenu();
+    void BrowseAnimals(Option<AnimalSpecies> s);
+    void PrintListingPage() const;
+
+    void PromptPlayerBuyAnimal();
+    void PromptPlayerFoodType();
+    void PromptPlayerListing();
+    void PromptPlayerListingSpecies();
+    void PromptPlayerMainMenu();
+    void PromptPlayerQuantity(AnimalSpecies s);
+    template <class T>
+    void ShowPrompt(MenuPrompt<T> &prompt,
+                    Option<std::string> prompt_msg = None);
 
     bool CanBuyAnimal() const;
 };
@@ -0,0 +1,107 @@
+/*********************************************************************
+** Program Filename: InputLog.cpp
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Implements the InputRecorder class and the functions
+ * declared in the InputLog header.
+** Input: None
+** Output: None
+*********************************************************************/
+#include <cerrno>
+#include <cstring>
+#include <ios>
+#include <sstream>
+#include "Game.h"
+#include "InputLog.h"
+
+/*********************************************************************
+** Function: InputRecorder
+** Description: Constructor for the InputRecorder class; starts a new log,
+ * replacing any file at path.
+** Parameters: path is the file to record to; seed is the seed the game's
+ * random engine was created with; rules are the game's rules.
+** Pre-Conditions: None
+** Post-Conditions: good() is false if the file could not be written.
+*********************************************************************/
+InputRecorder::InputRecorder(const std::string &path, std::uint32_t seed,
+                             const GameRules &rules):
+    out_(path, std::ios::binary | std::ios::trunc) {
+  out_ << INPUT_LOG_MAGIC << ' ' << INPUT_LOG_VERSION << ' ' << seed << ' '
+       << rules.population_events << ' ' << std::hex << rules.event_weights
+       << std::dec << '\n' << std::flush;
+}
+
+/*********************************************************************
+** Function: Record
+** Description: Appends a line of input to the log. Every line is flushed
+ * at once, so the log survives the game crashing.
+** Parameters: line is the line of input, without its newline.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void InputRecorder::Record(const std::string &line) {
+  out_ << line << '\n' << std::flush;
+}
+
+/*********************************************************************
+** Function: ReadInputLog
+** Description: Reads an input log.
+** Parameters: path is the file to read; log receives the seed, rules and
+ * lines; error receives a description of what went wrong, if anything.
+** Pre-Conditions: None
+** Post-Conditions: Returns false if the file could not be read or is not
+ * an input log of this version.
+*********************************************************************/
+bool ReadInputLog(const std::string &path, InputLog &log,
+                  std::string &error) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    error = std::strerror(errno);
+    return false;
+  }
+
+  std::string header, magic;
+  unsigned version = 0;
+  std::getline(in, header);
+  std::istringstream header_is(header);
+  if (!(header_is >> magic >> version >> log.seed) ||
+      magic != INPUT_LOG_MAGIC) {
+    error = "not an input log";
+    return false;
+  }
+  if (version != INPUT_LOG_VERSION) {
+    error = "recorded by an incompatible version of the game";
+    return false;
+  }
+  if (!(header_is >> log.rules.population_events >> std::hex >>
+        log.rules.event_weights)) {
+    error = "not an input log";
+    return false;
+  }
+
+  log.lines.clear();
+  for (std::string line; std::getline(in, line);)
+    log.lines.push_back(std::move(line));
+  return true;
+}
+
+/*********************************************************************
+** Function: ReplayInputLog
+** Description: Feeds a log's lines to a game, stopping early once the
+ * game has finished day to_day, if given.
+** Parameters: game is a started game, created with the log's seed;
+ * log is the log; to_day is the last day to replay, or 0 for all.
+** Pre-Conditions: None
+** Post-Conditions: Returns the number of lines fed to the game.
+*********************************************************************/
+std::size_t ReplayInputLog(Game &game, const InputLog &log,
+                           unsigned to_day) {
+  std::size_t n = 0;
+  for (; n != log.lines.size() && !game.IsOver(); ++n) {
+    if (to_day && game.state().day >= to_day && game.awaiting_next_day())
+      break;
+    game.Input(log.lines[n]);
+  }
+
+  return n;
+}
@@ -0,0 +1,60 @@
+#ifndef ZOO_TYCOON_INPUTLOG_H
+#define ZOO_TYCOON_INPUTLOG_H
+/*********************************************************************
+** Program Filename: InputLog.h
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Declares the InputRecorder class, which records a game's
+ * seed and input to a log, and the functions that read such a log and
+ * replay it.
+** Input: None
+** Output: None
+*********************************************************************/
+
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "GameState.h"
+
+class Game;
+
+// An input log is a header line, "ZOOLOG <version> <seed>
+// <population_events> <event_weights>", giving the game's seed and
+// GameRules (the digest in hex), followed by every line of input the game
+// consumed, in order, one per line. A game started with std::mt19937(seed)
+// and the same rules, and fed the same lines, plays out exactly the same.
+// The version changes whenever the game starts drawing its random numbers
+// differently (version 2: event types are drawn from alias tables), since
+// older logs would then play out differently, or the header changes
+// (version 3: the rules).
+static constexpr char INPUT_LOG_MAGIC[] = "ZOOLOG";
+static constexpr unsigned INPUT_LOG_VERSION = 3;
+
+class InputRecorder {
+  public:
+    InputRecorder(const std::string &path, std::uint32_t seed,
+                  const GameRules &rules);
+
+    bool good() const { return static_cast<bool>(out_); }
+
+    void Record(const std::string &line);
+
+  private:
+    std::ofstream out_;
+};
+
+struct InputLog {
+  std::uint32_t seed = 0;
+  GameRules rules = GameRules();
+  std::vector<std::string> lines;
+};
+
+bool ReadInputLog(const std::string &path, InputLog &log,
+                  std::string &error);
+std::size_t ReplayInputLog(Game &game, const InputLog &log,
+                           unsigned to_day = 0);
+
+
+#endif //ZOO_TYCOON_INPUTLOG_H
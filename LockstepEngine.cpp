@@ -0,0 +1,502 @@
+/*********************************************************************
+** Program Filename: LockstepEngine.cpp
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Implements functions declared by the LockstepEngine class.
+** Input: None
+** Output: None
+*********************************************************************/
+#include <algorithm>
+#include <cmath>
+#include "LockstepEngine.h"
+#include "BankAccount.h"
+#include "GameTurn.h"
+
+/*********************************************************************
+** Function: KeptBefore
+** Description: Follows an index into a game's cohorts through
+ * AnimalCohorts::Compact: the cohorts kept from before it are the ones
+ * before it afterwards.
+** Parameters: remap is what Compact returned; next is the index.
+** Pre-Conditions: next <= remap.size()
+** Post-Conditions: None
+*********************************************************************/
+static AnimalCohorts::size_type KeptBefore(
+    const CowArray<AnimalCohorts::size_type> &remap,
+    AnimalCohorts::size_type next) {
+  AnimalCohorts::size_type kept = 0;
+  for (AnimalCohorts::size_type c = 0; c != next; ++c)
+    if (remap[c] != AnimalCohorts::NO_COHORT) ++kept;
+  return kept;
+}
+
+/*********************************************************************
+** Function: LockstepEngine
+** Description: Constructor for the LockstepEngine class; every game
+ * starts out done until Reset is called.
+** Parameters: n_games is the number of games.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+LockstepEngine::LockstepEngine(std::size_t n_games):
+    balance_(n_games, 0.0), base_food_cost_(n_games, 0.0),
+    day_(n_games, 0), dones_(n_games, 1), rng_engines_(n_games),
+    cohorts_(n_games), next_weaned_(n_games, 0), next_grown_(n_games, 0),
+    expiring_(n_games),
+    food_factor_(n_games, 1.0),
+    event_(n_games, SpecialEventType::NoSpecialEvent),
+    event_cohort_(n_games), bonus_revenue_(n_games, 0.0),
+    playing_(n_games, 0),
+    start_balance_(n_games, 0.0),
+    observations_(n_games * ZOO_ENV_OBSERVATION_SIZE, 0.0),
+    rewards_(n_games, 0.0) {
+  for (unsigned s = 0; s != NUMBER_OF_SPECIES; ++s) {
+    AnimalSpecies species = static_cast<AnimalSpecies>(s);
+    std::unique_ptr<Animal> adult =
+        CreateFromSpecies(species, ANIMAL_ADULT_AGE);
+    std::unique_ptr<Animal> baby = CreateFromSpecies(species, 0);
+
+    traits_[s].cost = adult->cost();
+    traits_[s].food_cost_multiplier = adult->FoodCost(FoodType::Regular, 1);
+    traits_[s].adult_revenue = adult->DailyRevenue(None);
+    traits_[s].baby_revenue = baby->DailyRevenue(None);
+    traits_[s].babies_per_birth = adult->babies_per_birth();
+    traits_[s].lifespan = adult->lifespan();
+
+    animals_[s].assign(n_games, 0);
+    adults_[s].assign(n_games, 0);
+    babies_[s].assign(n_games, 0);
+  }
+}
+
+/*********************************************************************
+** Function: Reset
+** Description: Starts a new game in every slot, keeping the memory the
+ * last games' cohorts used and making room for more; see the class
+ * comment.
+** Parameters: seeds holds size() seeds, one per game; see
+ * ZooBatchEnv::Reset.
+** Pre-Conditions: None
+** Post-Conditions: Every game is on day one and not done.
+*********************************************************************/
+void LockstepEngine::Reset(const std::uint32_t *seeds) {
+  for (std::size_t i = 0; i != size(); ++i) {
+    balance_[i] = PLAYER_STARTING_BALANCE;
+    base_food_cost_[i] = DEFAULT_BASE_FOOD_COST;
+    day_[i] = 0;
+    dones_[i] = 0;
+    rng_engines_[i].seed(seeds[i]);
+    for (unsigned s = 0; s != NUMBER_OF_SPECIES; ++s)
+      animals_[s][i] = adults_[s][i] = babies_[s][i] = 0;
+    cohorts_[i].Clear();
+    cohorts_[i].Reserve(NUMBER_OF_SPECIES * LOCKSTEP_RESERVED_COHORTS);
+    next_weaned_[i] = next_grown_[i] = 0;
+    for (CohortHeap &expiring : expiring_[i]) {
+      expiring.clear();
+      expiring.reserve(LOCKSTEP_RESERVED_COHORTS);
+    }
+    rewards_[i] = 0.0;
+    Observe(i);
+  }
+}
+
+/*********************************************************************
+** Function: Step
+** Description: Plays one day in every game that is not done.
+** Parameters: actions holds size() actions, one per game.
+** Pre-Conditions: Reset has been called.
+** Post-Conditions: See ZooBatchEnv::Step.
+*********************************************************************/
+void LockstepEngine::Step(const ZooEnvAction *actions) {
+  for (std::size_t i = 0; i != size(); ++i) {
+    playing_[i] = !dones_[i];
+    start_balance_[i] = balance_[i];
+  }
+
+  DrawEvents(actions);
+  FeedAnimals();
+  HandleSpecialEvents();
+  PlayMainActions(actions);
+  GiveRevenue();
+  DrawBaseFoodCosts();
+
+  for (std::size_t i = 0; i != size(); ++i) {
+    if (!playing_[i]) {
+      rewards_[i] = 0.0;
+      continue;
+    }
+
+    rewards_[i] = balance_[i] - start_balance_[i];
+    Observe(i);
+  }
+}
+
+/*********************************************************************
+** Function: DrawEvents
+** Description: Starts the day in every game: removes the animals that
+ * died of old age, makes the special event's draws, in the order
+ * SpecialEvent makes them, then ages the animals.
+** Parameters: actions holds the day's actions.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void LockstepEngine::DrawEvents(const ZooEnvAction *actions) {
+  for (std::size_t i = 0; i != size(); ++i) {
+    if (!playing_[i]) continue;
+
+    FoodType food = actions[i].food;
+    std::mt19937 &rng_engine = rng_engines_[i];
+    const AnimalCohorts &cohorts = cohorts_[i];
+
+    ++day_[i];
+    ExpireAnimals(i);
+    if (food == FoodType::Premium) food_factor_[i] = 2.0;
+    else if (food == FoodType::Cheap) food_factor_[i] = 0.5;
+    else food_factor_[i] = 1.0;
+
+    event_[i] = SpecialEvent::DrawEventType(food, rng_engine);
+    event_cohort_[i] = None;
+    bonus_revenue_[i] = 0.0;
+
+    switch (event_[i]) {
+      case SpecialEventType::SickAnimal:
+        if (cohorts.NumberOfAnimals())
+          event_cohort_[i] = cohorts.FindAnimal(SpecialEvent::DrawIndex(
+              cohorts.NumberOfAnimals(), rng_engine));
+        break;
+      case SpecialEventType::AnimalBirth:
+        if (cohorts.NumberOfAdults())
+          event_cohort_[i] = cohorts.FindAdult(SpecialEvent::DrawIndex(
+              cohorts.NumberOfAdults(), rng_engine));
+        break;
+      case SpecialEventType::ZooAttendanceBoom:
+        bonus_revenue_[i] = SpecialEvent::DrawBonusRevenue(rng_engine);
+        break;
+      default: break;
+    }
+
+    AgeAnimals(i);
+  }
+}
+
+/*********************************************************************
+** Function: FeedAnimals
+** Description: Feeds every game's animals exactly like
+ * Player::FeedAnimals, so that balances come out bit for bit the same:
+ * only if the player can afford the (truncated) feeding cost of
+ * Zoo::FeedingCost, and then with one withdrawal a cohort, in the zoo's
+ * order, of as many of its animals as the player can afford. The
+ * truncated cost is a sum of whole dollars, which comes out the same in
+ * any order, so it is summed by species.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void LockstepEngine::FeedAnimals() {
+  for (std::size_t i = 0; i != size(); ++i) {
+    if (!playing_[i]) continue;
+
+    // The same products, in the same order, as Animal::FoodCost.
+    std::array<double, NUMBER_OF_SPECIES> food_cost;
+    double whole_cost = 0.0;
+    for (unsigned s = 0; s != NUMBER_OF_SPECIES; ++s) {
+      food_cost[s] = traits_[s].food_cost_multiplier * base_food_cost_[i] *
+                     food_factor_[i];
+      whole_cost += static_cast<double>(animals_[s][i]) *
+                    static_cast<unsigned>(food_cost[s]);
+    }
+    if (!(whole_cost <= balance_[i])) continue;
+
+    double balance = balance_[i];
+    cohorts_[i].ForEach([&](const AnimalCohort &c) {
+      if (c.count == 0) return;
+      double cost = food_cost[SpeciesIndex(c.species)];
+      // Usually the whole cohort is affordable, which is what
+      // CountAffordable would say anyway.
+      unsigned long fed = cost * c.count <= balance ?
+          c.count : CountAffordable(balance, cost, c.count);
+      if (fed) balance -= cost * fed;
+    });
+    balance_[i] = balance;
+  }
+}
+
+/*********************************************************************
+** Function: HandleSpecialEvents
+** Description: Handles every game's special event.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void LockstepEngine::HandleSpecialEvents() {
+  for (std::size_t i = 0; i != size(); ++i) {
+    if (!playing_[i]) continue;
+    HandleSpecialEvent(i);
+  }
+}
+
+/*********************************************************************
+** Function: PlayMainActions
+** Description: Buys the animals asked for and quits the games asked to.
+** Parameters: actions holds the day's actions.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void LockstepEngine::PlayMainActions(const ZooEnvAction *actions) {
+  for (std::size_t i = 0; i != size(); ++i) {
+    if (!playing_[i] || dones_[i]) continue;
+
+    const ZooEnvAction &action = actions[i];
+    if (action.action == PlayerMainAction::BuyAnimal && action.quantity)
+      BuyAnimals(i, action.species,
+                 std::min(action.quantity, MAX_ANIMAL_PURCHASES));
+    else if (action.action == PlayerMainAction::QuitGame)
+      dones_[i] = 1;
+  }
+}
+
+/*********************************************************************
+** Function: GiveRevenue
+** Description: Pays every game that is still going its daily revenue,
+ * like Zoo::TotalDailyRevenue. Revenues are whole dollars, so summing
+ * them by species gives exactly the Zoo's animal-by-animal total.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void LockstepEngine::GiveRevenue() {
+  const std::vector<unsigned long> &monkeys =
+      animals_[SpeciesIndex(AnimalSpecies::Monkey)];
+
+  for (std::size_t i = 0; i != size(); ++i) {
+    double revenue = 0.0;
+    for (unsigned s = 0; s != NUMBER_OF_SPECIES; ++s)
+      revenue += (animals_[s][i] - babies_[s][i]) * traits_[s].adult_revenue +
+                 babies_[s][i] * traits_[s].baby_revenue;
+    revenue += monkeys[i] * bonus_revenue_[i];
+
+    balance_[i] += playing_[i] && !dones_[i] ? revenue : 0.0;
+  }
+}
+
+/*********************************************************************
+** Function: DrawBaseFoodCosts
+** Description: Moves every game that is still going on to the next day's
+ * base food cost.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void LockstepEngine::DrawBaseFoodCosts() {
+  for (std::size_t i = 0; i != size(); ++i) {
+    if (!playing_[i] || dones_[i]) continue;
+    base_food_cost_[i] =
+        Game::DrawBaseFoodCost(base_food_cost_[i], rng_engines_[i]);
+  }
+}
+
+/*********************************************************************
+** Function: AgeAnimals
+** Description: Counts the cohorts that have just stopped being babies, or
+ * have just become adults, as such.
+** Parameters: i is the index of the game.
+** Pre-Conditions: The game's day has been advanced.
+** Post-Conditions: None
+*********************************************************************/
+void LockstepEngine::AgeAnimals(std::size_t i) {
+  AnimalCohorts &cohorts = cohorts_[i];
+  long today = day_[i];
+
+  // Cohorts are added in the order they are born in, apart from cohorts
+  // bought as adults, which are skipped over.
+  AnimalCohorts::size_type &weaned = next_weaned_[i];
+  for (; weaned != cohorts.size() &&
+         today - cohorts[weaned].birth_day >= ANIMAL_BABY_MAX_AGE; ++weaned) {
+    if (cohorts.IsAdult(weaned)) continue;
+    const AnimalCohort &c = cohorts[weaned];
+    babies_[SpeciesIndex(c.species)][i] -= c.count;
+  }
+
+  AnimalCohorts::size_type &grown = next_grown_[i];
+  for (; grown != cohorts.size() &&
+         today - cohorts[grown].birth_day >= ANIMAL_ADULT_AGE; ++grown) {
+    if (cohorts.IsAdult(grown)) continue;
+    const AnimalCohort &c = cohorts[grown];
+    adults_[SpeciesIndex(c.species)][i] += c.count;
+    cohorts.MarkAdult(grown);
+  }
+}
+
+/*********************************************************************
+** Function: AddAnimals
+** Description: Adds newborn babies, or animals bought as adults, to the
+ * end of a game's zoo.
+** Parameters: i is the index of the game; s is the species; count is the
+ * number of animals; adult is whether they were bought as adults.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void LockstepEngine::AddAnimals(
+    std::size_t i, AnimalSpecies s, unsigned count, bool adult) {
+  long birth_day = day_[i];
+  if (adult) birth_day -= ANIMAL_ADULT_AGE;
+  AnimalCohorts::size_type n_cohorts = cohorts_[i].size();
+  AnimalCohorts::size_type c = cohorts_[i].Add(s, birth_day, count, adult);
+
+  unsigned si = SpeciesIndex(s);
+  if (c == n_cohorts) expiring_[i][si].push(birth_day, c);
+  animals_[si][i] += count;
+  if (adult) adults_[si][i] += count;
+  else babies_[si][i] += count;
+}
+
+/*********************************************************************
+** Function: ExpireAnimals
+** Description: Removes the cohorts of a game that have reached their
+ * species' lifespan, then drops empty cohorts once enough have built up,
+ * like Zoo::RemoveExpiredAnimals.
+** Parameters: i is the index of the game.
+** Pre-Conditions: The game's day has been advanced, but its animals have
+ * not been aged yet.
+** Post-Conditions: None
+*********************************************************************/
+void LockstepEngine::ExpireAnimals(std::size_t i) {
+  AnimalCohorts &cohorts = cohorts_[i];
+  // A Game removes them before aging them, at yesterday's ages.
+  long yesterday = static_cast<long>(day_[i]) - 1;
+
+  for (unsigned s = 0; s != NUMBER_OF_SPECIES; ++s) {
+    CohortHeap &expiring = expiring_[i][s];
+    while (!expiring.empty() &&
+           yesterday - expiring.top().first >=
+               static_cast<long>(traits_[s].lifespan)) {
+      AnimalCohorts::size_type c = expiring.top().second;
+      expiring.pop();
+
+      unsigned long count = cohorts[c].count;
+      if (count == 0) continue;
+      animals_[s][i] -= count;
+      if (cohorts.IsAdult(c)) adults_[s][i] -= count;
+      if (day_[i] - cohorts[c].birth_day < ANIMAL_BABY_MAX_AGE)
+        babies_[s][i] -= count;
+      cohorts.Remove(c, count);
+    }
+  }
+
+  if (!cohorts.WorthCompacting()) return;
+  const CowArray<AnimalCohorts::size_type> &remap = cohorts.Compact();
+  for (CohortHeap &expiring : expiring_[i])
+    expiring.Remap(remap);
+  next_weaned_[i] = KeptBefore(remap, next_weaned_[i]);
+  next_grown_[i] = KeptBefore(remap, next_grown_[i]);
+}
+
+/*********************************************************************
+** Function: BuyAnimals
+** Description: Buys and feeds adult animals, like
+ * GameTurn::PlayerBuyAnimal; ends the game if they cannot be fed.
+** Parameters: i is the index of the game; s is the species to buy; qty is
+ * the number to buy.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void LockstepEngine::BuyAnimals(
+    std::size_t i, AnimalSpecies s, unsigned qty) {
+  unsigned cost = traits_[SpeciesIndex(s)].cost;
+  if (!(cost * qty <= balance_[i])) return;
+
+  for (unsigned n = 0; n != qty; ++n) balance_[i] -= cost;
+  AddAnimals(i, s, qty, true);
+  if (!FeedNewAnimals(i, s, qty)) dones_[i] = 1;
+}
+
+/*********************************************************************
+** Function: FeedNewAnimals
+** Description: Feeds animals that have just been added, one by one.
+** Parameters: i is the index of the game; s is their species; count is
+ * their number.
+** Pre-Conditions: None
+** Post-Conditions: Returns false (the player is bankrupt) if one of them
+ * could not be fed.
+*********************************************************************/
+bool LockstepEngine::FeedNewAnimals(
+    std::size_t i, AnimalSpecies s, unsigned count) {
+  double food_cost = traits_[SpeciesIndex(s)].food_cost_multiplier *
+                     base_food_cost_[i] * food_factor_[i];
+  for (unsigned n = 0; n != count; ++n) {
+    if (!(food_cost <= balance_[i])) return false;
+    balance_[i] -= food_cost;
+  }
+
+  return true;
+}
+
+/*********************************************************************
+** Function: HandleSpecialEvent
+** Description: Handles a game's birth or sickness event, like
+ * GameTurn::AnimalBirth and GameTurn::SickAnimal; ends the game if a
+ * newborn cannot be fed.
+** Parameters: i is the index of the game.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void LockstepEngine::HandleSpecialEvent(std::size_t i) {
+  if (event_cohort_[i].IsNone()) return;
+
+  AnimalCohorts::size_type c = event_cohort_[i].Unwrap();
+  AnimalSpecies s = cohorts_[i][c].species;
+  const SpeciesTraits &traits = traits_[SpeciesIndex(s)];
+
+  if (event_[i] == SpecialEventType::AnimalBirth) {
+    AddAnimals(i, s, traits.babies_per_birth, false);
+    if (!FeedNewAnimals(i, s, traits.babies_per_birth)) dones_[i] = 1;
+    return;
+  }
+
+  double care_cost = static_cast<double>(traits.cost) / 2;
+  if (care_cost <= balance_[i]) balance_[i] -= care_cost;
+  else RemoveAnimal(i, c);
+}
+
+/*********************************************************************
+** Function: RemoveAnimal
+** Description: Removes an animal like the given cohort's from a game;
+ * like Zoo::RemoveAnimal, that is the first animal of the same species
+ * and age.
+** Parameters: i is the index of the game; c is the index of the cohort.
+** Pre-Conditions: The cohort holds at least one animal.
+** Post-Conditions: None
+*********************************************************************/
+void LockstepEngine::RemoveAnimal(std::size_t i, AnimalCohorts::size_type c) {
+  AnimalCohorts &cohorts = cohorts_[i];
+  AnimalSpecies s = cohorts[c].species;
+  long birth_day = cohorts[c].birth_day;
+  AnimalCohorts::size_type first = cohorts.FindFirst(s, birth_day).Unwrap();
+
+  unsigned si = SpeciesIndex(s);
+  --animals_[si][i];
+  if (cohorts.IsAdult(first)) --adults_[si][i];
+  if (day_[i] - birth_day < ANIMAL_BABY_MAX_AGE) --babies_[si][i];
+  cohorts.RemoveOne(first);
+}
+
+/*********************************************************************
+** Function: Observe
+** Description: Writes the observation of the given game, in the layout
+ * ZooBatchEnv uses.
+** Parameters: i is the index of the game.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void LockstepEngine::Observe(std::size_t i) {
+  double *obs = &observations_[i * ZOO_ENV_OBSERVATION_SIZE];
+
+  obs[ZOO_ENV_OBS_BALANCE] = balance_[i];
+  obs[ZOO_ENV_OBS_BASE_FOOD_COST] = base_food_cost_[i];
+  obs[ZOO_ENV_OBS_DAY] = day_[i];
+
+  for (unsigned s = 0; s != NUMBER_OF_SPECIES; ++s) {
+    obs[ZOO_ENV_OBS_ADULTS + s] = adults_[s][i];
+    obs[ZOO_ENV_OBS_BABIES + s] = babies_[s][i];
+  }
+}
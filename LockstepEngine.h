@@ -0,0 +1,126 @@
+#ifndef ZOO_TYCOON_LOCKSTEPENGINE_H
+#define ZOO_TYCOON_LOCKSTEPENGINE_H
+/*********************************************************************
+** Program Filename: LockstepEngine.h
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Declares the LockstepEngine class, which simulates
+ * thousands of headless games at once from flat per-game arrays.
+** Input: None
+** Output: None
+*********************************************************************/
+
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "AnimalCohorts.h"
+#include "SpecialEvent.h"
+#include "ZooBatchEnv.h"
+
+// How many cohorts of each species Reset makes room for in each game; a
+// game of zoo_lockstep's default length ends with about 128 in all.
+static constexpr std::size_t LOCKSTEP_RESERVED_COHORTS = 32;
+
+// LockstepEngine plays the same games as ZooBatchEnv, with the same
+// actions, observations, rewards and dones, but keeps each game as a
+// column of structure-of-arrays state (balance, base food cost, day, and
+// per-species animal counts) plus the game's AnimalCohorts, instead of a
+// Game with a Zoo of Animal objects. A day is played as a series of passes
+// over all games; revenue is a plain loop over the arrays that the
+// compiler can vectorize, and the rest is handled game by game.
+//
+// Given the same seeds and actions, every game makes exactly the draws and
+// the withdrawals of its ZooBatchEnv counterpart, in the same order and
+// with the same floating-point operations, so days, events, animal
+// counts, dones and balances all match exactly. Feeding in particular
+// walks the cohorts in the Zoo's order, a withdrawal per cohort.
+//
+// Step allocates only when a game outgrows the room Reset made for it:
+// its cohort arrays and expiry heaps double as they fill up, and keep
+// their size through Compact and later Resets, so a game reallocates them
+// O(log n) times in its first episode and not at all in the ones after.
+// That includes AnimalCohorts's index by species and birth day, which is
+// a flat array per species rather than a node per cohort.
+class LockstepEngine {
+  public:
+    explicit LockstepEngine(std::size_t n_games);
+    LockstepEngine(const LockstepEngine &) = delete;
+    LockstepEngine &operator=(const LockstepEngine &) = delete;
+
+    std::size_t size() const { return balance_.size(); }
+
+    const unsigned char *dones() const { return dones_.data(); }
+    const double *observations() const { return observations_.data(); }
+    const double *rewards() const { return rewards_.data(); }
+
+    void Reset(const std::uint32_t *seeds);
+    void Step(const ZooEnvAction *actions);
+
+  private:
+    // What the engine needs to know about one species, taken from an
+    // animal of that species so that the numbers are exactly the ones a
+    // Game uses.
+    struct SpeciesTraits {
+      unsigned cost;
+      double food_cost_multiplier;
+      double adult_revenue;
+      double baby_revenue;
+      unsigned babies_per_birth;
+      unsigned lifespan;
+    };
+    std::array<SpeciesTraits, NUMBER_OF_SPECIES> traits_;
+
+    // Per-game state.
+    std::vector<double> balance_;
+    std::vector<double> base_food_cost_;
+    std::vector<unsigned> day_;
+    std::vector<unsigned char> dones_;
+    std::vector<std::mt19937> rng_engines_;
+    // animals_[s][i] is the number of animals of species s in game i.
+    std::array<std::vector<unsigned long>, NUMBER_OF_SPECIES> animals_;
+    std::array<std::vector<unsigned long>, NUMBER_OF_SPECIES> adults_;
+    std::array<std::vector<unsigned long>, NUMBER_OF_SPECIES> babies_;
+    std::vector<AnimalCohorts> cohorts_;
+    // The first cohorts that may still have to stop being babies and
+    // become adults; cohorts before them are done growing up.
+    std::vector<AnimalCohorts::size_type> next_weaned_;
+    std::vector<AnimalCohorts::size_type> next_grown_;
+    // For each game and species, its cohorts by birth day, oldest first;
+    // see Zoo::RemoveExpiredAnimals.
+    std::vector<std::array<CohortHeap, NUMBER_OF_SPECIES>> expiring_;
+
+    // The current day's draws and decisions.
+    std::vector<double> food_factor_;
+    std::vector<SpecialEventType> event_;
+    std::vector<Option<AnimalCohorts::size_type>> event_cohort_;
+    std::vector<double> bonus_revenue_;
+    // Whether the game was still being played at the start of the day.
+    std::vector<unsigned char> playing_;
+    std::vector<double> start_balance_;
+
+    std::vector<double> observations_;
+    std::vector<double> rewards_;
+
+    void AgeAnimals(std::size_t i);
+    void AddAnimals(std::size_t i, AnimalSpecies s, unsigned count,
+                    bool adult);
+    void BuyAnimals(std::size_t i, AnimalSpecies s, unsigned qty);
+    void ExpireAnimals(std::size_t i);
+    bool FeedNewAnimals(std::size_t i, AnimalSpecies s, unsigned count);
+    void HandleSpecialEvent(std::size_t i);
+    void Observe(std::size_t i);
+    void RemoveAnimal(std::size_t i, AnimalCohorts::size_type c);
+
+    // The passes over all games that make up a day, in order.
+    void DrawEvents(const ZooEnvAction *actions);
+    void FeedAnimals();
+    void HandleSpecialEvents();
+    void PlayMainActions(const ZooEnvAction *actions);
+    void GiveRevenue();
+    void DrawBaseFoodCosts();
+};
+
+
+#endif //ZOO_TYCOON_LOCKSTEPENGINE_H
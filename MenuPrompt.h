@@ -20,11 +20,18 @@
 #include "Option.h"
 #include "Utils.h"
 
+// Printed each time the user is expected to type in a menu option.
+static constexpr const char *MENU_PROMPT_INPUT_MSG = "Enter option: ";
+
 // MenuPrompt is a (kind of) generic interface for getting input from the
 // user. It takes a list of enum values, all of which must be of the same type,
 // and asks the user to select one of them by entering in a number.
 // The numbers are sequential, beginning from 1, increasing by one until
 // there are no more options.
+// A prompt can either block on std::cin (operator()), or be driven by
+// pushed input: Render() produces the menu text and Select()/Accepts()
+// check a line of input, or a value, against the rendered options. When
+// nobody will read the text, Prepare() readies the options without it.
 // There are two restrictions on T:
 //    1. T must implement the comparison operators.
 //    2. T must have an ActionString specialization, with a corresponding
@@ -52,15 +59,21 @@ class MenuPrompt {
     MenuPrompt(std::initializer_list<T> options);
 
     void AddOption(T option) { options_.push_back(option); }
-    void AddOptions(std::vector<T> options);
+    void AddOptions(const std::vector<T> &options);
     void OverrideStrings(ActionStringMap<T> overrides);
     void RemoveOption(T option);
+    void Reset(bool enable_cancel = false);
     void SetValidationFn(ValidationFn fn) { custom_validation_fn_ = fn; }
 
     Option<T> operator()(
         Option<std::string> prompt_msg = None,
         Option<std::string> fail_msg = None);
 
+    bool Accepts(const Option<T> &choice) const;
+    void Prepare();
+    std::string Render(Option<std::string> prompt_msg = None);
+    bool Select(const std::string &input, Option<T> &choice) const;
+
   private:
     std::vector<T> options_;
     // Overrides the default printed option text.
@@ -73,6 +86,8 @@ class MenuPrompt {
     void SortOptions();
     void EraseDuplicateOptions();
 
+    bool IsValidChoice(unsigned choice) const;
+
     const std::string &DefaultStringFor(T option) const;
     std::string OptionsAsString() const;
     const std::string &StringFor(T option) const;
@@ -99,7 +114,7 @@ MenuPrompt<T>::MenuPrompt(std::initializer_list<T> options) {
 ** Post-Conditions: None
 *********************************************************************/
 template <class T>
-void MenuPrompt<T>::AddOptions(std::vector<T> options) {
+void MenuPrompt<T>::AddOptions(const std::vector<T> &options) {
   for (const auto &o : options)
     AddOption(o);
 }
@@ -129,6 +144,22 @@ void MenuPrompt<T>::RemoveOption(T option) {
       std::remove(options_.begin(), options_.end(), option), options_.end());
 }
 
+/*********************************************************************
+** Function: Reset
+** Description: Empties the menu so that it can be filled in again,
+ * keeping the memory its options used.
+** Parameters: enable_cancel is whether the menu has a cancel option.
+** Pre-Conditions: None
+** Post-Conditions: The menu has no options, overrides or validation.
+*********************************************************************/
+template <class T>
+void MenuPrompt<T>::Reset(bool enable_cancel) {
+  options_.clear();
+  if (!override_map_.empty()) override_map_.clear();
+  enable_cancel_ = enable_cancel;
+  custom_validation_fn_ = None;
+}
+
 /*********************************************************************
 ** Function: SortOptions
 ** Description: Sorts the provided options from least to greatest, however
@@ -211,40 +242,116 @@ const std::string &MenuPrompt<T>::StringFor(T option) const {
 }
 
 /*********************************************************************
-** Function: operator()
-** Description: Overloads the function call operator; this prompts the
- * user with the given options and returns their choice.
-** Parameters: None
+** Function: IsValidChoice
+** Description: Returns whether the given option number is one the user
+ * may pick, i.e. it is in range (or 0 when cancelling is enabled) and the
+ * custom validation function, if any, accepts the matching option.
+** Parameters: choice is the option number entered by the user.
+** Pre-Conditions: Render or Prepare has been called.
+** Post-Conditions: None
+*********************************************************************/
+template <class T>
+bool MenuPrompt<T>::IsValidChoice(unsigned choice) const {
+  if (enable_cancel_ && choice == 0) return true;
+  bool in_range = choice > 0 && choice <= options_.size();
+  if (in_range && custom_validation_fn_.IsSome())
+    return custom_validation_fn_.CUnwrapRef()(options_[choice - 1]);
+  return in_range;
+}
+
+/*********************************************************************
+** Function: Accepts
+** Description: Returns whether the given value is a valid selection for
+ * this menu; None stands for the cancel option.
+** Parameters: choice is the value to check.
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
 template <class T>
-Option<T> MenuPrompt<T>::operator()(
-    Option<std::string> prompt_msg, Option<std::string> fail_msg) {
+bool MenuPrompt<T>::Accepts(const Option<T> &choice) const {
+  if (choice.IsNone()) return enable_cancel_;
+
+  auto it = std::find(options_.cbegin(), options_.cend(), choice.CUnwrapRef());
+  if (it == options_.cend()) return false;
+  return custom_validation_fn_.IsNone() ||
+         custom_validation_fn_.CUnwrapRef()(*it);
+}
+
+/*********************************************************************
+** Function: Prepare
+** Description: Puts the options in the order they are numbered in.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: The options are sorted and free of duplicates.
+*********************************************************************/
+template <class T>
+void MenuPrompt<T>::Prepare() {
   SortOptions();
   EraseDuplicateOptions();
+}
 
-  if (options_.empty()) return None;
+/*********************************************************************
+** Function: Render
+** Description: Prepares the options and returns the text shown to the
+ * user before they are asked to enter an option.
+** Parameters: prompt_msg is an optional message to show instead of the
+ * default one.
+** Pre-Conditions: None
+** Post-Conditions: The options are sorted and free of duplicates.
+*********************************************************************/
+template <class T>
+std::string MenuPrompt<T>::Render(Option<std::string> prompt_msg) {
+  Prepare();
 
+  std::string text;
   if (prompt_msg.IsSome())
-    std::cout << prompt_msg.CUnwrapRef() << "\n\n";
+    text = prompt_msg.CUnwrapRef() + "\n\n";
   else
-    std::cout << "\nChoose an option from below:\n\n";
+    text = "\nChoose an option from below:\n\n";
+
+  return text + OptionsAsString() + '\n';
+}
+
+/*********************************************************************
+** Function: Select
+** Description: Parses a line of user input into one of the options,
+ * returning whether the input was valid.
+** Parameters: input is the line entered by the user; choice is set to the
+ * selected option, or to None if the user cancelled.
+** Pre-Conditions: Render or Prepare has been called.
+** Post-Conditions: choice is only modified if the input was valid.
+*********************************************************************/
+template <class T>
+bool MenuPrompt<T>::Select(const std::string &input, Option<T> &choice) const {
+  std::istringstream iss(input);
+  unsigned n;
+  if (!StreamGetT(iss, n) || !IsValidChoice(n)) return false;
+
+  if (n == 0) choice = None;
+  else choice = options_[n - 1];
+  return true;
+}
+
+/*********************************************************************
+** Function: operator()
+** Description: Overloads the function call operator; this prompts the
+ * user with the given options and blocks on std::cin until they enter
+ * a valid choice, which is returned.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+template <class T>
+Option<T> MenuPrompt<T>::operator()(
+    Option<std::string> prompt_msg, Option<std::string> fail_msg) {
+  std::string text = Render(prompt_msg);
+  if (options_.empty()) return None;
 
-  std::string options_str = OptionsAsString();
-  std::cout << options_str << std::endl;
+  std::cout << text << std::flush;
 
-  auto max_opt = options_.size();
   unsigned choice = PromptUntilValid<unsigned>(
-      "Enter option: ",
-      [&](const unsigned &opt) {
-          if (enable_cancel_ && opt == 0) return true;
-          bool in_range = opt > 0 && opt <= max_opt;
-          if (custom_validation_fn_.IsSome())
-            return in_range &&
-                   custom_validation_fn_.CUnwrapRef()(options_[opt - 1]);
-          return in_range;
-      }
+      MENU_PROMPT_INPUT_MSG,
+      [&](const unsigned &opt) { return IsValidChoice(opt); }
   );
 
   if (!choice) return None;
@@ -0,0 +1,173 @@
+/*********************************************************************
+** Program Filename: MetricsSink.cpp
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Implements functions declared by the MetricsSink class.
+** Input: None
+** Output: None
+*********************************************************************/
+#include <algorithm>
+#include <cstring>
+#include "MetricsSink.h"
+
+// The longest CSV row Append can write.
+static constexpr std::size_t METRICS_MAX_CSV_ROW = 512;
+
+/*********************************************************************
+** Function: MetricsSink
+** Description: Constructor for the MetricsSink class; creates the file,
+ * writes its header and starts the sink's thread.
+** Parameters: path is the file to write; format is its format;
+ * buffer_bytes is the size of each of the two buffers.
+** Pre-Conditions: None
+** Post-Conditions: good() tells whether the file could be created.
+*********************************************************************/
+MetricsSink::MetricsSink(const std::string &path, MetricsFormat format,
+                         std::size_t buffer_bytes):
+    file_(std::fopen(path.c_str(), "wb")), format_(format),
+    capacity_(std::max(buffer_bytes, METRICS_MAX_CSV_ROW)) {
+  if (!file_) return;
+  // Only whole buffers are written, so the file's own buffer would just
+  // add a copy.
+  std::setvbuf(file_, nullptr, _IONBF, 0);
+
+  if (format_ == MetricsFormat::Binary) {
+    MetricsFileHeader header;
+    std::memcpy(header.magic, METRICS_FILE_MAGIC, sizeof(header.magic));
+    header.version = METRICS_FILE_VERSION;
+    header.byte_order = METRICS_FILE_BYTE_ORDER;
+    header.record_size = sizeof(DayMetrics);
+    header.n_species = NUMBER_OF_SPECIES;
+    std::fwrite(&header, sizeof(header), 1, file_);
+  } else {
+    std::string columns =
+        "day,balance,revenue,feeding_cost,base_food_cost,animals";
+    for (const char *kind : {"adults", "babies", "deaths"})
+      for (unsigned s = 0; s != NUMBER_OF_SPECIES; ++s)
+        columns += ',' + AnimalSpeciesToString(static_cast<AnimalSpecies>(s))
+                   + '_' + kind;
+    columns += '\n';
+    std::fwrite(columns.data(), 1, columns.size(), file_);
+  }
+
+  buffers_[0].reset(new char[capacity_]);
+  buffers_[1].reset(new char[capacity_]);
+  writer_ = std::thread(&MetricsSink::WriteLoop, this);
+}
+
+/*********************************************************************
+** Function: ~MetricsSink
+** Description: Destructor for the MetricsSink class; closes the sink.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+MetricsSink::~MetricsSink() {
+  Close();
+}
+
+/*********************************************************************
+** Function: Append
+** Description: Adds a day's row to the file.
+** Parameters: m is the day's metrics.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void MetricsSink::Append(const DayMetrics &m) {
+  if (!file_) return;
+
+  std::size_t row_size = format_ == MetricsFormat::Binary ?
+      sizeof(DayMetrics) : METRICS_MAX_CSV_ROW;
+  if (capacity_ - used_ < row_size) Submit();
+  char *out = buffers_[active_].get() + used_;
+
+  if (format_ == MetricsFormat::Binary) {
+    std::memcpy(out, &m, sizeof(m));
+    used_ += sizeof(m);
+    return;
+  }
+
+  int n = std::snprintf(out, METRICS_MAX_CSV_ROW, "%u,%.17g,%.17g,%.17g,"
+                        "%.17g,%llu", m.day, m.balance, m.revenue,
+                        m.feeding_cost, m.base_food_cost,
+                        static_cast<unsigned long long>(m.n_animals));
+  for (const std::uint64_t *counts : {m.adults, m.babies, m.deaths})
+    for (unsigned s = 0; s != NUMBER_OF_SPECIES; ++s)
+      n += std::snprintf(out + n, METRICS_MAX_CSV_ROW - n, ",%llu",
+                         static_cast<unsigned long long>(counts[s]));
+  out[n++] = '\n';
+  used_ += n;
+}
+
+/*********************************************************************
+** Function: Close
+** Description: Writes out what is buffered, stops the sink's thread and
+ * closes the file.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: Returns false if anything could not be written.
+ * Further rows are dropped.
+*********************************************************************/
+bool MetricsSink::Close() {
+  if (!file_) return !failed_;
+
+  if (used_) Submit();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closing_ = true;
+  }
+  cv_.notify_all();
+  writer_.join();
+
+  failed_ = std::fclose(file_) != 0 || failed_;
+  file_ = nullptr;
+  return !failed_;
+}
+
+/*********************************************************************
+** Function: Submit
+** Description: Hands the active buffer to the sink's thread, once it is
+ * done with the other one, and switches to the other one.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: The active buffer is empty.
+*********************************************************************/
+void MetricsSink::Submit() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [this] { return pending_ == 0; });
+  pending_ = used_;
+  pending_buffer_ = active_;
+  lock.unlock();
+  cv_.notify_all();
+
+  active_ ^= 1;
+  used_ = 0;
+}
+
+/*********************************************************************
+** Function: WriteLoop
+** Description: The sink's thread: writes out each buffer handed to it
+ * until the sink closes.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void MetricsSink::WriteLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    cv_.wait(lock, [this] { return pending_ != 0 || closing_; });
+    if (pending_ == 0) return;
+
+    // The game has moved on to the other buffer, so this one is ours
+    // until pending_ is cleared.
+    const char *data = buffers_[pending_buffer_].get();
+    std::size_t size = pending_;
+    lock.unlock();
+    bool ok = std::fwrite(data, 1, size, file_) == size;
+    lock.lock();
+
+    failed_ = failed_ || !ok;
+    pending_ = 0;
+    cv_.notify_all();
+  }
+}
@@ -0,0 +1,106 @@
+#ifndef ZOO_TYCOON_METRICSSINK_H
+#define ZOO_TYCOON_METRICSSINK_H
+/*********************************************************************
+** Program Filename: MetricsSink.h
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Declares the MetricsSink class, which streams a game's
+ * per-day metrics to a file, and the layout of that file.
+** Input: None
+** Output: None
+*********************************************************************/
+
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "AnimalSpecies.h"
+
+// A binary metrics file is a MetricsFileHeader followed by one DayMetrics
+// record per day, in the machine's own byte order (which the header
+// records). A CSV metrics file has a header row and then one row per day,
+// with the same fields, day first.
+static constexpr char METRICS_FILE_MAGIC[8] = {'Z', 'O', 'O', 'M', 'E', 'T',
+                                               'R', 'C'};
+static constexpr std::uint32_t METRICS_FILE_VERSION = 3;
+static constexpr std::uint32_t METRICS_FILE_BYTE_ORDER = 0x01020304;
+// Each of the sink's two buffers; a full one is written out by the sink's
+// thread while the game fills the other.
+static constexpr std::size_t DEFAULT_METRICS_BUFFER_BYTES = 1 << 20;
+
+struct MetricsFileHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint32_t record_size;
+  std::uint32_t n_species;
+};
+
+// The state of a game at the end of a day, and the day's money flows.
+struct DayMetrics {
+  double balance;
+  double revenue;
+  // Spent on food for the zoo, newborns and new purchases.
+  double feeding_cost;
+  double base_food_cost;
+  std::uint32_t day;
+  std::uint32_t reserved;
+  std::uint64_t n_animals;
+  // Indexed by SpeciesIndex.
+  std::uint64_t adults[NUMBER_OF_SPECIES];
+  std::uint64_t babies[NUMBER_OF_SPECIES];
+  // The animals that died of old age that day.
+  std::uint64_t deaths[NUMBER_OF_SPECIES];
+};
+
+enum class MetricsFormat {
+  Binary,
+  Csv
+};
+
+// Appending a day never allocates and only waits on the disk when both
+// buffers are full; the sink's own thread does the writing.
+class MetricsSink {
+  public:
+    MetricsSink(const std::string &path, MetricsFormat format,
+                std::size_t buffer_bytes = DEFAULT_METRICS_BUFFER_BYTES);
+    MetricsSink(const MetricsSink &) = delete;
+    MetricsSink &operator=(const MetricsSink &) = delete;
+    ~MetricsSink();
+
+    bool good() const { return file_ != nullptr; }
+
+    void Append(const DayMetrics &m);
+    bool Close();
+
+  private:
+    std::FILE *file_;
+    MetricsFormat format_;
+
+    std::unique_ptr<char[]> buffers_[2];
+    std::size_t capacity_;
+    // The buffer the game appends to, and how much of it is used.
+    unsigned active_ = 0;
+    std::size_t used_ = 0;
+
+    std::thread writer_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    // Guarded by mutex_: the bytes waiting to be written (0 if none) and
+    // the buffer they are in; whether the sink is closing; whether a write
+    // failed.
+    std::size_t pending_ = 0;
+    unsigned pending_buffer_ = 0;
+    bool closing_ = false;
+    bool failed_ = false;
+
+    void Submit();
+    void WriteLoop();
+};
+
+
+#endif //ZOO_TYCOON_METRICSSINK_H
@@ -8,6 +8,7 @@
 ** Output: None
 *********************************************************************/
 #include "Monkey.h"
+#include "AnimalSpecies.h"
 
 /*********************************************************************
 ** Function: Monkey
@@ -17,9 +18,13 @@
 ** Post-Conditions: None
 *********************************************************************/
 Monkey::Monkey(unsigned age):
-    Animal("Monkey", age, MONKEY_UNIT_COST,
+    Animal(AnimalSpecies::Monkey, "Monkey", age, MONKEY_UNIT_COST,
            MONKEY_BABIES_PER_BIRTH,
            MONKEY_FOOD_COST_MULTIPLIER,
+           MONKEY_DAILY_BIRTH_CHANCE,
+           MONKEY_DAILY_SICKNESS_CHANCE,
+           MONKEY_GESTATION_DAYS,
+           MONKEY_LIFESPAN,
            MONKEY_REVENUE_PCT) {}
 
 /*********************************************************************
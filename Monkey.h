@@ -15,6 +15,10 @@
 static constexpr unsigned MONKEY_UNIT_COST = 15000;
 static constexpr unsigned MONKEY_BABIES_PER_BIRTH = 1;
 static constexpr unsigned MONKEY_FOOD_COST_MULTIPLIER = 4;
+static constexpr double MONKEY_DAILY_BIRTH_CHANCE = 0.003;
+static constexpr double MONKEY_DAILY_SICKNESS_CHANCE = 0.002;
+static constexpr unsigned MONKEY_GESTATION_DAYS = 165;
+static constexpr unsigned MONKEY_LIFESPAN = 365 * 20;
 static constexpr double MONKEY_REVENUE_PCT = 0.10;
 
 class Monkey: public Animal {
@@ -0,0 +1,120 @@
+/*********************************************************************
+** Program Filename: OutputSink.cpp
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Implements functions declared in the OutputSink header.
+** Input: None
+** Output: None
+*********************************************************************/
+#include <cerrno>
+#include <iostream>
+#include <unistd.h>
+#include "OutputSink.h"
+
+/*********************************************************************
+** Function: TerminalSink
+** Description: Constructor for the TerminalSink class.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+TerminalSink::TerminalSink(): OutputSink(std::cout.rdbuf()) {}
+
+/*********************************************************************
+** Function: BufferedSink
+** Description: Constructor for the BufferedSink class.
+** Parameters: fd is the file descriptor to write to, which the sink does
+ * not own; buffer_bytes is the size of the buffer.
+** Pre-Conditions: buffer_bytes > 0
+** Post-Conditions: None
+*********************************************************************/
+BufferedSink::BufferedSink(int fd, std::size_t buffer_bytes):
+    OutputSink(nullptr), buffer_(fd, buffer_bytes) {
+  rdbuf(&buffer_);
+}
+
+/*********************************************************************
+** Function: ~BufferedSink
+** Description: Destructor for the BufferedSink class; writes out what is
+ * left in the buffer.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+BufferedSink::~BufferedSink() {
+  buffer_.Drain();
+}
+
+/*********************************************************************
+** Function: Drain
+** Description: Writes out everything in the buffer.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: Returns false if it could not all be written.
+*********************************************************************/
+bool BufferedSink::Drain() {
+  return buffer_.Drain();
+}
+
+/*********************************************************************
+** Function: Buffer
+** Description: Constructor for the BufferedSink::Buffer class.
+** Parameters: fd is the file descriptor to write to; buffer_bytes is the
+ * size of the buffer.
+** Pre-Conditions: buffer_bytes > 0
+** Post-Conditions: None
+*********************************************************************/
+BufferedSink::Buffer::Buffer(int fd, std::size_t buffer_bytes):
+    fd_(fd), data_(buffer_bytes) {
+  setp(data_.data(), data_.data() + data_.size());
+}
+
+/*********************************************************************
+** Function: Drain
+** Description: Writes out everything in the buffer and empties it.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: Returns false if it could not all be written; the
+ * buffer is emptied either way.
+*********************************************************************/
+bool BufferedSink::Buffer::Drain() {
+  const char *p = pbase();
+  std::size_t left = static_cast<std::size_t>(pptr() - pbase());
+  setp(data_.data(), data_.data() + data_.size());
+
+  while (left) {
+    ssize_t n = ::write(fd_, p, left);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    p += n;
+    left -= static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+/*********************************************************************
+** Function: overflow
+** Description: Called by the stream when the buffer is full; writes it
+ * out to make room for c.
+** Parameters: c is the character that did not fit, or EOF.
+** Pre-Conditions: None
+** Post-Conditions: Returns EOF if the buffer could not be written.
+*********************************************************************/
+BufferedSink::Buffer::int_type BufferedSink::Buffer::overflow(int_type c) {
+  if (!Drain()) return traits_type::eof();
+  if (traits_type::eq_int_type(c, traits_type::eof()))
+    return traits_type::not_eof(c);
+  return sputc(traits_type::to_char_type(c));
+}
+
+/*********************************************************************
+** Function: TerminalOutput
+** Description: Returns the sink games write to by default.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+OutputSink &TerminalOutput() {
+  static TerminalSink sink;
+  return sink;
+}
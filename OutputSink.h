@@ -0,0 +1,82 @@
+#ifndef ZOO_TYCOON_OUTPUTSINK_H
+#define ZOO_TYCOON_OUTPUTSINK_H
+/*********************************************************************
+** Program Filename: OutputSink.h
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Declares the OutputSink class, which the text a game shows
+ * the player is written to, and its terminal, buffered and null kinds.
+** Input: None
+** Output: None
+*********************************************************************/
+
+
+#include <cstddef>
+#include <ostream>
+#include <streambuf>
+#include <vector>
+
+static constexpr std::size_t DEFAULT_OUTPUT_BUFFER_BYTES = 1 << 16;
+
+// An OutputSink is a stream whose buffer decides where the game's text
+// ends up; one without a buffer throws the text away. The game checks
+// enabled() before building text (menus, listings, formatted messages),
+// so that nothing is formatted for a sink nobody reads. The buffer may be
+// swapped with rdbuf(), say to silence a game for a while.
+class OutputSink : public std::ostream {
+  public:
+    explicit OutputSink(std::streambuf *buf): std::ostream(buf) {}
+
+    bool enabled() const { return rdbuf() != nullptr; }
+};
+
+// Writes to std::cout, which the game flushes whenever it waits for input.
+class TerminalSink : public OutputSink {
+  public:
+    TerminalSink();
+};
+
+// Writes to a file descriptor (say, a pipe) through a large buffer, which
+// is only written out when it fills up, when Drain() is called or when the
+// sink is destroyed; the game's flushes at its prompts are ignored. Meant
+// for output nobody is waiting on line by line.
+class BufferedSink : public OutputSink {
+  public:
+    explicit BufferedSink(
+        int fd, std::size_t buffer_bytes = DEFAULT_OUTPUT_BUFFER_BYTES);
+    BufferedSink(const BufferedSink &) = delete;
+    BufferedSink &operator=(const BufferedSink &) = delete;
+    ~BufferedSink();
+
+    bool Drain();
+
+  private:
+    class Buffer : public std::streambuf {
+      public:
+        Buffer(int fd, std::size_t buffer_bytes);
+
+        bool Drain();
+
+      protected:
+        int_type overflow(int_type c) override;
+        int sync() override { return 0; }
+
+      private:
+        int fd_;
+        std::vector<char> data_;
+    };
+
+    Buffer buffer_;
+};
+
+// Throws everything away, without formatting it.
+class NullSink : public OutputSink {
+  public:
+    NullSink(): OutputSink(nullptr) {}
+};
+
+// The sink games write to unless they are given another.
+OutputSink &TerminalOutput();
+
+
+#endif //ZOO_TYCOON_OUTPUTSINK_H
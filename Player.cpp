@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cmath>
 #include <utility>
 #include "Animal.h"
 #include "Player.h"
@@ -23,13 +25,14 @@
 *********************************************************************/
 std::pair<bool, Option<CAnimalRef>>
 Player::BuyAnimal(AnimalSpecies s, bool adult) {
-  std::unique_ptr<Animal> animal = CreateFromSpecies(s, adult ? 365 * 3 : 0);
-  std::string desc = "Purchased a " + animal->name();
+  std::unique_ptr<Animal> animal =
+      CreateFromSpecies(s, adult ? ANIMAL_ADULT_AGE : 0);
+  std::string desc;
+  if (keeps_ledger()) desc = "Purchased a " + animal->name();
   if (!bank_account_.Withdraw(animal->cost(), desc))
     return std::make_pair(false, None);
 
-  CAnimalRef animal_ref = std::cref(*animal);
-  zoo_.AddAnimal(std::move(animal));
+  CAnimalRef animal_ref = zoo_.AddAnimal(std::move(animal));
 
   return std::make_pair(true, Option<CAnimalRef>(animal_ref));
 }
@@ -64,10 +67,47 @@ Player::BuyAnimals(AnimalSpecies s, unsigned qty, bool adults) {
 *********************************************************************/
 bool Player::CareForSickAnimal(const Animal &animal) {
   double care_cost = animal.SickCareCost();
-  std::string desc = "Care for sick " + animal.name();
+  std::string desc;
+  if (keeps_ledger()) desc = "Care for sick " + animal.name();
   return SpendMoney(care_cost, desc);
 }
 
+/*********************************************************************
+** Function: CareForSickAnimals
+** Description: Treats as many as the player can afford of count sick
+ * animals like the given one, with a single withdrawal.
+** Parameters: animal is a reference to one of the sick animals; count is
+ * the number of sick animals.
+** Pre-Conditions: None
+** Post-Conditions: Returns the number of animals treated.
+*********************************************************************/
+unsigned long Player::CareForSickAnimals(const Animal &animal,
+                                         unsigned long count) {
+  double care_cost = animal.SickCareCost();
+  unsigned long treated = CountAffordable(care_cost, count);
+  if (treated == 0) return 0;
+
+  std::string desc;
+  if (keeps_ledger())
+    desc = treated == 1 ? "Care for sick " + animal.name() :
+        "Care for " + std::to_string(treated) + " sick " + animal.name() + 's';
+  SpendMoney(care_cost * treated, desc);
+  return treated;
+}
+
+/*********************************************************************
+** Function: CountAffordable
+** Description: Returns how many of count things, costing unit_cost each,
+ * the player can afford.
+** Parameters: unit_cost is the cost of one; count is the number of them.
+** Pre-Conditions: unit_cost >= 0
+** Post-Conditions: None
+*********************************************************************/
+unsigned long Player::CountAffordable(double unit_cost,
+                                      unsigned long count) const {
+  return ::CountAffordable(MoneyRemaining(), unit_cost, count);
+}
+
 /*********************************************************************
 ** Function: FeedAnimal
 ** Description: Feeds the given animal.
@@ -80,13 +120,16 @@ bool Player::CareForSickAnimal(const Animal &animal) {
 bool Player::FeedAnimal(
     const Animal &animal, FoodType t, double base_food_cost) {
   double cost = animal.FoodCost(t, base_food_cost);
-  std::string desc = "Fed a " + animal.name();
+  std::string desc;
+  if (keeps_ledger()) desc = "Fed a " + animal.name();
   return SpendMoney(cost, desc);
 }
 
 /*********************************************************************
 ** Function: FeedAnimals
-** Description: Like FeedAnimal, but feeds all animals the player's zoo.
+** Description: Like FeedAnimal, but feeds all animals the player's zoo,
+ * a cohort at a time: each cohort's animals are paid for with a single
+ * withdrawal, and those the player cannot afford go hungry.
 ** Parameters: t is the type of food they should be fed; base_food_cost
  * is the base cost of food.
 ** Pre-Conditions: None
@@ -94,10 +137,50 @@ bool Player::FeedAnimal(
 *********************************************************************/
 bool Player::FeedAnimals(FoodType t, double base_cost) {
   if (!CanAfford(zoo_.FeedingCost(t, base_cost))) return false;
-  for (const auto &a : zoo_.Animals()) FeedAnimal(a, t, base_cost);
+  zoo_.ForEachCohort([&](const Animal &a, unsigned long count) {
+    FeedCohort(a, count, t, base_cost);
+  });
   return true;
 }
 
+/*********************************************************************
+** Function: FeedCohort
+** Description: Feeds as many as it can afford of count animals like the
+ * given one.
+** Parameters: animal is a reference to one of the animals; count is the
+ * number of animals; t is the type of food they should be fed;
+ * base_food_cost is the base cost of food.
+** Pre-Conditions: None
+** Post-Conditions: Returns the number of animals fed.
+*********************************************************************/
+unsigned long Player::FeedCohort(const Animal &animal, unsigned long count,
+                                 FoodType t, double base_food_cost) {
+  double cost = animal.FoodCost(t, base_food_cost);
+  unsigned long fed = CountAffordable(cost, count);
+  if (fed == 0) return 0;
+
+  std::string desc;
+  if (keeps_ledger())
+    desc = fed == 1 ? "Fed a " + animal.name() :
+        "Fed " + std::to_string(fed) + ' ' + animal.name() + 's';
+  SpendMoney(cost * fed, desc);
+  return fed;
+}
+
+/*********************************************************************
+** Function: RecordDeaths
+** Description: Records in the ledger that animals died of old age.
+** Parameters: s is their species; count is their number.
+** Pre-Conditions: count > 0
+** Post-Conditions: None
+*********************************************************************/
+void Player::RecordDeaths(AnimalSpecies s, unsigned long count) {
+  if (!keeps_ledger()) return;
+  std::string name = AnimalSpeciesToString(s);
+  bank_account_.Note(count == 1 ? "A " + name + " died of old age" :
+      std::to_string(count) + ' ' + name + "s died of old age");
+}
+
 /*********************************************************************
 ** Function: SpendMoney
 ** Description: Withdraws amount of money from the player's bank account,
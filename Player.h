@@ -22,12 +22,22 @@ class Player {
   public:
     Player():
         bank_account_(BankAccount(PLAYER_STARTING_BALANCE)), zoo_(Zoo()) {}
+    Player(BankAccount &&bank_account, Zoo &&zoo):
+        bank_account_(std::move(bank_account)), zoo_(std::move(zoo)) {}
 
+    const BankAccount &bank_account() const { return bank_account_; }
     Zoo &zoo() { return zoo_; }
+    const Zoo &zoo() const { return zoo_; }
 
     bool CanAfford(double amount) const {
       return bank_account_.CanAfford(amount); };
+    unsigned long CountAffordable(double unit_cost,
+                                  unsigned long count) const;
     double MoneyRemaining() const { return bank_account_.balance(); }
+    // Transactions are only described when there is a ledger to log them
+    // in; see BankAccount::keeps_ledger.
+    bool keeps_ledger() const { return bank_account_.keeps_ledger(); }
+    void set_keeps_ledger(bool on) { bank_account_.set_keeps_ledger(on); }
 
     void AddMoney(double amount, const std::string &desc) {
       bank_account_.Deposit(amount, desc); };
@@ -36,11 +46,17 @@ class Player {
     std::pair<bool, Option<std::vector<CAnimalRef>>>
         BuyAnimals(AnimalSpecies s, unsigned qty, bool adults = true);
     bool CareForSickAnimal(const Animal &animal);
+    unsigned long CareForSickAnimals(const Animal &animal,
+                                     unsigned long count);
     bool FeedAnimal(const Animal &animal, FoodType t, double base_food_cost);
     bool FeedAnimals(FoodType t, double base_cost);
+    unsigned long FeedCohort(const Animal &animal, unsigned long count,
+                             FoodType t, double base_food_cost);
+    void RecordDeaths(AnimalSpecies s, unsigned long count);
     bool SpendMoney(double amount, const std::string &desc);
 
-    void PrintBankAccountInformation() const { std::cout << bank_account_; }
+    void PrintBankAccountInformation(std::ostream &os) const {
+      os << bank_account_; }
 
   private:
     BankAccount bank_account_;
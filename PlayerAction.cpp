@@ -21,6 +21,16 @@ ActionString<PlayerMainAction>::Strings = {
   { PlayerMainAction::QuitGame, "Quit game." }
 };
 
+// Maps ZooListingAction values to a string.
+const ActionStringMap<ZooListingAction>
+ActionString<ZooListingAction>::Strings = {
+  { ZooListingAction::NextPage, "Show the next page." },
+  { ZooListingAction::PreviousPage, "Show the previous page." },
+  { ZooListingAction::FilterBySpecies,
+      "Only list one species, or list them all again." },
+  { ZooListingAction::Back, "Go back to the main menu." }
+};
+
 // Maps AnimalSpecies values to a string.
 const ActionStringMap<AnimalSpecies>
 ActionString<AnimalSpecies>::Strings = {
@@ -44,23 +54,43 @@ const ActionStringMap<unsigned> ActionString<unsigned>::Strings = {};
 
 /*********************************************************************
 ** Function: AllFoodOptions
-** Description: Returns a vector of all possible FoodType values.
+** Description: Returns a vector of all possible FoodType values, built
+ * once.
 ** Parameters: None
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
-std::vector<FoodType> AllFoodOptions() {
-  return ActionStringMapKeys(ActionString<FoodType>::Strings);
+const std::vector<FoodType> &AllFoodOptions() {
+  static const std::vector<FoodType> values =
+      ActionStringMapKeys(ActionString<FoodType>::Strings);
+  return values;
 }
 
 /*********************************************************************
 ** Function: AllMainActions
-** Description: Returns a vector of all PlayerMainAction values.
+** Description: Returns a vector of all PlayerMainAction values, built
+ * once.
 ** Parameters: None
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
-std::vector<PlayerMainAction> AllMainActions() {
-  return ActionStringMapKeys(ActionString<PlayerMainAction>::Strings);
+const std::vector<PlayerMainAction> &AllMainActions() {
+  static const std::vector<PlayerMainAction> values =
+      ActionStringMapKeys(ActionString<PlayerMainAction>::Strings);
+  return values;
 }
 
+
+/*********************************************************************
+** Function: AllListingActions
+** Description: Returns a vector of all ZooListingAction values, built
+ * once.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+const std::vector<ZooListingAction> &AllListingActions() {
+  static const std::vector<ZooListingAction> values =
+      ActionStringMapKeys(ActionString<ZooListingAction>::Strings);
+  return values;
+}
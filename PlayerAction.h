@@ -24,6 +24,15 @@ enum class PlayerMainAction {
   QuitGame
 };
 
+// What the player can do while paging through a long listing of their
+// animals.
+enum class ZooListingAction {
+  NextPage,
+  PreviousPage,
+  FilterBySpecies,
+  Back
+};
+
 // Specializations map T values to strings presentable to the user.
 template <class T>
 struct ActionString;
@@ -34,14 +43,16 @@ struct ActionString;
 template <> struct ActionString<T> { static const ActionStringMap<T> Strings; };
 
 ZT_SPECIALIZE_ACTION_STRING(PlayerMainAction);
+ZT_SPECIALIZE_ACTION_STRING(ZooListingAction);
 ZT_SPECIALIZE_ACTION_STRING(AnimalSpecies);
 ZT_SPECIALIZE_ACTION_STRING(FoodType);
 ZT_SPECIALIZE_ACTION_STRING(unsigned);
 
 #undef ZT_SPECIALIZE_ACTION_STRING
 
-std::vector<FoodType> AllFoodOptions();
-std::vector<PlayerMainAction> AllMainActions();
+const std::vector<FoodType> &AllFoodOptions();
+const std::vector<PlayerMainAction> &AllMainActions();
+const std::vector<ZooListingAction> &AllListingActions();
 
 
 #endif //ZOO_TYCOON_PLAYERACTION_H
@@ -0,0 +1,102 @@
+/*********************************************************************
+** Program Filename: PopulationEvents.cpp
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Implements functions declared by the PopulationEvents
+ * class.
+** Input: None
+** Output: None
+*********************************************************************/
+#include <algorithm>
+#include <functional>
+#include "AnimalSpecies.h"
+#include "PopulationEvents.h"
+#include "Trace.h"
+
+/*********************************************************************
+** Function: DrawCohortEvents
+** Description: Draws which of n animals an event befalls, each with its
+ * own chance, by geometric skip-ahead with max_chance and thinning.
+** Parameters: n is the number of animals; nth returns the k-th of them;
+ * chance returns an animal's chance; max_chance is at least as high as
+ * any animal's chance; rng_engine is the game's random engine.
+** Pre-Conditions: None
+** Post-Conditions: Returns the events, one per cohort, in order.
+*********************************************************************/
+template <class Nth, class Chance>
+static std::vector<CohortEvent> DrawCohortEvents(
+    AnimalsVec::size_type n, Nth nth, Chance chance, double max_chance,
+    std::mt19937 &rng_engine) {
+  std::vector<CohortEvent> events;
+  if (n == 0 || max_chance <= 0) return events;
+
+  // Every animal is a candidate when the chance is 1, which the
+  // geometric distribution does not allow for.
+  bool every_animal = max_chance >= 1;
+  std::geometric_distribution<AnimalsVec::size_type> gap(
+      every_animal ? 0.5 : max_chance);
+  std::uniform_real_distribution<double> keep(0.0, max_chance);
+  for (AnimalsVec::size_type k = 0;; ++k) {
+    AnimalsVec::size_type skip = every_animal ? 0 : gap(rng_engine);
+    if (skip >= n - k) break;
+    k += skip;
+
+    const Animal &a = nth(k);
+    if (keep(rng_engine) >= chance(a)) continue;
+    if (!events.empty() && &events.back().animal.get() == &a)
+      ++events.back().count;
+    else
+      events.push_back(CohortEvent{std::cref(a), 1});
+  }
+
+  return events;
+}
+
+/*********************************************************************
+** Function: PopulationEvents
+** Description: Constructor for the PopulationEvents class; draws the
+ * day's births, then its sicknesses.
+** Parameters: zoo is the zoo; t is the type of food the animals were fed
+ * today; rng_engine is the game's random engine.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+PopulationEvents::PopulationEvents(
+    const Zoo &zoo, FoodType t, std::mt19937 &rng_engine) {
+  ZT_TRACE_SCOPE("Draw population events", "animals",
+                 zoo.NumberOfAnimals());
+  double max_birth_chance = 0.0, max_sickness_chance = 0.0;
+  for (AnimalSpecies s : AllSpecies()) {
+    std::unique_ptr<Animal> a = CreateFromSpecies(s, ANIMAL_ADULT_AGE);
+    if (zoo.CountAnimalsAged(s, ANIMAL_ADULT_AGE, MAX_ANIMAL_AGE))
+      max_birth_chance = std::max(max_birth_chance, a->daily_birth_chance());
+    if (zoo.CountAnimalsAged(s, 0, MAX_ANIMAL_AGE))
+      max_sickness_chance =
+          std::max(max_sickness_chance, SicknessChance(*a, t));
+  }
+
+  births_ = DrawCohortEvents(
+      zoo.NumberOfAdultAnimals(),
+      [&](AnimalsVec::size_type k) { return zoo.NthAdultAnimal(k); },
+      [](const Animal &a) { return a.daily_birth_chance(); },
+      max_birth_chance, rng_engine);
+  sicknesses_ = DrawCohortEvents(
+      zoo.NumberOfAnimals(),
+      [&](AnimalsVec::size_type k) { return zoo.NthAnimal(k); },
+      [t](const Animal &a) { return SicknessChance(a, t); },
+      max_sickness_chance, rng_engine);
+}
+
+/*********************************************************************
+** Function: SicknessChance
+** Description: Returns the chance that an animal falls sick today.
+** Parameters: a is the animal; t is the type of food it was fed today.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+double PopulationEvents::SicknessChance(const Animal &a, FoodType t) {
+  double chance = a.daily_sickness_chance();
+  if (t == FoodType::Premium) chance /= 2;
+  else if (t == FoodType::Cheap) chance *= 2;
+  return std::min(chance, 1.0);
+}
@@ -0,0 +1,56 @@
+#ifndef ZOO_TYCOON_POPULATIONEVENTS_H
+#define ZOO_TYCOON_POPULATIONEVENTS_H
+/*********************************************************************
+** Program Filename: PopulationEvents.h
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Declares the PopulationEvents class and its related
+ * members.
+** Input: None
+** Output: None
+*********************************************************************/
+
+
+#include <random>
+#include <vector>
+#include "Animal.h"
+#include "FoodType.h"
+#include "Zoo.h"
+
+// Some of one cohort's animals, all alike, that an event befell.
+struct CohortEvent {
+  // The animal standing in for the cohort (see Zoo).
+  CAnimalRef animal;
+  unsigned long count;
+};
+
+// PopulationEvents are a day's sicknesses and births in a zoo where,
+// rather than one special event befalling one animal, every animal falls
+// sick with its species' daily sickness chance (halved by premium food and
+// doubled by cheap food, as in SpecialEvent::DrawEventType), and every
+// adult gives birth with its species' daily birth chance, independently.
+//
+// The animals that events befall are found by geometric skip-ahead over
+// the zoo's animals in order: the gap to the next candidate is drawn with
+// the highest chance of any species in the zoo, and a candidate is kept
+// with its own chance over that one. Finding a candidate is O(log n) (see
+// Zoo::NthAnimal), so a day costs in proportion to its number of events
+// rather than to the number of animals. Events befalling the same cohort
+// are counted together, in the order the cohorts were added.
+class PopulationEvents {
+  public:
+    PopulationEvents(const Zoo &zoo, FoodType t, std::mt19937 &rng_engine);
+
+    const std::vector<CohortEvent> &births() const { return births_; }
+    const std::vector<CohortEvent> &sicknesses() const
+        { return sicknesses_; }
+
+    static double SicknessChance(const Animal &a, FoodType t);
+
+  private:
+    std::vector<CohortEvent> births_;
+    std::vector<CohortEvent> sicknesses_;
+};
+
+
+#endif //ZOO_TYCOON_POPULATIONEVENTS_H
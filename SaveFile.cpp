@@ -0,0 +1,546 @@
+/*********************************************************************
+** Program Filename: SaveFile.cpp
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Implements the functions declared in the SaveFile header.
+** Input: None
+** Output: None
+*********************************************************************/
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "SaveFile.h"
+
+namespace {
+
+/*********************************************************************
+** Function: PaddedSize
+** Description: Rounds a section size up to a multiple of 8 bytes.
+** Parameters: size is the size in bytes.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+std::uint64_t PaddedSize(std::uint64_t size) {
+  return (size + 7) & ~static_cast<std::uint64_t>(7);
+}
+
+/*********************************************************************
+** Function: AppendSection
+** Description: Appends a section to the payload, padded to 8 bytes.
+** Parameters: payload is the payload being built; data and size describe
+ * the section.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void AppendSection(std::string &payload, const void *data, std::size_t size) {
+  payload.append(static_cast<const char *>(data), size);
+  payload.append(PaddedSize(size) - size, '\0');
+}
+
+/*********************************************************************
+** Function: HeaderChecksum
+** Description: Computes the checksum of a header, up to the checksum
+ * itself.
+** Parameters: header is the header.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+std::uint64_t HeaderChecksum(const SaveFileHeader &header) {
+  return Checksum64(&header, offsetof(SaveFileHeader, header_checksum));
+}
+
+// MappedFile maps a whole file into memory, read-only, for as long as it
+// lives.
+class MappedFile {
+  public:
+    explicit MappedFile(const std::string &path) {
+      int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+      if (fd == -1) return;
+
+      struct stat st;
+      if (fstat(fd, &st) != 0) {
+        // errno says why.
+      } else if (st.st_size == 0) {
+        errno = EINVAL;
+      } else {
+        void *p = mmap(nullptr, static_cast<std::size_t>(st.st_size),
+                       PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+          data_ = static_cast<const char *>(p);
+          size_ = static_cast<std::size_t>(st.st_size);
+        }
+      }
+      close(fd);
+    }
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    ~MappedFile() {
+      if (data_) munmap(const_cast<char *>(data_), size_);
+    }
+
+    const char *data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+  private:
+    const char *data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+/*********************************************************************
+** Function: CheckLayout
+** Description: Checks that the sections a header describes fill the file
+ * exactly, and finds where each one starts.
+** Parameters: header is the file's header; size is the file size;
+ * offsets receives the start of each of the six sections.
+** Pre-Conditions: None
+** Post-Conditions: Returns false if the sections do not fit.
+*********************************************************************/
+bool CheckLayout(const SaveFileHeader &header, std::uint64_t size,
+                 std::uint64_t offsets[6]) {
+  // Bounding every count by the file size first keeps the sums below from
+  // overflowing.
+  if (header.n_animal_runs > size || header.n_transactions > size ||
+      header.n_scheduled_events > size || header.n_descriptions >= size ||
+      header.description_bytes > size || header.rng_bytes > size)
+    return false;
+
+  std::uint64_t sizes[6] = {
+    header.n_animal_runs * sizeof(SavedAnimalRun),
+    header.n_transactions * sizeof(SavedTransaction),
+    header.n_scheduled_events * sizeof(SavedScheduledEvent),
+    (header.n_descriptions + 1) * sizeof(std::uint64_t),
+    header.description_bytes,
+    header.rng_bytes
+  };
+
+  std::uint64_t offset = sizeof(SaveFileHeader);
+  for (int i = 0; i != 6; ++i) {
+    offsets[i] = offset;
+    offset += PaddedSize(sizes[i]);
+  }
+
+  return offset == size;
+}
+
+// The parts of a mapped save file, checked and ready to use in place.
+struct SaveFileView {
+  SaveFileHeader header;
+  const SavedAnimalRun *animals;
+  const SavedTransaction *transactions;
+  const SavedScheduledEvent *scheduled_events;
+  std::vector<std::string> descriptions;
+  std::string rng_state;
+};
+
+/*********************************************************************
+** Function: ViewSaveFile
+** Description: Checks a mapped save file's header, layout and checksums,
+ * and finds its sections.
+** Parameters: file is the mapped file; view receives the sections; error
+ * receives a description of what went wrong, if anything.
+** Pre-Conditions: None
+** Post-Conditions: Returns false if the file is not a save file of this
+ * version, or is corrupt.
+*********************************************************************/
+bool ViewSaveFile(const MappedFile &file, SaveFileView &view,
+                  std::string &error) {
+  SaveFileHeader &header = view.header;
+  if (file.size() < sizeof(header)) {
+    error = "not a save file";
+    return false;
+  }
+  std::memcpy(&header, file.data(), sizeof(header));
+
+  if (std::memcmp(header.magic, SAVE_FILE_MAGIC, sizeof(header.magic)) != 0) {
+    error = "not a save file";
+    return false;
+  }
+  if (header.version != SAVE_FILE_VERSION ||
+      header.byte_order != SAVE_FILE_BYTE_ORDER) {
+    error = "saved by an incompatible version of the game";
+    return false;
+  }
+
+  std::uint64_t offsets[6];
+  if (header.header_checksum != HeaderChecksum(header) ||
+      header.file_size != file.size() ||
+      !CheckLayout(header, file.size(), offsets) ||
+      header.payload_checksum != Checksum64(file.data() + sizeof(header),
+                                            file.size() - sizeof(header))) {
+    error = "the save file is corrupt";
+    return false;
+  }
+
+  view.animals =
+      reinterpret_cast<const SavedAnimalRun *>(file.data() + offsets[0]);
+  view.transactions =
+      reinterpret_cast<const SavedTransaction *>(file.data() + offsets[1]);
+  view.scheduled_events = reinterpret_cast<const SavedScheduledEvent *>(
+      file.data() + offsets[2]);
+  const std::uint64_t *description_offsets =
+      reinterpret_cast<const std::uint64_t *>(file.data() + offsets[3]);
+  const char *description_text = file.data() + offsets[4];
+
+  view.descriptions.reserve(header.n_descriptions);
+  for (std::uint64_t i = 0; i != header.n_descriptions; ++i) {
+    std::uint64_t begin = description_offsets[i];
+    std::uint64_t end = description_offsets[i + 1];
+    if (begin > end || end > header.description_bytes) {
+      error = "the save file is corrupt";
+      return false;
+    }
+    view.descriptions.emplace_back(description_text + begin, end - begin);
+  }
+
+  view.rng_state.assign(file.data() + offsets[5], header.rng_bytes);
+  return true;
+}
+
+/*********************************************************************
+** Function: BuildGame
+** Description: Builds a game from its saved records, checking each one.
+** Parameters: image holds the game's scalars and descriptions (its
+ * record vectors are not used); animals and n_animal_runs,
+ * transactions and n_transactions, and events and n_events are the
+ * records; error receives a description of what went wrong, if anything.
+** Pre-Conditions: None
+** Post-Conditions: Returns None if a record is corrupt.
+*********************************************************************/
+Option<SavedGame> BuildGame(
+    const GameImage &image,
+    const SavedAnimalRun *animals, std::uint64_t n_animal_runs,
+    const SavedTransaction *transactions, std::uint64_t n_transactions,
+    const SavedScheduledEvent *events, std::uint64_t n_events,
+    std::string &error) {
+  error = "the save file is corrupt";
+
+  std::vector<BankAccountTransaction> ledger;
+  ledger.reserve(n_transactions);
+  for (std::uint64_t i = 0; i != n_transactions; ++i) {
+    const SavedTransaction &t = transactions[i];
+    if (t.description >= image.descriptions.size() ||
+        t.type > static_cast<std::uint32_t>(BankTransactionType::Note))
+      return None;
+    ledger.emplace_back(static_cast<BankTransactionType>(t.type),
+                        t.amount, image.descriptions[t.description]);
+  }
+
+  Zoo zoo;
+  for (std::uint64_t i = 0; i != n_animal_runs; ++i)
+    if (animals[i].species >= NUMBER_OF_SPECIES) return None;
+  zoo.Reserve(n_animal_runs);
+  for (std::uint64_t i = 0; i != n_animal_runs; ++i) {
+    AnimalSpecies s = static_cast<AnimalSpecies>(animals[i].species);
+    if (animals[i].count)
+      zoo.AddAnimal(CreateFromSpecies(s, animals[i].age), animals[i].count);
+  }
+
+  std::mt19937 rng_engine;
+  std::istringstream rng_is(image.rng_state);
+  rng_is >> rng_engine;
+  if (!rng_is ||
+      image.food_type > static_cast<std::uint32_t>(FoodType::Cheap) ||
+      image.population_events > 1)
+    return None;
+
+  GameState state(image.base_food_cost, rng_engine);
+  state.day = image.day;
+  state.food_type = static_cast<FoodType>(image.food_type);
+  state.rules.population_events = image.population_events != 0;
+  state.rules.event_weights = image.event_weights;
+  // A game is only saved between days, once the day's events have been
+  // taken, so every event left is due on a later day.
+  state.calendar.TakeDue(state.day);
+  for (std::uint64_t i = 0; i != n_events; ++i) {
+    const SavedScheduledEvent &e = events[i];
+    if (e.due_day <= state.day ||
+        e.type > static_cast<std::uint32_t>(ScheduledEventType::Birth) ||
+        e.species >= NUMBER_OF_SPECIES || e.count == 0)
+      return None;
+    state.calendar.Schedule(e.due_day, ScheduledEvent{
+        static_cast<ScheduledEventType>(e.type),
+        static_cast<AnimalSpecies>(e.species), e.count});
+  }
+
+  error.clear();
+  return SavedGame(
+      Player(BankAccount(image.balance, std::move(ledger)), std::move(zoo)),
+      state);
+}
+
+}
+
+/*********************************************************************
+** Function: AnimalRuns
+** Description: Describes a zoo's animals as runs of animals of the same
+ * species and age, in order.
+** Parameters: zoo is the zoo.
+** Pre-Conditions: None
+** Post-Conditions: No two neighbouring runs have the same species and
+ * age.
+*********************************************************************/
+std::vector<SavedAnimalRun> AnimalRuns(const Zoo &zoo) {
+  std::vector<SavedAnimalRun> runs;
+  zoo.ForEachCohort([&](const Animal &a, unsigned long count) {
+    std::uint32_t species = SpeciesIndex(a.species());
+    if (!runs.empty() && runs.back().species == species &&
+        runs.back().age == a.age()) {
+      runs.back().count += count;
+    } else {
+      runs.push_back(SavedAnimalRun{species, a.age(), count});
+    }
+  });
+
+  return runs;
+}
+
+/*********************************************************************
+** Function: ScheduledEvents
+** Description: Lists the events pending on a calendar, by day, then by
+ * species, type and count, so that a game saves the same way however
+ * its calendar happens to hold them.
+** Parameters: calendar is the calendar.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+std::vector<SavedScheduledEvent> ScheduledEvents(
+    const EventCalendar &calendar) {
+  std::vector<SavedScheduledEvent> events;
+  events.reserve(calendar.size());
+  calendar.ForEachPending([&](unsigned due_day, const ScheduledEvent &e) {
+    events.push_back(SavedScheduledEvent{
+        due_day, static_cast<std::uint32_t>(e.type),
+        SpeciesIndex(e.species), 0, e.count});
+  });
+
+  std::sort(events.begin(), events.end(),
+            [](const SavedScheduledEvent &a, const SavedScheduledEvent &b) {
+    if (a.due_day != b.due_day) return a.due_day < b.due_day;
+    if (a.species != b.species) return a.species < b.species;
+    if (a.type != b.type) return a.type < b.type;
+    return a.count < b.count;
+  });
+  return events;
+}
+
+/*********************************************************************
+** Function: GameFromImage
+** Description: Builds a game from an image.
+** Parameters: image is the image; error receives a description of what
+ * went wrong, if anything.
+** Pre-Conditions: None
+** Post-Conditions: Returns None if the image is corrupt.
+*********************************************************************/
+Option<SavedGame> GameFromImage(const GameImage &image, std::string &error) {
+  return BuildGame(image, image.animals.data(), image.animals.size(),
+                   image.transactions.data(), image.transactions.size(),
+                   image.scheduled_events.data(),
+                   image.scheduled_events.size(), error);
+}
+
+/*********************************************************************
+** Function: MakeGameImage
+** Description: Describes a game as a save file would.
+** Parameters: player and state are the game's player and state.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+GameImage MakeGameImage(const Player &player, const GameState &state) {
+  GameImage image;
+  image.balance = player.MoneyRemaining();
+  image.base_food_cost = state.base_food_cost;
+  image.day = state.day;
+  image.food_type = static_cast<std::uint32_t>(state.food_type);
+  image.population_events = state.rules.population_events;
+  image.event_weights = state.rules.event_weights;
+  image.animals = AnimalRuns(player.zoo());
+  image.scheduled_events = ScheduledEvents(state.calendar);
+
+  const Ledger &ledger = player.bank_account().transactions();
+  std::unordered_map<std::string, std::uint32_t> description_ids;
+  image.transactions.reserve(ledger.size());
+  for (const auto &t : ledger) {
+    auto it = description_ids.emplace(
+        t.description(), static_cast<std::uint32_t>(description_ids.size()));
+    if (it.second) image.descriptions.push_back(t.description());
+    image.transactions.push_back(SavedTransaction{
+        t.amount(), it.first->second, static_cast<std::uint32_t>(t.type())});
+  }
+
+  std::ostringstream rng_os;
+  rng_os << state.rng_engine;
+  image.rng_state = rng_os.str();
+
+  return image;
+}
+
+/*********************************************************************
+** Function: ReadGameImage
+** Description: Reads a save file into an image.
+** Parameters: path is the file to read; image receives the game; error
+ * receives a description of what went wrong, if anything; checksum, if
+ * given, receives the file's header checksum, which identifies it.
+** Pre-Conditions: None
+** Post-Conditions: Returns false if the file could not be read, is not a
+ * save file of this version, or is corrupt.
+*********************************************************************/
+bool ReadGameImage(const std::string &path, GameImage &image,
+                   std::string &error, std::uint64_t *checksum) {
+  MappedFile file(path);
+  if (!file.data()) {
+    error = std::strerror(errno);
+    return false;
+  }
+
+  SaveFileView view;
+  if (!ViewSaveFile(file, view, error)) return false;
+
+  const SaveFileHeader &header = view.header;
+  image.balance = header.balance;
+  image.base_food_cost = header.base_food_cost;
+  image.day = header.day;
+  image.food_type = header.food_type;
+  image.population_events = header.population_events;
+  image.event_weights = header.event_weights;
+  image.animals.assign(view.animals, view.animals + header.n_animal_runs);
+  image.transactions.assign(view.transactions,
+                            view.transactions + header.n_transactions);
+  image.scheduled_events.assign(
+      view.scheduled_events,
+      view.scheduled_events + header.n_scheduled_events);
+  image.descriptions = std::move(view.descriptions);
+  image.rng_state = std::move(view.rng_state);
+
+  if (checksum) *checksum = header.header_checksum;
+  return true;
+}
+
+/*********************************************************************
+** Function: WriteGameImage
+** Description: Writes an image to a save file. The file is written under
+ * a temporary name and then renamed, so an existing save is never left
+ * half-overwritten.
+** Parameters: path is the file to write; image is the game; checksum, if
+ * given, receives the file's header checksum, which identifies it.
+** Pre-Conditions: None
+** Post-Conditions: Returns false, with errno set, if the file could not
+ * be written.
+*********************************************************************/
+bool WriteGameImage(const std::string &path, const GameImage &image,
+                    std::uint64_t *checksum) {
+  std::vector<std::uint64_t> description_offsets(1, 0);
+  std::string descriptions;
+  for (const auto &d : image.descriptions) {
+    descriptions += d;
+    description_offsets.push_back(descriptions.size());
+  }
+
+  std::string payload;
+  AppendSection(payload, image.animals.data(),
+                image.animals.size() * sizeof(SavedAnimalRun));
+  AppendSection(payload, image.transactions.data(),
+                image.transactions.size() * sizeof(SavedTransaction));
+  AppendSection(payload, image.scheduled_events.data(),
+                image.scheduled_events.size() * sizeof(SavedScheduledEvent));
+  AppendSection(payload, description_offsets.data(),
+                description_offsets.size() * sizeof(std::uint64_t));
+  AppendSection(payload, descriptions.data(), descriptions.size());
+  AppendSection(payload, image.rng_state.data(), image.rng_state.size());
+
+  SaveFileHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, SAVE_FILE_MAGIC, sizeof(header.magic));
+  header.version = SAVE_FILE_VERSION;
+  header.byte_order = SAVE_FILE_BYTE_ORDER;
+  header.file_size = sizeof(header) + payload.size();
+  header.payload_checksum = Checksum64(payload.data(), payload.size());
+  header.balance = image.balance;
+  header.base_food_cost = image.base_food_cost;
+  header.day = image.day;
+  header.food_type = image.food_type;
+  header.population_events = image.population_events;
+  header.event_weights = image.event_weights;
+  header.n_animal_runs = image.animals.size();
+  header.n_transactions = image.transactions.size();
+  header.n_scheduled_events = image.scheduled_events.size();
+  header.n_descriptions = image.descriptions.size();
+  header.description_bytes = descriptions.size();
+  header.rng_bytes = image.rng_state.size();
+  header.header_checksum = HeaderChecksum(header);
+
+  std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+    out.flush();
+    if (!out) {
+      std::remove(tmp_path.c_str());
+      return false;
+    }
+  }
+
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) return false;
+  if (checksum) *checksum = header.header_checksum;
+  return true;
+}
+
+/*********************************************************************
+** Function: WriteSaveFile
+** Description: Saves a game to a file; see WriteGameImage.
+** Parameters: path is the file to write; player and state are the game's
+ * player and state.
+** Pre-Conditions: None
+** Post-Conditions: Returns false, with errno set, if the file could not
+ * be written.
+*********************************************************************/
+bool WriteSaveFile(
+    const std::string &path, const Player &player, const GameState &state) {
+  return WriteGameImage(path, MakeGameImage(player, state));
+}
+
+/*********************************************************************
+** Function: ReadSaveFile
+** Description: Loads a game from a save file. The file is mapped into
+ * memory and its records are used in place: the only per-animal work
+ * left is allocating the animals themselves.
+** Parameters: path is the file to read; error receives a description of
+ * what went wrong, if anything.
+** Pre-Conditions: None
+** Post-Conditions: Returns None if the file could not be read, is not a
+ * save file of this version, or is corrupt.
+*********************************************************************/
+Option<SavedGame> ReadSaveFile(const std::string &path, std::string &error) {
+  MappedFile file(path);
+  if (!file.data()) {
+    error = std::strerror(errno);
+    return None;
+  }
+
+  SaveFileView view;
+  if (!ViewSaveFile(file, view, error)) return None;
+
+  GameImage image;
+  image.balance = view.header.balance;
+  image.base_food_cost = view.header.base_food_cost;
+  image.day = view.header.day;
+  image.food_type = view.header.food_type;
+  image.population_events = view.header.population_events;
+  image.event_weights = view.header.event_weights;
+  image.descriptions = std::move(view.descriptions);
+  image.rng_state = std::move(view.rng_state);
+
+  return BuildGame(image, view.animals, view.header.n_animal_runs,
+                   view.transactions, view.header.n_transactions,
+                   view.scheduled_events, view.header.n_scheduled_events,
+                   error);
+}
@@ -0,0 +1,134 @@
+#ifndef ZOO_TYCOON_SAVEFILE_H
+#define ZOO_TYCOON_SAVEFILE_H
+/*********************************************************************
+** Program Filename: SaveFile.h
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Declares the functions that save a game to, and load a
+ * game from, a binary save file, and the layout of that file.
+** Input: None
+** Output: None
+*********************************************************************/
+
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "GameState.h"
+#include "Player.h"
+
+// A save file is a SaveFileHeader followed by these sections, each
+// starting on an 8-byte boundary:
+//   n_animal_runs SavedAnimalRun records (the zoo, in order)
+//   n_transactions SavedTransaction records (the ledger, in order)
+//   n_scheduled_events SavedScheduledEvent records (the events pending
+//     on the game's calendar, by day)
+//   n_descriptions + 1 uint64 offsets into the description text
+//   description_bytes bytes of description text
+//   rng_bytes bytes of the random engine's state, as written by
+//     operator<<
+// Numbers are stored in the machine's own byte order, which the header
+// records, so the loader can use the records where they lie in the
+// mapped file.
+static constexpr char SAVE_FILE_MAGIC[8] = {'Z', 'O', 'O', 'S', 'A', 'V', 'E',
+                                            '\0'};
+static constexpr std::uint32_t SAVE_FILE_VERSION = 5;
+static constexpr std::uint32_t SAVE_FILE_BYTE_ORDER = 0x01020304;
+
+struct SaveFileHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint64_t file_size;
+  // Checksum64 of everything after the header.
+  std::uint64_t payload_checksum;
+
+  double balance;
+  double base_food_cost;
+  std::uint32_t day;
+  std::uint32_t food_type;
+  // The game's GameRules.
+  std::uint32_t population_events;
+  std::uint32_t reserved;
+  std::uint64_t event_weights;
+
+  std::uint64_t n_animal_runs;
+  std::uint64_t n_transactions;
+  std::uint64_t n_scheduled_events;
+  std::uint64_t n_descriptions;
+  std::uint64_t description_bytes;
+  std::uint64_t rng_bytes;
+
+  // Checksum64 of the header up to this field.
+  std::uint64_t header_checksum;
+};
+
+// count animals of the same species and age, next to each other in the
+// zoo.
+struct SavedAnimalRun {
+  std::uint32_t species;
+  std::uint32_t age;
+  std::uint64_t count;
+};
+
+// Transaction descriptions repeat a lot ("Fed a Monkey"), so each one is
+// stored once and referred to by its index.
+struct SavedTransaction {
+  double amount;
+  std::uint32_t description;
+  std::uint32_t type;
+};
+
+// An event scheduled for a later day; see EventCalendar.
+struct SavedScheduledEvent {
+  std::uint32_t due_day;
+  std::uint32_t type;
+  std::uint32_t species;
+  std::uint32_t reserved;
+  std::uint64_t count;
+};
+
+// Everything needed to carry on with a saved game; see Game's
+// constructor.
+struct SavedGame {
+  SavedGame(Player &&player, const GameState &state):
+      player(std::move(player)), state(state) {}
+
+  Player player;
+  GameState state;
+};
+
+// A game in the form a save file holds it, without any Animal objects;
+// checkpoint deltas (see Checkpointer) are applied to one of these.
+struct GameImage {
+  double balance = 0.0;
+  double base_food_cost = 0.0;
+  std::uint32_t day = 0;
+  std::uint32_t food_type = 0;
+  std::uint32_t population_events = 0;
+  std::uint64_t event_weights = 0;
+
+  std::vector<SavedAnimalRun> animals;
+  std::vector<SavedTransaction> transactions;
+  std::vector<SavedScheduledEvent> scheduled_events;
+  std::vector<std::string> descriptions;
+  // The random engine's state, as written by operator<<.
+  std::string rng_state;
+};
+
+std::vector<SavedAnimalRun> AnimalRuns(const Zoo &zoo);
+std::vector<SavedScheduledEvent> ScheduledEvents(
+    const EventCalendar &calendar);
+Option<SavedGame> GameFromImage(const GameImage &image, std::string &error);
+GameImage MakeGameImage(const Player &player, const GameState &state);
+bool ReadGameImage(const std::string &path, GameImage &image,
+                   std::string &error, std::uint64_t *checksum = nullptr);
+bool WriteGameImage(const std::string &path, const GameImage &image,
+                    std::uint64_t *checksum = nullptr);
+
+bool WriteSaveFile(
+    const std::string &path, const Player &player, const GameState &state);
+Option<SavedGame> ReadSaveFile(const std::string &path, std::string &error);
+
+
+#endif //ZOO_TYCOON_SAVEFILE_H
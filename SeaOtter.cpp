@@ -8,6 +8,7 @@
 ** Output: None
 *********************************************************************/
 #include "SeaOtter.h"
+#include "AnimalSpecies.h"
 #include "Utils.h"
 
 /*********************************************************************
@@ -18,9 +19,14 @@
 ** Post-Conditions: None
 *********************************************************************/
 SeaOtter::SeaOtter(unsigned age):
-    Animal("Sea Otter", age, SEA_OTTER_UNIT_COST,
+    Animal(AnimalSpecies::SeaOtter, "Sea Otter", age,
+           SEA_OTTER_UNIT_COST,
            SEA_OTTER_BABIES_PER_BIRTH,
-           SEA_OTTER_FOOD_COST_MULTIPLIER) {}
+           SEA_OTTER_FOOD_COST_MULTIPLIER,
+           SEA_OTTER_DAILY_BIRTH_CHANCE,
+           SEA_OTTER_DAILY_SICKNESS_CHANCE,
+           SEA_OTTER_GESTATION_DAYS,
+           SEA_OTTER_LIFESPAN) {}
 
 /*********************************************************************
 ** Function: GiveBirth
@@ -15,6 +15,10 @@
 static constexpr unsigned SEA_OTTER_UNIT_COST = 5000;
 static constexpr unsigned SEA_OTTER_BABIES_PER_BIRTH = 2;
 static constexpr unsigned SEA_OTTER_FOOD_COST_MULTIPLIER = 2;
+static constexpr double SEA_OTTER_DAILY_BIRTH_CHANCE = 0.002;
+static constexpr double SEA_OTTER_DAILY_SICKNESS_CHANCE = 0.003;
+static constexpr unsigned SEA_OTTER_GESTATION_DAYS = 180;
+static constexpr unsigned SEA_OTTER_LIFESPAN = 365 * 15;
 
 class SeaOtter: public Animal {
   public:
@@ -0,0 +1,186 @@
+/*********************************************************************
+** Program Filename: ServerWorker.cpp
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Implements functions declared by the ServerWorker class.
+** Input: None
+** Output: None
+*********************************************************************/
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include "ServerWorker.h"
+
+/*********************************************************************
+** Function: ~ServerWorker
+** Description: Destructor for the ServerWorker class; closes every
+ * session and the worker's own descriptors.
+** Parameters: None
+** Pre-Conditions: The worker's thread has stopped.
+** Post-Conditions: None
+*********************************************************************/
+ServerWorker::~ServerWorker() {
+  sessions_.clear();
+  for (int fd : pending_fds_) close(fd);
+  if (wake_fd_ != -1) close(wake_fd_);
+  if (epoll_fd_ != -1) close(epoll_fd_);
+}
+
+/*********************************************************************
+** Function: AddConnection
+** Description: Hands a newly accepted connection to the worker; safe to
+ * call from any thread.
+** Parameters: fd is the connected, non-blocking client socket.
+** Pre-Conditions: Init has succeeded.
+** Post-Conditions: The worker starts a session for fd on its thread.
+*********************************************************************/
+void ServerWorker::AddConnection(int fd) {
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    pending_fds_.push_back(fd);
+  }
+
+  std::uint64_t one = 1;
+  ssize_t n = write(wake_fd_, &one, sizeof(one));
+  (void) n;
+}
+
+/*********************************************************************
+** Function: Init
+** Description: Creates the worker's epoll instance and wake-up eventfd.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: Returns false if either could not be created.
+*********************************************************************/
+bool ServerWorker::Init() {
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (epoll_fd_ == -1 || wake_fd_ == -1) return false;
+
+  epoll_event ev = {};
+  ev.events = EPOLLIN;
+  ev.data.fd = wake_fd_;
+  return epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev) == 0;
+}
+
+/*********************************************************************
+** Function: Run
+** Description: The worker's event loop; serves its sessions until running
+ * becomes false.
+** Parameters: running is cleared by the server when it is stopping.
+** Pre-Conditions: Init has succeeded.
+** Post-Conditions: None
+*********************************************************************/
+void ServerWorker::Run(const std::atomic<bool> &running) {
+  epoll_event events[SERVER_MAX_EPOLL_EVENTS];
+
+  while (running.load()) {
+    int n = epoll_wait(
+        epoll_fd_, events, SERVER_MAX_EPOLL_EVENTS, SERVER_POLL_TIMEOUT_MS);
+    if (n < 0 && errno != EINTR) break;
+
+    for (int i = 0; i < n; ++i) {
+      int fd = events[i].data.fd;
+
+      if (fd == wake_fd_) {
+        std::uint64_t count;
+        ssize_t r = read(wake_fd_, &count, sizeof(count));
+        (void) r;
+        StartPendingSessions();
+        continue;
+      }
+
+      auto it = sessions_.find(fd);
+      if (it != sessions_.end()) HandleEvent(*it->second, events[i].events);
+    }
+  }
+}
+
+/*********************************************************************
+** Function: CloseSession
+** Description: Ends the session on the given socket.
+** Parameters: fd is the session's socket.
+** Pre-Conditions: None
+** Post-Conditions: The socket is closed.
+*********************************************************************/
+void ServerWorker::CloseSession(int fd) {
+  epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+  interests_.erase(fd);
+  sessions_.erase(fd);
+  n_sessions_.store(sessions_.size());
+}
+
+/*********************************************************************
+** Function: HandleEvent
+** Description: Lets a session read and/or write, closing it on error,
+ * hang-up, or once its game is over.
+** Parameters: session is the ready session; events are the epoll events
+ * reported for it.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void ServerWorker::HandleEvent(GameSession &session, std::uint32_t events) {
+  bool alive = !(events & EPOLLERR);
+
+  if (alive && (events & (EPOLLIN | EPOLLHUP))) alive = session.OnReadable();
+  if (alive && session.WantsWrite()) alive = session.OnWritable();
+
+  if (!alive) CloseSession(session.fd());
+  else UpdateInterest(session);
+}
+
+/*********************************************************************
+** Function: StartPendingSessions
+** Description: Starts a session for every connection handed over by the
+ * acceptor since the last call.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void ServerWorker::StartPendingSessions() {
+  std::vector<int> fds;
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    fds.swap(pending_fds_);
+  }
+
+  for (int fd : fds) {
+    std::unique_ptr<GameSession> session = make_unique<GameSession>(fd);
+    session->Start();
+
+    epoll_event ev = {};
+    ev.events = EPOLLIN | EPOLLOUT;
+    ev.data.fd = fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) != 0) continue;
+
+    interests_[fd] = ev.events;
+    sessions_[fd] = std::move(session);
+  }
+
+  n_sessions_.store(sessions_.size());
+}
+
+/*********************************************************************
+** Function: UpdateInterest
+** Description: Registers the session for the events it currently wants,
+ * which is how backpressure works: a session whose output backlog is
+ * full stops being polled for input.
+** Parameters: session is the session to update.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void ServerWorker::UpdateInterest(GameSession &session) {
+  std::uint32_t wanted = 0;
+  if (session.WantsRead()) wanted |= EPOLLIN;
+  if (session.WantsWrite()) wanted |= EPOLLOUT;
+
+  std::uint32_t &current = interests_[session.fd()];
+  if (wanted == current) return;
+
+  epoll_event ev = {};
+  ev.events = wanted;
+  ev.data.fd = session.fd();
+  epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, session.fd(), &ev);
+  current = wanted;
+}
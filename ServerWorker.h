@@ -0,0 +1,64 @@
+#ifndef ZOO_TYCOON_SERVERWORKER_H
+#define ZOO_TYCOON_SERVERWORKER_H
+/*********************************************************************
+** Program Filename: ServerWorker.h
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Declares the ServerWorker class, one thread's share of
+ * the game server's sessions.
+** Input: None
+** Output: None
+*********************************************************************/
+
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "GameSession.h"
+
+// Most events handled per call to epoll_wait.
+static constexpr int SERVER_MAX_EPOLL_EVENTS = 256;
+// How often (ms) an idle worker checks whether the server is stopping.
+static constexpr int SERVER_POLL_TIMEOUT_MS = 200;
+
+// A ServerWorker multiplexes many GameSessions on one thread with its own
+// epoll instance. The acceptor thread hands it new connections through
+// AddConnection(); everything else happens on the worker's thread, so the
+// sessions themselves need no locking.
+class ServerWorker {
+  public:
+    ServerWorker() {}
+    ServerWorker(const ServerWorker &) = delete;
+    ServerWorker &operator=(const ServerWorker &) = delete;
+    ~ServerWorker();
+
+    std::size_t NumberOfSessions() const { return n_sessions_; }
+
+    void AddConnection(int fd);
+    bool Init();
+    void Run(const std::atomic<bool> &running);
+
+  private:
+    int epoll_fd_ = -1;
+    // eventfd used to wake the worker when connections are added.
+    int wake_fd_ = -1;
+
+    std::mutex pending_mutex_;
+    std::vector<int> pending_fds_;
+
+    std::unordered_map<int, std::unique_ptr<GameSession>> sessions_;
+    // The epoll events each session is currently registered for.
+    std::unordered_map<int, std::uint32_t> interests_;
+    std::atomic<std::size_t> n_sessions_{0};
+
+    void CloseSession(int fd);
+    void HandleEvent(GameSession &session, std::uint32_t events);
+    void StartPendingSessions();
+    void UpdateInterest(GameSession &session);
+};
+
+
+#endif //ZOO_TYCOON_SERVERWORKER_H
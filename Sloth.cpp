@@ -8,6 +8,7 @@
 ** Output: None
 *********************************************************************/
 #include "Sloth.h"
+#include "AnimalSpecies.h"
 #include "Utils.h"
 
 /*********************************************************************
@@ -18,9 +19,11 @@
 ** Post-Conditions: None
 *********************************************************************/
 Sloth::Sloth(unsigned age):
-    Animal("Sloth", age, SLOTH_UNIT_COST,
+    Animal(AnimalSpecies::Sloth, "Sloth", age, SLOTH_UNIT_COST,
            SLOTH_BABIES_PER_BIRTH,
-           SLOTH_FOOD_COST_MULTIPLIER) {}
+           SLOTH_FOOD_COST_MULTIPLIER, SLOTH_DAILY_BIRTH_CHANCE,
+           SLOTH_DAILY_SICKNESS_CHANCE, SLOTH_GESTATION_DAYS,
+           SLOTH_LIFESPAN) {}
 
 /*********************************************************************
 ** Function: GiveBirth
@@ -15,6 +15,10 @@
 static constexpr unsigned SLOTH_UNIT_COST = 2000;
 static constexpr unsigned SLOTH_BABIES_PER_BIRTH = 3;
 static constexpr unsigned SLOTH_FOOD_COST_MULTIPLIER = 1;
+static constexpr double SLOTH_DAILY_BIRTH_CHANCE = 0.001;
+static constexpr double SLOTH_DAILY_SICKNESS_CHANCE = 0.001;
+static constexpr unsigned SLOTH_GESTATION_DAYS = 300;
+static constexpr unsigned SLOTH_LIFESPAN = 365 * 25;
 
 class Sloth: public Animal {
   public:
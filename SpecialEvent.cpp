@@ -7,30 +7,122 @@
 ** Input: None
 ** Output: None
 *********************************************************************/
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include "AliasTable.h"
 #include "SpecialEvent.h"
 
+// Maps the event types to the names event weight files give them.
+const ActionStringMap<SpecialEventType> SpecialEventTypeToStringMap = {
+  { SpecialEventType::SickAnimal, "SickAnimal" },
+  { SpecialEventType::AnimalBirth, "AnimalBirth" },
+  { SpecialEventType::ZooAttendanceBoom, "ZooAttendanceBoom" },
+  { SpecialEventType::NoSpecialEvent, "NoSpecialEvent" }
+};
+
+// The event weights, and the tables DrawEventType draws from, indexed by
+// FoodType.
+struct EventTables {
+  SpecialEventWeights weights;
+  std::array<AliasTable, NUMBER_OF_FOOD_TYPES> by_food;
+};
+
+/*********************************************************************
+** Function: BiasedEventTable
+** Description: Builds the table events are drawn from on a day the
+ * animals are fed the given food. With p the SickAnimal event's share of
+ * the weights, cheap food makes its chance min(2p, 1) and premium food
+ * p / 2; the other events keep their weights relative to one another.
+** Parameters: weights are the event weights; t is the type of food.
+** Pre-Conditions: weights are valid (see SetEventWeights).
+** Post-Conditions: None
+*********************************************************************/
+static AliasTable BiasedEventTable(const SpecialEventWeights &weights,
+                                   FoodType t) {
+  std::vector<double> biased(weights.begin(), weights.end());
+  unsigned sick = static_cast<unsigned>(SpecialEventType::SickAnimal);
+  double others = 0.0;
+  for (unsigned i = 0; i != NUMBER_OF_SPECIAL_EVENT_TYPES; ++i)
+    if (i != sick) others += weights[i];
+  if (t == FoodType::Regular || others == 0.0) return AliasTable(biased);
+
+  double p = weights[sick] / (weights[sick] + others);
+  double biased_p = t == FoodType::Cheap ? std::min(2 * p, 1.0) : p / 2;
+  if (biased_p == 1.0) {
+    for (double &w : biased) w = 0.0;
+    biased[sick] = 1.0;
+  } else {
+    // Solve biased_p = w / (w + others) for the SickAnimal event's
+    // weight w.
+    biased[sick] = biased_p * others / (1.0 - biased_p);
+  }
+
+  return AliasTable(biased);
+}
+
+/*********************************************************************
+** Function: BuildEventTables
+** Description: Sets the event weights and builds a table per FoodType.
+** Parameters: tables receives the weights and tables; weights are the
+ * event weights.
+** Pre-Conditions: weights are valid (see SetEventWeights).
+** Post-Conditions: None
+*********************************************************************/
+static void BuildEventTables(EventTables &tables,
+                             const SpecialEventWeights &weights) {
+  tables.weights = weights;
+  for (unsigned t = 0; t != NUMBER_OF_FOOD_TYPES; ++t)
+    tables.by_food[t] =
+        BiasedEventTable(weights, static_cast<FoodType>(t));
+}
+
+/*********************************************************************
+** Function: CurrentEventTables
+** Description: Returns the event weights and tables every game draws
+ * from; they start out with every event equally likely.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+static EventTables &CurrentEventTables() {
+  static EventTables tables = [] {
+    EventTables t;
+    SpecialEventWeights equal;
+    equal.fill(1.0);
+    BuildEventTables(t, equal);
+    return t;
+  }();
+  return tables;
+}
+
 /*********************************************************************
 ** Function: SpecialEvent
 ** Description: Constructor for SpecialEvent class.
 ** Parameters: zoo is the game's main Zoo object; t is the event type
- * to use for this instantiation.
+ * to use for this instantiation; rng_engine is the game's random engine.
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
-SpecialEvent::SpecialEvent(const Zoo &zoo, SpecialEventType t):
-    zoo_(zoo), type_(t) {
+SpecialEvent::SpecialEvent(
+    const Zoo &zoo, SpecialEventType t, std::mt19937 &rng_engine):
+    rng_engine_(rng_engine), zoo_(zoo), type_(t) {
   SetValueBasedOnEvent();
 }
 
 /*********************************************************************
 ** Function: SpecialEvent
 ** Description: Constructor for the SpecialEvent class.
-** Parameters: zoo is the game's main Zoo object.
+** Parameters: zoo is the game's main Zoo object; rng_engine is the game's
+ * random engine.
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
-SpecialEvent::SpecialEvent(const Zoo &zoo):
-    zoo_(zoo), type_(RandomEventType()) {
+SpecialEvent::SpecialEvent(const Zoo &zoo, std::mt19937 &rng_engine):
+    rng_engine_(rng_engine), zoo_(zoo),
+    type_(DrawEventType(FoodType::Regular, rng_engine)) {
   SetValueBasedOnEvent();
 }
 
@@ -39,12 +131,13 @@ SpecialEvent::SpecialEvent(const Zoo &zoo):
 ** Description: Constructor for the SpecialEvent class.
 ** Parameters: zoo is the game's main Zoo object; t is the food type
  * being fed to animals, which is used to bias the probability of certain
- * events.
+ * events; rng_engine is the game's random engine.
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
-SpecialEvent::SpecialEvent(const Zoo &zoo, FoodType t):
-    zoo_(zoo), type_(BiasedEventTypeFromFood(t)) {
+SpecialEvent::SpecialEvent(
+    const Zoo &zoo, FoodType t, std::mt19937 &rng_engine):
+    rng_engine_(rng_engine), zoo_(zoo), type_(DrawEventType(t, rng_engine)) {
   SetValueBasedOnEvent();
 }
 
@@ -56,7 +149,7 @@ SpecialEvent::SpecialEvent(const Zoo &zoo, FoodType t):
 ** Post-Conditions: None
 *********************************************************************/
 SpecialEvent::SpecialEvent(const SpecialEvent &s):
-    zoo_(s.zoo_), type_(s.type_) {
+    rng_engine_(s.rng_engine_), zoo_(s.zoo_), type_(s.type_) {
   switch (s.type_) {
     case SpecialEventType::SickAnimal:
       new (&sick_animal_) Option<CAnimalRef>(s.sick_animal_);
@@ -76,15 +169,22 @@ SpecialEvent::SpecialEvent(const SpecialEvent &s):
 ** Post-Conditions: None
 *********************************************************************/
 SpecialEvent::~SpecialEvent() {
-  switch (type_) {
-    case SpecialEventType::SickAnimal:
-      sick_animal_.~Option();
-      break;
-    case SpecialEventType::AnimalBirth:
-      animal_birth_.~Option();
-      break;
-    default: break;
-  }
+  DestroyValue();
+}
+
+/*********************************************************************
+** Function: Redraw
+** Description: Draws a new event in place of this one, exactly as
+ * constructing a new SpecialEvent for the same zoo and random engine
+ * would, so that a turn can reuse one event from day to day.
+** Parameters: t is the type of food being fed to the zoo animals.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void SpecialEvent::Redraw(FoodType t) {
+  DestroyValue();
+  type_ = DrawEventType(t, rng_engine_);
+  SetValueBasedOnEvent();
 }
 
 /*********************************************************************
@@ -135,107 +235,150 @@ Option<CAnimalRef> SpecialEvent::sick_animal() const {
 }
 
 /*********************************************************************
-** Function: BiasedEventTypeFromFood
+** Function: DrawEventType
 ** Description: Selects a random event type based on the type of food
- * being fed to the animals. When the animals are fed cheap food, the
- * probability of the SickAnimal event doubles; when they are fed premium
- * food, that probability is halved.
-** Parameters: t is the type of food being fed to the zoo animals.
+ * being fed to the animals, in O(1) from a table built ahead of time (see
+ * BiasedEventTable): regular food draws with the event weights; cheap
+ * food doubles the chance of the SickAnimal event; premium food halves it.
+** Parameters: t is the type of food being fed to the zoo animals;
+ * rng_engine is the game's random engine.
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
-SpecialEventType SpecialEvent::BiasedEventTypeFromFood(FoodType t) {
-  double sickness_weight;
-  unsigned m = MAX_SPECIAL_EVENT_TYPE_INT;
-
-  if (t == FoodType::Premium)
-    // Solve (1/2)(1/(m+1)) = (w/(m+w)) for w, where m is one less than the
-    // number of possible events and w is the weight for the value
-    // corresponding to the SickAnimal event.
-    sickness_weight = static_cast<double>(m) / (2 * m + 1);
-  else if (t == FoodType::Cheap)
-    // Solve 2*(1/(m+1)) = (w/(m+w)) for w, where m and w are as above.
-    sickness_weight = static_cast<double>(2 * m) / (m - 1);
-  else
-    return RandomEventType();
-
-  unsigned index_for_sickness =
-      static_cast<unsigned>(SpecialEventType::SickAnimal);
-  std::vector<double> weights;
-  weights.reserve(MAX_SPECIAL_EVENT_TYPE_INT + 1);
-  for (decltype(weights.size()) i = 0;
-       i != (MAX_SPECIAL_EVENT_TYPE_INT + 1); ++i) {
-    if (i == index_for_sickness) weights.push_back(sickness_weight);
-    else weights.push_back(1.0);
-  }
-
-  std::discrete_distribution<unsigned> dis(weights.begin(), weights.end());
-  return static_cast<SpecialEventType>(dis(rng_engine_));
+SpecialEventType SpecialEvent::DrawEventType(
+    FoodType t, std::mt19937 &rng_engine) {
+  const AliasTable &table =
+      CurrentEventTables().by_food[static_cast<unsigned>(t)];
+  return static_cast<SpecialEventType>(table.Draw(rng_engine));
 }
 
 /*********************************************************************
-** Function: ChooseRandomAnimal
-** Description: Selects a random animal from the given vector.
-** Parameters: animals is the vector to choose from.
+** Function: DrawBonusRevenue
+** Description: Generates a random amount of bonus revenue for the attendance
+ * boom event.
+** Parameters: rng_engine is the game's random engine.
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
-Option<CAnimalRef> SpecialEvent::ChooseRandomAnimal(
-    std::vector<CAnimalRef> animals) {
-  using VecSizeT = std::vector<CAnimalRef>::size_type;
-  if (animals.empty()) return None;
-  std::uniform_int_distribution<VecSizeT> uni(0, animals.size() - 1);
-  return animals[uni(rng_engine_)];
+unsigned SpecialEvent::DrawBonusRevenue(std::mt19937 &rng_engine) {
+  std::uniform_int_distribution<unsigned> uni(
+      MIN_EXTRA_BONUS_REVENUE, MAX_EXTRA_BONUS_REVENUE);
+  return uni(rng_engine);
+}
+
+/*********************************************************************
+** Function: DrawIndex
+** Description: Picks a random index into a list of n animals.
+** Parameters: n is the length of the list; rng_engine is the game's
+ * random engine.
+** Pre-Conditions: n > 0.
+** Post-Conditions: None
+*********************************************************************/
+std::size_t SpecialEvent::DrawIndex(std::size_t n, std::mt19937 &rng_engine) {
+  std::uniform_int_distribution<std::size_t> uni(0, n - 1);
+  return uni(rng_engine);
 }
 
 /*********************************************************************
-** Function: RandomAdultAnimal
-** Description: Chooses a random adult animal from the zoo, provided one
- * exists.
+** Function: EventWeights
+** Description: Returns the weights DrawEventType draws event types with.
 ** Parameters: None
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
-Option<CAnimalRef> SpecialEvent::RandomAdultAnimal() {
-  std::vector<CAnimalRef> adult_animals = zoo_.AdultAnimals();
-  return ChooseRandomAnimal(adult_animals);
+const SpecialEventWeights &SpecialEvent::EventWeights() {
+  return CurrentEventTables().weights;
 }
 
 /*********************************************************************
-** Function: RandomBonusRevenue
-** Description: Generates a random amount of bonus revenue for the attendance
- * boom event.
+** Function: EventWeightsDigest
+** Description: Returns a digest of the weights DrawEventType draws event
+ * types with.
 ** Parameters: None
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
-unsigned SpecialEvent::RandomBonusRevenue() {
-  std::uniform_int_distribution<unsigned> uni(
-      MIN_EXTRA_BONUS_REVENUE, MAX_EXTRA_BONUS_REVENUE);
-  return uni(rng_engine_);
+std::uint64_t SpecialEvent::EventWeightsDigest() {
+  const SpecialEventWeights &weights = EventWeights();
+  return Checksum64(weights.data(), sizeof(weights));
 }
 
 /*********************************************************************
-** Function: RandomEventType
-** Description: Selects a random event type.
+** Function: SetEventWeights
+** Description: Sets the weights DrawEventType draws event types with,
+ * building its tables once rather than on every draw. An event with a
+ * weight of 0 never happens.
+** Parameters: weights are the new weights; error receives a description
+ * of what is wrong with them, if anything.
+** Pre-Conditions: No game is drawing events.
+** Post-Conditions: Returns false, leaving the weights alone, unless every
+ * weight is finite and non-negative and at least one is positive.
+*********************************************************************/
+bool SpecialEvent::SetEventWeights(const SpecialEventWeights &weights,
+                                   std::string &error) {
+  double total = 0.0;
+  for (double w : weights) {
+    if (!std::isfinite(w) || w < 0) {
+      error = "event weights must be finite and non-negative";
+      return false;
+    }
+    total += w;
+  }
+  if (!(total > 0) || !std::isfinite(total)) {
+    error = "some event must have a positive weight";
+    return false;
+  }
+
+  BuildEventTables(CurrentEventTables(), weights);
+  return true;
+}
+
+/*********************************************************************
+** Function: RandomAdultAnimal
+** Description: Chooses a random adult animal from the zoo, provided one
+ * exists; each cohort is chosen with a probability proportional to its
+ * number of adults.
 ** Parameters: None
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
-SpecialEventType SpecialEvent::RandomEventType() {
-  std::uniform_int_distribution<unsigned> uni(0, MAX_SPECIAL_EVENT_TYPE_INT);
-  return static_cast<SpecialEventType>(uni(rng_engine_));
+Option<CAnimalRef> SpecialEvent::RandomAdultAnimal() {
+  AnimalsVec::size_type n = zoo_.NumberOfAdultAnimals();
+  if (n == 0) return None;
+  return zoo_.NthAdultAnimal(DrawIndex(n, rng_engine_));
 }
 
 /*********************************************************************
 ** Function: RandomSickAnimal
-** Description: Chooses a random zoo animal to get sick.
+** Description: Chooses a random zoo animal to get sick, weighting the
+ * cohorts by their sizes like RandomAdultAnimal.
 ** Parameters: None
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
 Option<CAnimalRef> SpecialEvent::RandomSickAnimal() {
-  return ChooseRandomAnimal(zoo_.Animals());
+  AnimalsVec::size_type n = zoo_.NumberOfAnimals();
+  if (n == 0) return None;
+  return zoo_.NthAnimal(DrawIndex(n, rng_engine_));
+}
+
+/*********************************************************************
+** Function: DestroyValue
+** Description: Destroys the value that goes with the event's type.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: The value must be set again before it is used.
+*********************************************************************/
+void SpecialEvent::DestroyValue() {
+  switch (type_) {
+    case SpecialEventType::SickAnimal:
+      sick_animal_.~Option();
+      break;
+    case SpecialEventType::AnimalBirth:
+      animal_birth_.~Option();
+      break;
+    default: break;
+  }
 }
 
 /*********************************************************************
@@ -255,8 +398,62 @@ void SpecialEvent::SetValueBasedOnEvent() {
       new (&animal_birth_) Option<CAnimalRef>(RandomAdultAnimal());
       break;
     case SpecialEventType::ZooAttendanceBoom:
-      monkey_bonus_revenue_ = RandomBonusRevenue();
+      monkey_bonus_revenue_ = DrawBonusRevenue(rng_engine_);
       break;
     default: break;
   }
 }
+
+/*********************************************************************
+** Function: ReadSpecialEventWeights
+** Description: Reads event weights from a file with a line per event,
+ * "<event type> <weight>", event types being named as in
+ * SpecialEventTypeToStringMap; blank lines and lines starting with '#'
+ * are skipped. Events the file leaves out get a weight of 0, so that a
+ * file can pick which events happen at all.
+** Parameters: path is the file to read; weights receives the weights;
+ * error receives a description of what went wrong, if anything.
+** Pre-Conditions: None
+** Post-Conditions: Returns false if the file could not be read or a line
+ * is not a known, not yet given event type and a number.
+*********************************************************************/
+bool ReadSpecialEventWeights(const std::string &path,
+                             SpecialEventWeights &weights,
+                             std::string &error) {
+  std::ifstream in(path);
+  if (!in) {
+    error = std::strerror(errno);
+    return false;
+  }
+
+  weights.fill(0.0);
+  std::array<bool, NUMBER_OF_SPECIAL_EVENT_TYPES> given{};
+  unsigned line_number = 0;
+  for (std::string line; std::getline(in, line);) {
+    ++line_number;
+    std::istringstream line_is(line);
+    std::string name, rest;
+    double weight;
+    if (!(line_is >> name) || name[0] == '#') continue;
+
+    Option<SpecialEventType> type = None;
+    for (const auto &p : SpecialEventTypeToStringMap)
+      if (p.second == name) type = p.first;
+    if (type.IsNone() || !(line_is >> weight) || line_is >> rest) {
+      error = "line " + std::to_string(line_number) +
+              " is not an event type and its weight";
+      return false;
+    }
+
+    unsigned i = static_cast<unsigned>(type.Unwrap());
+    if (given[i]) {
+      error = "line " + std::to_string(line_number) + " gives " + name +
+              " a second weight";
+      return false;
+    }
+    given[i] = true;
+    weights[i] = weight;
+  }
+
+  return true;
+}
@@ -10,11 +10,15 @@
 *********************************************************************/
 
 
+#include <array>
+#include <string>
 #include "Utils.h"
 #include "Zoo.h"
 #include "FoodType.h"
 
 static constexpr unsigned MAX_SPECIAL_EVENT_TYPE_INT = 3;
+static constexpr unsigned NUMBER_OF_SPECIAL_EVENT_TYPES =
+    MAX_SPECIAL_EVENT_TYPE_INT + 1;
 static constexpr unsigned MIN_EXTRA_BONUS_REVENUE = 250;
 static constexpr unsigned MAX_EXTRA_BONUS_REVENUE = 500;
 
@@ -26,11 +30,16 @@ enum class SpecialEventType
     NoSpecialEvent
 };
 
+// The relative chances of the event types on a day the animals are fed
+// regular food, indexed by SpecialEventType; by default every event is
+// equally likely.
+using SpecialEventWeights = std::array<double, NUMBER_OF_SPECIAL_EVENT_TYPES>;
+
 class SpecialEvent {
   public:
-    SpecialEvent(const Zoo &zoo, SpecialEventType t);
-    explicit SpecialEvent(const Zoo &zoo);
-    SpecialEvent(const Zoo &zoo, FoodType t);
+    SpecialEvent(const Zoo &zoo, SpecialEventType t, std::mt19937 &rng_engine);
+    SpecialEvent(const Zoo &zoo, std::mt19937 &rng_engine);
+    SpecialEvent(const Zoo &zoo, FoodType t, std::mt19937 &rng_engine);
     SpecialEvent(const SpecialEvent &s);
 
     ~SpecialEvent();
@@ -42,9 +51,28 @@ class SpecialEvent {
     Option<CAnimalRef> sick_animal() const;
     SpecialEventType type() const { return type_; }
 
+    void Redraw(FoodType t);
+
+    // The random draws behind every event, in the order events make them;
+    // shared with engines that play the game without a Zoo (see
+    // LockstepEngine) so that both consume a seed identically.
+    static SpecialEventType DrawEventType(
+        FoodType t, std::mt19937 &rng_engine);
+    static unsigned DrawBonusRevenue(std::mt19937 &rng_engine);
+    static std::size_t DrawIndex(std::size_t n, std::mt19937 &rng_engine);
+
+    // The weights DrawEventType draws with; set them, if at all, before
+    // any game starts, since every game in the process shares them.
+    static const SpecialEventWeights &EventWeights();
+    // A digest of EventWeights(), which games record among their rules.
+    static std::uint64_t EventWeightsDigest();
+    static bool SetEventWeights(const SpecialEventWeights &weights,
+                                std::string &error);
+
 
   private:
-    std::mt19937 rng_engine_ = MakeRngEngine();
+    // Belongs to the game; see GameState.
+    std::mt19937 &rng_engine_;
 
     const Zoo &zoo_;
 
@@ -57,16 +85,18 @@ class SpecialEvent {
       Option<CAnimalRef> sick_animal_;
     };
 
-    SpecialEventType BiasedEventTypeFromFood(FoodType t);
-    Option<CAnimalRef> ChooseRandomAnimal(
-        std::vector<CAnimalRef> animals);
     Option<CAnimalRef> RandomAdultAnimal();
-    unsigned RandomBonusRevenue();
-    SpecialEventType RandomEventType();
     Option<CAnimalRef> RandomSickAnimal();
 
+    void DestroyValue();
     void SetValueBasedOnEvent();
 };
 
+extern const ActionStringMap<SpecialEventType> SpecialEventTypeToStringMap;
+
+bool ReadSpecialEventWeights(const std::string &path,
+                             SpecialEventWeights &weights,
+                             std::string &error);
+
 
 #endif //ZOO_TYCOON_SPECIALEVENT_H
@@ -0,0 +1,211 @@
+/*********************************************************************
+** Program Filename: Trace.cpp
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Implements functions declared in the Trace header.
+** Input: None
+** Output: None
+*********************************************************************/
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Trace.h"
+
+static constexpr std::size_t TRACE_CHUNK_EVENTS = 4096;
+
+// One recorded event; dur_ns is -1 for instant events.
+struct TraceEvent {
+  const char *name;
+  const char *arg_name;
+  std::int64_t arg;
+  std::int64_t ts_ns;
+  std::int64_t dur_ns;
+};
+
+// The events one thread recorded, in chunks so that recording never moves
+// them.
+struct TraceBuffer {
+  unsigned tid;
+  std::vector<std::unique_ptr<TraceEvent[]>> chunks;
+  std::size_t size = 0;
+  std::size_t dropped = 0;
+};
+
+static std::atomic<bool> tracing(false);
+static std::atomic<unsigned> trace_every_days(DEFAULT_TRACE_EVERY_DAYS);
+static std::atomic<std::int64_t> trace_start_ns(0);
+
+// Only taken when a thread records its first event, and to write the
+// trace.
+static std::mutex buffers_mutex;
+static std::vector<std::unique_ptr<TraceBuffer>> buffers;
+
+static thread_local TraceBuffer *thread_buffer = nullptr;
+static thread_local bool day_sampled = false;
+
+/*********************************************************************
+** Function: NowNs
+** Description: Returns the time on the steady clock, in ns.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+static std::int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*********************************************************************
+** Function: Record
+** Description: Appends an event to the calling thread's buffer, making
+ * the buffer first if need be.
+** Parameters: event is the event.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+static void Record(const TraceEvent &event) {
+  if (!thread_buffer) {
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    buffers.emplace_back(new TraceBuffer);
+    thread_buffer = buffers.back().get();
+    thread_buffer->tid = static_cast<unsigned>(buffers.size());
+  }
+
+  TraceBuffer &b = *thread_buffer;
+  if (b.size == TRACE_MAX_EVENTS_PER_THREAD) {
+    ++b.dropped;
+    return;
+  }
+  if (b.size % TRACE_CHUNK_EVENTS == 0)
+    b.chunks.emplace_back(new TraceEvent[TRACE_CHUNK_EVENTS]);
+  b.chunks.back()[b.size % TRACE_CHUNK_EVENTS] = event;
+  ++b.size;
+}
+
+/*********************************************************************
+** Function: StartTracing
+** Description: Starts recording events.
+** Parameters: every_days is how often a day is sampled; 1 samples them
+ * all.
+** Pre-Conditions: every_days > 0
+** Post-Conditions: Days are sampled from the next SetTraceDay on.
+*********************************************************************/
+void StartTracing(unsigned every_days) {
+  trace_every_days = every_days;
+  trace_start_ns = NowNs();
+  tracing = true;
+}
+
+/*********************************************************************
+** Function: StopTracing
+** Description: Stops recording events.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: Days are no longer sampled from the next SetTraceDay
+ * on.
+*********************************************************************/
+void StopTracing() {
+  tracing = false;
+}
+
+/*********************************************************************
+** Function: SetTraceDay
+** Description: Tells the recorder which day the calling thread is
+ * playing, deciding whether its events are recorded.
+** Parameters: day is the day.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void SetTraceDay(unsigned day) {
+  day_sampled = tracing && day % trace_every_days == 0;
+}
+
+/*********************************************************************
+** Function: TraceInstant
+** Description: Records an event without a duration, if the current day
+ * is sampled.
+** Parameters: name names the event; arg_name, if not null, names a value
+ * recorded with it; arg is the value.
+** Pre-Conditions: name and arg_name outlive the trace.
+** Post-Conditions: None
+*********************************************************************/
+void TraceInstant(const char *name, const char *arg_name, std::int64_t arg) {
+  if (day_sampled) Record(TraceEvent{name, arg_name, arg, NowNs(), -1});
+}
+
+/*********************************************************************
+** Function: ScopedTrace
+** Description: Constructor for the ScopedTrace class; starts the event.
+** Parameters: name names the event; arg_name, if not null, names a value
+ * recorded with it; arg is the value.
+** Pre-Conditions: name and arg_name outlive the trace.
+** Post-Conditions: None
+*********************************************************************/
+ScopedTrace::ScopedTrace(const char *name, const char *arg_name,
+                         std::int64_t arg):
+    name_(name), arg_name_(arg_name), arg_(arg),
+    start_ns_(day_sampled ? NowNs() : -1) {}
+
+/*********************************************************************
+** Function: ~ScopedTrace
+** Description: Destructor for the ScopedTrace class; records the event.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+ScopedTrace::~ScopedTrace() {
+  if (start_ns_ < 0) return;
+  Record(TraceEvent{name_, arg_name_, arg_, start_ns_, NowNs() - start_ns_});
+}
+
+/*********************************************************************
+** Function: WriteChromeTrace
+** Description: Writes every event recorded so far as a Chrome trace:
+ * duration events as complete ("X") events, the rest as instant ones,
+ * with each thread's buffer as its own track.
+** Parameters: path is the file to write.
+** Pre-Conditions: No other thread is recording (say, they have finished,
+ * or tracing has stopped and they have moved on to another day).
+** Post-Conditions: Returns false if the file could not be written.
+*********************************************************************/
+bool WriteChromeTrace(const std::string &path) {
+  std::FILE *f = std::fopen(path.c_str(), "w");
+  if (!f) return false;
+
+  std::lock_guard<std::mutex> lock(buffers_mutex);
+  std::int64_t start = trace_start_ns;
+  std::size_t dropped = 0;
+  const char *separator = "\n";
+  std::fprintf(f, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [");
+  for (const auto &b : buffers) {
+    std::fprintf(f, "%s{\"name\": \"thread_name\", \"ph\": \"M\", "
+                 "\"pid\": 1, \"tid\": %u, \"args\": {\"name\": "
+                 "\"thread %u\"}}", separator, b->tid, b->tid);
+    separator = ",\n";
+    dropped += b->dropped;
+
+    for (std::size_t i = 0; i != b->size; ++i) {
+      const TraceEvent &e =
+          b->chunks[i / TRACE_CHUNK_EVENTS][i % TRACE_CHUNK_EVENTS];
+      std::fprintf(f, ",\n{\"name\": \"%s\", \"cat\": \"zoo\", \"pid\": 1, "
+                   "\"tid\": %u, \"ts\": %.3f", e.name, b->tid,
+                   (e.ts_ns - start) / 1e3);
+      if (e.dur_ns >= 0)
+        std::fprintf(f, ", \"ph\": \"X\", \"dur\": %.3f", e.dur_ns / 1e3);
+      else
+        std::fprintf(f, ", \"ph\": \"i\", \"s\": \"t\"");
+      if (e.arg_name)
+        std::fprintf(f, ", \"args\": {\"%s\": %lld}", e.arg_name,
+                     static_cast<long long>(e.arg));
+      std::fprintf(f, "}");
+    }
+  }
+  std::fprintf(f, "\n], \"otherData\": {\"dropped_events\": %zu}}\n",
+               dropped);
+
+  bool ok = !std::ferror(f);
+  return std::fclose(f) == 0 && ok;
+}
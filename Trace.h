@@ -0,0 +1,60 @@
+#ifndef ZOO_TYCOON_TRACE_H
+#define ZOO_TYCOON_TRACE_H
+/*********************************************************************
+** Program Filename: Trace.h
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Declares the trace recorder, which collects timed events
+ * from games as they play and writes them out as a Chrome trace (for
+ * Perfetto or about:tracing).
+** Input: None
+** Output: None
+*********************************************************************/
+
+
+#include <cstdint>
+#include <string>
+
+static constexpr unsigned DEFAULT_TRACE_EVERY_DAYS = 1;
+// About 200 MB of events per thread; later events are dropped.
+static constexpr std::size_t TRACE_MAX_EVENTS_PER_THREAD = 1 << 22;
+
+// Tracing is off until StartTracing. While it is on, only the days
+// SetTraceDay samples are recorded: every every_days-th day of every game,
+// so that tracing a long run can cost as little as needed. Each thread
+// records into a buffer of its own, without locking; the buffers are kept
+// after their threads exit, until the trace is written.
+void StartTracing(unsigned every_days = DEFAULT_TRACE_EVERY_DAYS);
+void StopTracing();
+bool WriteChromeTrace(const std::string &path);
+
+void SetTraceDay(unsigned day);
+void TraceInstant(const char *name, const char *arg_name = nullptr,
+                  std::int64_t arg = 0);
+
+// Records an event lasting from its construction to its destruction, if
+// the current day is sampled; used through ZT_TRACE_SCOPE. name and
+// arg_name must be string literals (or otherwise outlive the trace).
+class ScopedTrace {
+  public:
+    explicit ScopedTrace(const char *name, const char *arg_name = nullptr,
+                         std::int64_t arg = 0);
+    ScopedTrace(const ScopedTrace &) = delete;
+    ScopedTrace &operator=(const ScopedTrace &) = delete;
+    ~ScopedTrace();
+
+  private:
+    const char *name_;
+    const char *arg_name_;
+    std::int64_t arg_;
+    // When the event began, in ns, or -1 if it is not recorded.
+    std::int64_t start_ns_;
+};
+
+#define ZT_TRACE_CONCAT_(a, b) a##b
+#define ZT_TRACE_CONCAT(a, b) ZT_TRACE_CONCAT_(a, b)
+#define ZT_TRACE_SCOPE(...) \
+    ScopedTrace ZT_TRACE_CONCAT(zt_trace_scope_, __LINE__)(__VA_ARGS__)
+
+
+#endif //ZOO_TYCOON_TRACE_H
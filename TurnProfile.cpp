@@ -0,0 +1,169 @@
+/*********************************************************************
+** Program Filename: TurnProfile.cpp
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Implements functions declared in the TurnProfile header.
+** Input: None
+** Output: None
+*********************************************************************/
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include "TurnProfile.h"
+
+static const char *const PROFILE_PHASE_NAMES[NUMBER_OF_PROFILE_PHASES] = {
+  "aging", "feeding", "special event", "action", "revenue", "rendering",
+  "saving", "other"
+};
+
+// Each thread profiles the turns it plays on its own, so measuring never
+// needs a lock; these are plain data, so using them never allocates.
+static thread_local TurnProfile profile;
+// The phase being timed, as an index, or -1; and when it was last entered
+// or resumed, in ns.
+static thread_local int current_phase = -1;
+static thread_local std::int64_t phase_start_ns;
+
+#ifdef ZOO_PROFILE
+void *operator new(std::size_t size) {
+  ++profile.allocations;
+  profile.allocated_bytes += size;
+  if (void *p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+  std::free(p);
+}
+#endif
+
+/*********************************************************************
+** Function: NowNs
+** Description: Returns the time on the steady clock, in ns.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+static std::int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*********************************************************************
+** Function: TotalNs
+** Description: Returns the time spent in all phases.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+std::uint64_t TurnProfile::TotalNs() const {
+  std::uint64_t total = 0;
+  for (std::uint64_t ns : phase_ns)
+    total += ns;
+  return total;
+}
+
+/*********************************************************************
+** Function: operator<<
+** Description: Prints a profile as a table of phases and its counters.
+** Parameters: os is the stream to print to; p is the profile.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+std::ostream &operator<<(std::ostream &os, const TurnProfile &p) {
+  if (!TURN_PROFILE_ENABLED)
+    return os << "Turn profiling is off; build with make PROFILE=1.\n";
+
+  char line[96];
+  std::uint64_t total = p.TotalNs();
+  std::snprintf(line, sizeof(line), "%-14s %12s %6s %10s %12s\n", "phase",
+                "ms", "%", "calls", "ns/turn");
+  os << line;
+  for (unsigned i = 0; i != NUMBER_OF_PROFILE_PHASES; ++i) {
+    std::snprintf(line, sizeof(line), "%-14s %12.3f %6.1f %10llu %12.0f\n",
+                  PROFILE_PHASE_NAMES[i], p.phase_ns[i] / 1e6,
+                  total ? 100.0 * p.phase_ns[i] / total : 0.0,
+                  static_cast<unsigned long long>(p.phase_calls[i]),
+                  p.turns ? static_cast<double>(p.phase_ns[i]) / p.turns :
+                            0.0);
+    os << line;
+  }
+  std::snprintf(line, sizeof(line), "%-14s %12.3f %6.1f %10s %12.0f\n",
+                "total", total / 1e6, 100.0, "",
+                p.turns ? static_cast<double>(total) / p.turns : 0.0);
+  os << line;
+
+  return os << "Turns: " << p.turns
+            << "\nAnimals processed: " << p.animals_processed
+            << "\nTransactions logged: " << p.transactions_logged
+            << "\nAllocations: " << p.allocations << " ("
+            << p.allocated_bytes << " bytes)\n";
+}
+
+/*********************************************************************
+** Function: CurrentTurnProfile
+** Description: Returns the profile of the turns played on the calling
+ * thread since it started or last called ResetTurnProfile.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+const TurnProfile &CurrentTurnProfile() {
+  return profile;
+}
+
+/*********************************************************************
+** Function: ResetTurnProfile
+** Description: Zeroes the calling thread's profile.
+** Parameters: None
+** Pre-Conditions: No phase is being timed on the thread.
+** Post-Conditions: None
+*********************************************************************/
+void ResetTurnProfile() {
+  profile = TurnProfile();
+}
+
+/*********************************************************************
+** Function: CountTurnProfile
+** Description: Adds to one of the calling thread's profile's counters.
+** Parameters: counter is the counter; n is the amount to add.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void CountTurnProfile(std::uint64_t TurnProfile::*counter, std::uint64_t n) {
+  profile.*counter += n;
+}
+
+/*********************************************************************
+** Function: ScopedProfilePhase
+** Description: Constructor for the ScopedProfilePhase class; pauses the
+ * phase being timed, if any, and starts timing the given one.
+** Parameters: phase is the phase to time.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+ScopedProfilePhase::ScopedProfilePhase(ProfilePhase phase):
+    outer_(current_phase) {
+  std::int64_t now = NowNs();
+  if (outer_ != -1) profile.phase_ns[outer_] += now - phase_start_ns;
+
+  current_phase = static_cast<int>(phase);
+  ++profile.phase_calls[current_phase];
+  phase_start_ns = now;
+}
+
+/*********************************************************************
+** Function: ~ScopedProfilePhase
+** Description: Destructor for the ScopedProfilePhase class; stops timing
+ * its phase and resumes the one it paused.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+ScopedProfilePhase::~ScopedProfilePhase() {
+  std::int64_t now = NowNs();
+  profile.phase_ns[current_phase] += now - phase_start_ns;
+
+  current_phase = outer_;
+  phase_start_ns = now;
+}
@@ -0,0 +1,97 @@
+#ifndef ZOO_TYCOON_TURNPROFILE_H
+#define ZOO_TYCOON_TURNPROFILE_H
+/*********************************************************************
+** Program Filename: TurnProfile.h
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Declares the TurnProfile struct, which breaks the time
+ * games spend playing turns down by phase, and the macros that measure
+ * it.
+** Input: None
+** Output: None
+*********************************************************************/
+
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+// The parts of a turn that are timed separately. Other is everything in a
+// turn outside the rest, such as parsing input and starting turns.
+enum class ProfilePhase {
+  Aging,
+  Feeding,
+  SpecialEvent,
+  Action,
+  Revenue,
+  Rendering,
+  Saving,
+  Other
+};
+
+static constexpr unsigned NUMBER_OF_PROFILE_PHASES = 8;
+
+// Whether the program was built with ZOO_PROFILE defined ("make
+// PROFILE=1"); without it, the ZT_PROFILE macros expand to nothing and
+// every TurnProfile stays zero.
+#ifdef ZOO_PROFILE
+static constexpr bool TURN_PROFILE_ENABLED = true;
+#else
+static constexpr bool TURN_PROFILE_ENABLED = false;
+#endif
+
+// Where the time of every turn played on a thread went, and how much work
+// it did. Times are exclusive: a phase entered within another (say,
+// Rendering within Action) is counted only towards the inner phase.
+struct TurnProfile {
+  std::array<std::uint64_t, NUMBER_OF_PROFILE_PHASES> phase_ns;
+  std::array<std::uint64_t, NUMBER_OF_PROFILE_PHASES> phase_calls;
+  std::uint64_t turns;
+  // Animals aged, fed and collected revenue from.
+  std::uint64_t animals_processed;
+  std::uint64_t transactions_logged;
+  // Every allocation the thread made, inside turns or not.
+  std::uint64_t allocations;
+  std::uint64_t allocated_bytes;
+
+  std::uint64_t TotalNs() const;
+};
+
+std::ostream &operator<<(std::ostream &os, const TurnProfile &p);
+
+const TurnProfile &CurrentTurnProfile();
+void ResetTurnProfile();
+
+// Times a phase from its construction to its destruction; used through
+// ZT_PROFILE_PHASE.
+class ScopedProfilePhase {
+  public:
+    explicit ScopedProfilePhase(ProfilePhase phase);
+    ScopedProfilePhase(const ScopedProfilePhase &) = delete;
+    ScopedProfilePhase &operator=(const ScopedProfilePhase &) = delete;
+    ~ScopedProfilePhase();
+
+  private:
+    // The phase that was being timed when this one began, if any.
+    int outer_;
+};
+
+// Adds n to the counter of the current thread's TurnProfile.
+void CountTurnProfile(std::uint64_t TurnProfile::*counter, std::uint64_t n);
+
+#ifdef ZOO_PROFILE
+#define ZT_PROFILE_CONCAT_(a, b) a##b
+#define ZT_PROFILE_CONCAT(a, b) ZT_PROFILE_CONCAT_(a, b)
+#define ZT_PROFILE_PHASE(phase) \
+    ScopedProfilePhase ZT_PROFILE_CONCAT(zt_profile_phase_, __LINE__)( \
+        ProfilePhase::phase)
+#define ZT_PROFILE_COUNT(counter, n) \
+    CountTurnProfile(&TurnProfile::counter, (n))
+#else
+#define ZT_PROFILE_PHASE(phase) do {} while (0)
+#define ZT_PROFILE_COUNT(counter, n) do {} while (0)
+#endif
+
+
+#endif //ZOO_TYCOON_TURNPROFILE_H
@@ -6,6 +6,7 @@
 ** Input: None
 ** Output: None
 *********************************************************************/
+#include <cstring>
 #include <iterator>
 #include <random>
 #include "Utils.h"
@@ -24,3 +25,54 @@ std::mt19937 MakeRngEngine() {
   std::seed_seq seed(std::begin(seed_data), std::end(seed_data));
   return std::mt19937(seed);
 }
+
+/*********************************************************************
+** Function: Checksum64
+** Description: Computes a 64-bit checksum of the given bytes, eight at a
+ * time; fast enough to check gigabytes of save data, but not meant to
+ * resist tampering.
+** Parameters: data points to the bytes; size is their number.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+std::uint64_t Checksum64(const void *data, std::size_t size) {
+  static constexpr std::uint64_t P1 = 0x9E3779B185EBCA87ULL;
+  static constexpr std::uint64_t P2 = 0xC2B2AE3D27D4EB4FULL;
+
+  const unsigned char *p = static_cast<const unsigned char *>(data);
+  std::uint64_t h = P1 ^ (size * P2);
+
+  for (; size >= 8; size -= 8, p += 8) {
+    std::uint64_t w;
+    std::memcpy(&w, p, 8);
+    h ^= w * P2;
+    h = ((h << 31) | (h >> 33)) * P1;
+  }
+
+  std::uint64_t tail = 0;
+  std::memcpy(&tail, p, size);
+  h ^= tail * P2;
+
+  h ^= h >> 33;
+  h *= P2;
+  h ^= h >> 29;
+  h *= P1;
+  h ^= h >> 32;
+  return h;
+}
+
+/*********************************************************************
+** Function: Mix64
+** Description: Scrambles the bits of a 64-bit number so that every bit
+ * of the result depends on every bit of x (the SplitMix64 finalizer);
+ * used to build digests out of parts.
+** Parameters: x is the number.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+std::uint64_t Mix64(std::uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
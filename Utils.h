@@ -11,6 +11,7 @@
 
 
 #include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <random>
@@ -25,6 +26,8 @@ template <class T>
 using InputValidationFn = std::function<bool(const T &)>;
 
 std::mt19937 MakeRngEngine();
+std::uint64_t Checksum64(const void *data, std::size_t size);
+std::uint64_t Mix64(std::uint64_t x);
 
 // Avoids need for hash specialization,
 // per https://stackoverflow.com/questions/18837857/cant-use-enum-class-as
@@ -7,9 +7,14 @@
 ** Input: None
 ** Output: None
 *********************************************************************/
+#include <algorithm>
+#include <cstdio>
 #include <functional>
+#include <iterator>
+#include <ostream>
 #include <vector>
 #include "Option.h"
+#include "Trace.h"
 #include "Zoo.h"
 
 /*********************************************************************
@@ -21,48 +26,64 @@
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
-std::unordered_map<std::string, std::pair<unsigned, unsigned>>
+std::unordered_map<std::string, std::pair<unsigned long, unsigned long>>
 Zoo::AdultsAndBabiesForEachSpecies() const {
-  std::unordered_map<std::string, std::pair<unsigned, unsigned>> map;
-  for (const auto &a : animals_) {
-    if (map.find(a->name()) == map.end())
-      map[a->name()] = std::make_pair(0, 0);
-    if (a->IsAdult()) ++(map[a->name()].first);
-    else if (a->IsBaby()) ++(map[a->name()].second);
-  }
+  ZT_TRACE_SCOPE("Zoo::AdultsAndBabiesForEachSpecies", "animals",
+                 NumberOfAnimals());
+  std::unordered_map<std::string, std::pair<unsigned long, unsigned long>>
+      map;
+  SpeciesCounts counts = AdultsAndBabiesBySpecies();
+  for (AnimalSpecies s : AllSpecies())
+    if (ages_.Count(s))
+      map[AnimalSpeciesToString(s)] = counts[SpeciesIndex(s)];
 
   return map;
 }
 
 /*********************************************************************
-** Function: AdultAnimals
-** Description: Returns a vector of references to all adult animals in the
- * zoo.
+** Function: AdultsAndBabiesBySpecies
+** Description: Like AdultsAndBabiesForEachSpecies, but indexed by
+ * SpeciesIndex and without allocating; species with no animals have
+ * zero counts. Two range counts per species, in O(log d) (see
+ * ZooAgeIndex).
 ** Parameters: None
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
-std::vector<CAnimalRef> Zoo::AdultAnimals() const {
-  std::vector<CAnimalRef> adult_animals;
-  for (const auto &a : animals_)
-    if (a->IsAdult())
-      adult_animals.push_back(std::cref(*a));
-  return adult_animals;
+SpeciesCounts Zoo::AdultsAndBabiesBySpecies() const {
+  SpeciesCounts counts;
+  for (unsigned i = 0; i != NUMBER_OF_SPECIES; ++i) {
+    AnimalSpecies s = static_cast<AnimalSpecies>(i);
+    counts[i].first = ages_.Count(s, ANIMAL_ADULT_AGE);
+    counts[i].second = ages_.Count(s, 0, ANIMAL_BABY_MAX_AGE - 1);
+  }
+
+  return counts;
 }
 
 /*********************************************************************
-** Function: Animals
-** Description: Returns a vector of references to all animals in the zoo.
-** Parameters: None
-** Pre-Conditions: None
+** Function: NthAdultAnimal
+** Description: Returns the k-th adult animal, counting from 0, in the
+ * order they were added, in O(log n). For a uniformly drawn k, each
+ * cohort is picked with a probability proportional to its number of
+ * adults.
+** Parameters: k is the index of the animal.
+** Pre-Conditions: k < NumberOfAdultAnimals()
 ** Post-Conditions: None
 *********************************************************************/
-std::vector<CAnimalRef> Zoo::Animals() const {
-  std::vector<CAnimalRef> animals;
-  animals.reserve(animals_.size());
-  for (const auto &a : animals_)
-    animals.push_back(std::cref(*a));
-  return animals;
+CAnimalRef Zoo::NthAdultAnimal(AnimalsVec::size_type k) const {
+  return std::cref(*animals_[cohorts_.FindAdult(k)]);
+}
+
+/*********************************************************************
+** Function: NthAnimal
+** Description: Like NthAdultAnimal, for all the animals.
+** Parameters: k is the index of the animal.
+** Pre-Conditions: k < NumberOfAnimals()
+** Post-Conditions: None
+*********************************************************************/
+CAnimalRef Zoo::NthAnimal(AnimalsVec::size_type k) const {
+  return std::cref(*animals_[cohorts_.FindAnimal(k)]);
 }
 
 /*********************************************************************
@@ -73,10 +94,7 @@ std::vector<CAnimalRef> Zoo::Animals() const {
 ** Post-Conditions: None
 *********************************************************************/
 AnimalsVec::size_type Zoo::NumberOfAdultAnimals() const {
-  AnimalsVec::size_type n = 0;
-  for (const auto &a : animals_)
-    if (a->IsAdult()) ++n;
-  return n;
+  return CountAnimalsAged(ANIMAL_ADULT_AGE, MAX_ANIMAL_AGE);
 }
 
 /*********************************************************************
@@ -87,21 +105,119 @@ AnimalsVec::size_type Zoo::NumberOfAdultAnimals() const {
 ** Post-Conditions: none
 *********************************************************************/
 AnimalsVec::size_type Zoo::NumberOfBabyAnimals() const {
+  return CountAnimalsAged(0, ANIMAL_BABY_MAX_AGE - 1);
+}
+
+/*********************************************************************
+** Function: CountAnimalsAged
+** Description: Counts the animals, of a species or of all of them, aged
+ * from min_age to max_age days, inclusive, in O(log d) (see
+ * ZooAgeIndex); e.g. the animals maturing in the next 30 days are those
+ * aged ANIMAL_ADULT_AGE - 30 to ANIMAL_ADULT_AGE - 1.
+** Parameters: s is the species; min_age and max_age bound the ages.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+AnimalsVec::size_type Zoo::CountAnimalsAged(AnimalSpecies s, unsigned min_age,
+                                            unsigned max_age) const {
+  return ages_.Count(s, min_age, max_age);
+}
+
+/*********************************************************************
+** Function: CountAnimalsAged
+** Description: Like the above, for the animals of every species.
+** Parameters: min_age and max_age bound the ages.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+AnimalsVec::size_type Zoo::CountAnimalsAged(unsigned min_age,
+                                            unsigned max_age) const {
   AnimalsVec::size_type n = 0;
-  for (const auto &a : animals_)
-    if (a->IsBaby()) ++n;
+  for (unsigned i = 0; i != NUMBER_OF_SPECIES; ++i)
+    n += ages_.Count(static_cast<AnimalSpecies>(i), min_age, max_age);
   return n;
 }
 
 /*********************************************************************
-** Function: AddAnimal
-** Description: Adds the given animal to the zoo.
-** Parameters: animal is the Animal pointer to add.
+** Function: AgeQuantile
+** Description: Returns the age that a fraction q of a species' animals
+ * are no older than (the youngest for q = 0, the median for q = 0.5, the
+ * oldest for q = 1), in O(log d) (see ZooAgeIndex).
+** Parameters: s is the species; q is the fraction.
+** Pre-Conditions: 0 <= q <= 1
+** Post-Conditions: Returns None if the zoo has no animals of the species.
+*********************************************************************/
+Option<unsigned> Zoo::AgeQuantile(AnimalSpecies s, double q) const {
+  unsigned long n = ages_.Count(s);
+  if (n == 0) return None;
+  return ages_.KthYoungest(
+      s, static_cast<unsigned long>(q * static_cast<double>(n - 1) + 0.5));
+}
+
+/*********************************************************************
+** Function: CountAnimals
+** Description: Counts the animals a listing with the given filter shows.
+** Parameters: filter picks the animals to count.
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
-void Zoo::AddAnimal(std::unique_ptr<Animal> animal) {
-  animals_.push_back(std::move(animal));
+AnimalsVec::size_type Zoo::CountAnimals(const ZooListingFilter &filter) const {
+  if (filter.IsEmpty()) return NumberOfAnimals();
+  if (filter.species.IsNone())
+    return CountAnimalsAged(filter.min_age, filter.max_age);
+  return CountAnimalsAged(filter.species.CUnwrapRef(), filter.min_age,
+                          filter.max_age);
+}
+
+/*********************************************************************
+** Function: AgeHistogramBySpecies
+** Description: Counts the zoo's animals by species and age group, with
+ * a range count per group.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+AgeHistogram Zoo::AgeHistogramBySpecies() const {
+  AgeHistogram histogram;
+  for (unsigned i = 0; i != NUMBER_OF_SPECIES; ++i) {
+    unsigned min_age = 0;
+    for (unsigned g = 0; g != NUMBER_OF_AGE_GROUPS; ++g) {
+      unsigned max_age = g + 1 == NUMBER_OF_AGE_GROUPS ?
+          MAX_ANIMAL_AGE : AGE_GROUP_BOUNDS[g] - 1;
+      histogram[i][g] = ages_.Count(static_cast<AnimalSpecies>(i), min_age,
+                                    max_age);
+      min_age = max_age + 1;
+    }
+  }
+  return histogram;
+}
+
+/*********************************************************************
+** Function: AddAnimal
+** Description: Adds count animals like the given one to the end of the
+ * zoo; they join the last cohort if it holds animals of the same species
+ * and age, and otherwise start a new cohort that animal stands in for.
+** Parameters: animal is the Animal pointer to add; count is the number of
+ * animals it stands for.
+** Pre-Conditions: count > 0
+** Post-Conditions: Returns a reference to the animal standing in for the
+ * cohort the animals joined.
+*********************************************************************/
+CAnimalRef Zoo::AddAnimal(std::unique_ptr<Animal> animal,
+                          unsigned long count) {
+  AnimalSpecies s = animal->species();
+  digest_.Add(s, animal->age(), count);
+  ages_.Add(s, animal->age(), count);
+
+  long birth_day = day_ - static_cast<long>(animal->age());
+  bool adult = animal->IsAdult();
+  AnimalCohorts::size_type c = cohorts_.Add(s, birth_day, count, adult);
+  if (c == animals_.size()) {
+    animals_.push_back(std::move(animal));
+    if (!adult) growing_.push(birth_day + ANIMAL_ADULT_AGE, c);
+    expiring_[SpeciesIndex(s)].push(birth_day, c);
+  }
+  return std::cref(*animals_[c]);
 }
 
 /*********************************************************************
@@ -113,73 +229,325 @@ void Zoo::AddAnimal(std::unique_ptr<Animal> animal) {
 ** Post-Conditions: None
 *********************************************************************/
 std::vector<CAnimalRef> Zoo::AnimalGiveBirth(const Animal &animal) {
+  ZT_TRACE_SCOPE("Zoo::AnimalGiveBirth", "babies",
+                 animal.babies_per_birth());
+  // The babies are all alike, so they make up a single cohort.
+  AnimalsVec babies = animal.GiveBirth();
+  if (babies.empty()) return {};
+  unsigned long count = babies.size();
+  return std::vector<CAnimalRef>(count,
+                                 AddAnimal(std::move(babies.front()), count));
+}
+
+/*********************************************************************
+** Function: AnimalsGiveBirth
+** Description: Like AnimalGiveBirth, for n_parents animals like the given
+ * one giving birth at once; their babies make up a single cohort.
+** Parameters: animal is one of the parents; n_parents is their number.
+** Pre-Conditions: n_parents > 0
+** Post-Conditions: Returns a reference to the animal standing in for the
+ * babies, of which there are n_parents * animal.babies_per_birth(), or
+ * None if the animal has no babies.
+*********************************************************************/
+Option<CAnimalRef> Zoo::AnimalsGiveBirth(const Animal &animal,
+                                         unsigned long n_parents) {
+  ZT_TRACE_SCOPE("Zoo::AnimalsGiveBirth", "parents", n_parents);
   AnimalsVec babies = animal.GiveBirth();
-  std::vector<CAnimalRef> birthed_animals;
-  for (const auto &b : babies)
-    birthed_animals.push_back(std::cref(*b));
-  std::move(babies.begin(), babies.end(), std::back_inserter(animals_));
-  return birthed_animals;
+  if (babies.empty()) return None;
+  unsigned long count = babies.size() * n_parents;
+  return AddAnimal(std::move(babies.front()), count);
 }
 
 /*********************************************************************
 ** Function: IncrementAnimalAges
-** Description: Increments the ages of every zoo animal by by amount.
+** Description: Increments the ages of every zoo animal by by amount, one
+ * cohort at a time.
 ** Parameters: by is the amount to increase their ages.
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
 void Zoo::IncrementAnimalAges(unsigned int by) {
-  for (auto &a : animals_)
-    a->IncrementAge(by);
+  ZT_TRACE_SCOPE("Zoo::IncrementAnimalAges", "cohorts", cohorts_.size());
+  animals_.ForEachMutable(
+      [by](std::unique_ptr<Animal> &a) { a->IncrementAge(by); });
+  day_ += by;
+  for (; !growing_.empty() && growing_.top().first <= day_; growing_.pop())
+    cohorts_.MarkAdult(growing_.top().second);
+  digest_.AgeAll(by);
+  ages_.AgeAll(by);
 }
 
 /*********************************************************************
 ** Function: RemoveAnimal
-** Description: Removes the given animal from the zoo.
+** Description: Removes an animal equal to the given one (of the same
+ * species and age) from the zoo: one of the first cohort of such animals.
+ * The cohort is left in place until the start of the next day even if it
+ * has no animals left, so that references to the animals standing in for
+ * cohorts stay valid for the rest of the day.
 ** Parameters: animal is the Animal object to remove.
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
 bool Zoo::RemoveAnimal(const Animal &animal) {
-  auto it = std::find_if(animals_.begin(), animals_.end(),
-      [&](const std::unique_ptr<Animal> &a) {
-          return *a == animal;
-      });
-  if (it == animals_.end()) return false;
-  animals_.erase(it);
+  ZT_TRACE_SCOPE("Zoo::RemoveAnimal", "cohorts", cohorts_.size());
+  Option<AnimalCohorts::size_type> c = cohorts_.FindFirst(
+      animal.species(), day_ - static_cast<long>(animal.age()));
+  if (c.IsNone()) return false;
+  cohorts_.RemoveOne(c.Unwrap());
+  digest_.Remove(animal.species(), animal.age());
+  ages_.Remove(animal.species(), animal.age());
   return true;
 }
 
+/*********************************************************************
+** Function: RemoveAnimals
+** Description: Like RemoveAnimal, but removes up to count animals equal
+ * to the given one, from the first cohorts of such animals on.
+** Parameters: animal is the Animal object to remove; count is the number
+ * of animals to remove.
+** Pre-Conditions: None
+** Post-Conditions: Returns the number of animals removed.
+*********************************************************************/
+unsigned long Zoo::RemoveAnimals(const Animal &animal, unsigned long count) {
+  ZT_TRACE_SCOPE("Zoo::RemoveAnimals", "count", count);
+  long birth_day = day_ - static_cast<long>(animal.age());
+  unsigned long removed = 0;
+  while (removed != count) {
+    Option<AnimalCohorts::size_type> c =
+        cohorts_.FindFirst(animal.species(), birth_day);
+    if (c.IsNone()) break;
+    unsigned long n =
+        std::min(count - removed, cohorts_[c.CUnwrapRef()].count);
+    cohorts_.Remove(c.Unwrap(), n);
+    removed += n;
+  }
+
+  if (removed) {
+    digest_.Remove(animal.species(), animal.age(), removed);
+    ages_.Remove(animal.species(), animal.age(), removed);
+  }
+  return removed;
+}
+
+/*********************************************************************
+** Function: RemoveExpiredAnimals
+** Description: Starts the day: removes every animal that has reached its
+ * species' lifespan, a whole cohort at a time, taking the cohorts from
+ * each species' oldest on, then drops empty cohorts if enough have built up.
+ * Finding the expired animals never looks at the rest of the zoo.
+** Parameters: None
+** Pre-Conditions: No references to the zoo's animals are held.
+** Post-Conditions: Returns the number of animals of each species removed.
+*********************************************************************/
+SpeciesDeaths Zoo::RemoveExpiredAnimals() {
+  ZT_TRACE_SCOPE("Zoo::RemoveExpiredAnimals");
+  SpeciesDeaths deaths{};
+  for (unsigned s = 0; s != NUMBER_OF_SPECIES; ++s) {
+    auto &expiring = expiring_[s];
+    while (!expiring.empty()) {
+      AnimalCohorts::size_type c = expiring.top().second;
+      const Animal &a = *animals_[c];
+      if (day_ - expiring.top().first < static_cast<long>(a.lifespan()))
+        break;
+      expiring.pop();
+
+      unsigned long count = cohorts_[c].count;
+      if (count == 0) continue;
+      cohorts_.Remove(c, count);
+      digest_.Remove(a.species(), a.age(), count);
+      ages_.Remove(a.species(), a.age(), count);
+      deaths[s] += count;
+    }
+  }
+
+  DropEmptyCohorts();
+  return deaths;
+}
+
+/*********************************************************************
+** Function: DropEmptyCohorts
+** Description: Drops the cohorts that have no animals left, along with
+ * the animals standing in for them, keeping the rest in order; the k-th
+ * animal of the zoo is the same animal afterwards. Waits until enough
+ * cohorts are empty to make it worth it, so it is amortized O(log n) a
+ * dropped cohort rather than O(n log n) a day.
+** Parameters: None
+** Pre-Conditions: No references to the animals standing in for empty
+ * cohorts are held.
+** Post-Conditions: None
+*********************************************************************/
+void Zoo::DropEmptyCohorts() {
+  if (!cohorts_.WorthCompacting()) return;
+  ZT_TRACE_SCOPE("Zoo::DropEmptyCohorts", "cohorts", cohorts_.size());
+  const CowArray<AnimalCohorts::size_type> &remap = cohorts_.Compact();
+  animals_.EraseIf([&](AnimalCohorts::size_type i) {
+    return remap[i] == AnimalCohorts::NO_COHORT;
+  });
+  growing_.Remap(remap);
+  for (CohortHeap &expiring : expiring_)
+    expiring.Remap(remap);
+}
+
 /*********************************************************************
 ** Function: FeedingCost
-** Description: Returns the cost of feeding every animal in the zoo.
+** Description: Returns the cost of feeding every animal in the zoo, each
+ * animal's cost rounded down to whole dollars.
 ** Parameters: t is the type of feed being fed to the animals; base_cost
  * is the base cost of the feed.
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
 double Zoo::FeedingCost(FoodType t, double base_cost) const {
-  unsigned cost = 0;
-  for (const auto &a : animals_)
-    cost += a->FoodCost(t, base_cost);
+  ZT_TRACE_SCOPE("Zoo::FeedingCost", "cohorts", cohorts_.size());
+  double cost = 0.0;
+  ForEachCohort([&](const Animal &a, unsigned long count) {
+    // Costs are never negative, so the conversion rounds them down.
+    unsigned whole_cost = static_cast<unsigned>(a.FoodCost(t, base_cost));
+    cost += static_cast<double>(count) * whole_cost;
+  });
   return cost;
 }
 
 /*********************************************************************
 ** Function: TotalDailyRevenue
 ** Description: Calculates the total daily revenue generated by the zoo.
+ * Revenues are whole dollars, so adding them up a cohort at a time gives
+ * exactly the animal-by-animal total.
 ** Parameters: bonus_revenue is an optional amount of bonus revenue for
  * each animal (currently only applies to monkeys).
 ** Pre-Conditions: None
 ** Post-Conditions: None
 *********************************************************************/
 double Zoo::TotalDailyRevenue(Option<unsigned> bonus_revenue) const {
+  ZT_TRACE_SCOPE("Zoo::TotalDailyRevenue", "cohorts", cohorts_.size());
   double revenue = 0.0;
+  AnimalCohorts::size_type c = 0;
   for (const auto &a : animals_)
-    revenue += a->DailyRevenue(bonus_revenue);
+    revenue += cohorts_[c++].count * a->DailyRevenue(bonus_revenue);
   return revenue;
 }
 
+/*********************************************************************
+** Function: PrintAnimals
+** Description: Prints one page of the listing operator<< prints in full,
+ * skipping the animals the filter does not match; one line per animal,
+ * each but the last ending with a newline.
+** Parameters: os is the stream to print to; filter picks the animals to
+ * list; first is how many of them to skip; count is how many to print.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void Zoo::PrintAnimals(std::ostream &os, const ZooListingFilter &filter,
+                       AnimalsVec::size_type first,
+                       AnimalsVec::size_type count) const {
+  ZT_TRACE_SCOPE("Zoo::PrintAnimals", "animals", count);
+  // Whole cohorts before the page are skipped at once.
+  AnimalsVec::size_type skip = first, printed = 0;
+  ForEachCohort([&](const Animal &a, unsigned long n) {
+    if (printed == count || !filter.Matches(a)) return;
+    if (skip >= n) {
+      skip -= n;
+      return;
+    }
+    for (AnimalsVec::size_type i = skip; i != n && printed != count; ++i) {
+      if (printed++) os << '\n';
+      os << '\t' << a.name() << ": ";
+      PrintPrettyAge(os, a.age()) << " old";
+    }
+    skip = 0;
+  });
+}
+
+/*********************************************************************
+** Function: PrintSummary
+** Description: Prints a table of the zoo's animals by species and age
+ * group, worked out from their counts alone.
+** Parameters: os is the stream to print to.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void Zoo::PrintSummary(std::ostream &os) const {
+  static const char *const AGE_GROUP_NAMES[NUMBER_OF_AGE_GROUPS] = {
+    "<30d", "30d-3y", "3-5y", "5-10y", "10-20y", "20y+"
+  };
+
+  AgeHistogram histogram = AgeHistogramBySpecies();
+  std::array<std::size_t, NUMBER_OF_AGE_GROUPS> totals{};
+  char line[96];
+  os << "Animals in your zoo by species and age (" << NumberOfAnimals()
+     << " in all):\n";
+  std::snprintf(line, sizeof(line), "\t%-10s", "Species");
+  os << line;
+  for (const char *name : AGE_GROUP_NAMES) {
+    std::snprintf(line, sizeof(line), "%10s", name);
+    os << line;
+  }
+  os << "     Total\n";
+
+  for (unsigned s = 0; s != NUMBER_OF_SPECIES; ++s) {
+    std::size_t species_total = 0;
+    std::snprintf(line, sizeof(line), "\t%-10s", AnimalSpeciesToString(
+        static_cast<AnimalSpecies>(s)).c_str());
+    os << line;
+    for (unsigned g = 0; g != NUMBER_OF_AGE_GROUPS; ++g) {
+      std::snprintf(line, sizeof(line), "%10zu", histogram[s][g]);
+      os << line;
+      species_total += histogram[s][g];
+      totals[g] += histogram[s][g];
+    }
+    std::snprintf(line, sizeof(line), "%10zu\n", species_total);
+    os << line;
+  }
+
+  std::snprintf(line, sizeof(line), "\t%-10s", "Total");
+  os << line;
+  for (std::size_t total : totals) {
+    std::snprintf(line, sizeof(line), "%10zu", total);
+    os << line;
+  }
+  std::snprintf(line, sizeof(line), "%10zu", NumberOfAnimals());
+  os << line;
+}
+
+/*********************************************************************
+** Function: AgeGroup
+** Description: Returns the age group (see AGE_GROUP_BOUNDS) an age is in.
+** Parameters: age is the age, in days.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+unsigned AgeGroup(unsigned age) {
+  return static_cast<unsigned>(
+      std::upper_bound(std::begin(AGE_GROUP_BOUNDS),
+                       std::end(AGE_GROUP_BOUNDS), age) -
+      std::begin(AGE_GROUP_BOUNDS));
+}
+
+/*********************************************************************
+** Function: IsEmpty
+** Description: Returns whether the filter matches every animal.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+bool ZooListingFilter::IsEmpty() const {
+  return species.IsNone() && min_age == 0 &&
+         max_age == MAX_ANIMAL_AGE;
+}
+
+/*********************************************************************
+** Function: Matches
+** Description: Returns whether a listing with the filter shows the
+ * animal.
+** Parameters: a is the animal.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+bool ZooListingFilter::Matches(const Animal &a) const {
+  return (species.IsNone() || species.CUnwrapRef() == a.species()) &&
+         a.age() >= min_age && a.age() <= max_age;
+}
+
 /*********************************************************************
 ** Function: operator<<
 ** Description: Overloads the insertion operator to print Zoo objects.
@@ -188,13 +556,20 @@ double Zoo::TotalDailyRevenue(Option<unsigned> bonus_revenue) const {
 ** Post-Conditions: None
 *********************************************************************/
 std::ostream &operator<<(std::ostream &os, const Zoo &zoo) {
+  // Listing every animal is not worth it for a stream that would throw the
+  // text away (say, a NullSink).
+  if (!os) return os;
+
   os << "Animals in your zoo:\n";
-  auto sz = zoo.animals_.size();
-  for (decltype(sz) i = 0; i != sz; ++i) {
-    const Animal *animal = zoo.animals_[i].get();
-    os << '\t' << animal->name() << ": " << animal->PrettyAge() << " old";
-    if (i != sz - 1) os << '\n';
-  }
+  auto sz = zoo.NumberOfAnimals();
+  decltype(sz) i = 0;
+  zoo.ForEachCohort([&](const Animal &animal, unsigned long count) {
+    for (unsigned long n = 0; n != count; ++n) {
+      os << '\t' << animal.name() << ": ";
+      PrintPrettyAge(os, animal.age()) << " old";
+      if (++i != sz) os << '\n';
+    }
+  });
 
   return os;
 }
@@ -10,38 +10,161 @@
 *********************************************************************/
 
 
+#include <array>
+#include <cstddef>
+#include <functional>
 #include <utility>
 #include <vector>
 #include "Animal.h"
+#include "AnimalCohorts.h"
+#include "AnimalSpecies.h"
+#include "CowVector.h"
 #include "Option.h"
+#include "ZooAgeIndex.h"
+#include "ZooDigest.h"
 
+// The age groups of the zoo's summary: group i holds the animals younger
+// than AGE_GROUP_BOUNDS[i] (and no younger than the bound before it); the
+// last group holds the rest.
+static constexpr unsigned NUMBER_OF_AGE_GROUPS = 6;
+static constexpr unsigned AGE_GROUP_BOUNDS[NUMBER_OF_AGE_GROUPS - 1] = {
+  ANIMAL_BABY_MAX_AGE, ANIMAL_ADULT_AGE, 365 * 5, 365 * 10, 365 * 20
+};
+// Indexed by SpeciesIndex, then by age group.
+using AgeHistogram = std::array<std::array<std::size_t, NUMBER_OF_AGE_GROUPS>,
+                                NUMBER_OF_SPECIES>;
+
+unsigned AgeGroup(unsigned age);
+
+// The number of animals of each species that died, indexed by
+// SpeciesIndex.
+using SpeciesDeaths = std::array<unsigned long, NUMBER_OF_SPECIES>;
+
+// Which animals a listing shows: those of the species, if one is given,
+// between min_age and max_age days old.
+struct ZooListingFilter {
+  Option<AnimalSpecies> species;
+  unsigned min_age = 0;
+  unsigned max_age = MAX_ANIMAL_AGE;
+
+  bool IsEmpty() const;
+  bool Matches(const Animal &a) const;
+};
+
+// Copies an animal for a CowVector, when a chunk of animals that copies of
+// a zoo shared is about to change.
+struct CloneAnimal {
+  std::unique_ptr<Animal> operator()(const std::unique_ptr<Animal> &a) const
+      { return CreateFromSpecies(a->species(), a->age()); }
+};
+
+// A Zoo holds its animals as cohorts (see AnimalCohorts): animals of the
+// same species and age, added one after another, are indistinguishable,
+// so each cohort keeps a single Animal standing in for all of them, and
+// references to a zoo's animals are references to those. Daily work
+// (aging, feeding, revenue) is done once per cohort rather than once per
+// animal, and picking the k-th animal is O(log n). Cohorts left without
+// animals are dropped at the start of the next day (see
+// RemoveExpiredAnimals), so that daily work only ever covers the cohorts
+// that still have animals, and the ones emptied the day before.
+//
+// Copies of a Zoo share their cohorts' animals, a chunk at a time, until
+// one of them changes the chunk (see CowVector), and likewise the cohorts,
+// their Fenwick trees, the age index and the heaps (see CowArray). So a
+// fork costs O(cohorts / COW_ARRAY_CHUNK_SIZE) and then copies only the
+// chunks it changes; zoo_bench's "Zoo copy" checks that it does.
+// References to a zoo's animals obtained before it was copied must not be
+// used after it next changes.
 class Zoo {
   friend std::ostream &operator<<(std::ostream &os, const Zoo &zoo);
 
   public:
     Zoo() {}
 
-    std::unordered_map<std::string, std::pair<unsigned, unsigned>>
+    std::unordered_map<std::string, std::pair<unsigned long, unsigned long>>
         AdultsAndBabiesForEachSpecies() const;
-    std::vector<CAnimalRef> AdultAnimals() const;
-    std::vector<CAnimalRef> Animals() const;
+    SpeciesCounts AdultsAndBabiesBySpecies() const;
+    AgeHistogram AgeHistogramBySpecies() const;
+    CAnimalRef NthAdultAnimal(AnimalsVec::size_type k) const;
+    CAnimalRef NthAnimal(AnimalsVec::size_type k) const;
     AnimalsVec::size_type NumberOfAnimals() const
-        { return animals_.size(); };
+        { return cohorts_.NumberOfAnimals(); };
+    AnimalsVec::size_type NumberOfCohorts() const { return cohorts_.size(); }
     AnimalsVec::size_type NumberOfAdultAnimals() const;
     AnimalsVec::size_type NumberOfBabyAnimals() const;
+    AnimalsVec::size_type CountAnimals(const ZooListingFilter &filter) const;
+    AnimalsVec::size_type CountAnimalsAged(AnimalSpecies s, unsigned min_age,
+                                           unsigned max_age) const;
+    AnimalsVec::size_type CountAnimalsAged(unsigned min_age,
+                                           unsigned max_age) const;
+    Option<unsigned> AgeQuantile(AnimalSpecies s, double q) const;
+    // A digest of the zoo's animals (see ZooDigest), in O(1).
+    std::uint64_t Digest() const { return digest_.value(); }
+
+    // Calls f(animal, count) for each cohort that still has animals, in
+    // the order they were added.
+    template <class F>
+    void ForEachCohort(F f) const;
 
-    void AddAnimal(std::unique_ptr<Animal> animal);
+    CAnimalRef AddAnimal(std::unique_ptr<Animal> animal,
+                         unsigned long count = 1);
     std::vector<CAnimalRef> AnimalGiveBirth(const Animal &animal);
+    Option<CAnimalRef> AnimalsGiveBirth(const Animal &animal,
+                                        unsigned long n_parents);
     void IncrementAnimalAges(unsigned by = 1);
     bool RemoveAnimal(const Animal &animal);
+    unsigned long RemoveAnimals(const Animal &animal, unsigned long count);
+    SpeciesDeaths RemoveExpiredAnimals();
+    void Reserve(AnimalsVec::size_type n_cohorts)
+        { animals_.reserve(n_cohorts); }
 
     double FeedingCost(FoodType t, double base_cost) const;
     double TotalDailyRevenue(Option<unsigned> bonus_revenue) const;
 
+    // Listings for zoos too big to print in full: a table of animals by
+    // species and age group, and one page of the full listing. Both stream
+    // straight to os.
+    void PrintAnimals(std::ostream &os, const ZooListingFilter &filter,
+                      AnimalsVec::size_type first,
+                      AnimalsVec::size_type count) const;
+    void PrintSummary(std::ostream &os) const;
+
   private:
-    std::vector<std::unique_ptr<Animal>> animals_;
+    // animals_[i] stands in for the animals of cohorts_[i].
+    CowVector<std::unique_ptr<Animal>, CloneAnimal> animals_;
+    AnimalCohorts cohorts_;
+    // How many days the zoo's animals have aged by; cohorts' birth days
+    // count from it.
+    long day_ = 0;
+    // The cohorts of animals that are not adults yet, by the day they
+    // grow up, soonest first.
+    CohortHeap growing_;
+    // For each species, its cohorts by birth day, oldest first, so that
+    // the ones that have reached the species' lifespan are at the top.
+    std::array<CohortHeap, NUMBER_OF_SPECIES> expiring_;
+    ZooDigest digest_;
+    ZooAgeIndex ages_;
+
+    void DropEmptyCohorts();
 };
 
+/*********************************************************************
+** Function: ForEachCohort
+** Description: Calls f with each cohort's animal and number of animals,
+ * skipping the cohorts that have none left.
+** Parameters: f is the function to call.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+template <class F>
+void Zoo::ForEachCohort(F f) const {
+  AnimalCohorts::size_type i = 0;
+  for (const auto &a : animals_) {
+    unsigned long count = cohorts_[i++].count;
+    if (count) f(*a, count);
+  }
+}
+
 std::ostream &operator<<(std::ostream &os, const Zoo &zoo);
 
 
@@ -0,0 +1,141 @@
+/*********************************************************************
+** Program Filename: ZooAgeIndex.cpp
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Implements functions declared by the ZooAgeIndex class.
+** Input: None
+** Output: None
+*********************************************************************/
+#include <algorithm>
+#include "ZooAgeIndex.h"
+
+/*********************************************************************
+** Function: Count
+** Description: Counts the animals of a species aged from min_age to
+ * max_age days, inclusive.
+** Parameters: s is the species; min_age and max_age bound the ages.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+unsigned long ZooAgeIndex::Count(AnimalSpecies s, unsigned min_age,
+                                 unsigned max_age) const {
+  const Births &b = births_[SpeciesIndex(s)];
+  if (min_age > max_age || b.counts.size() == 0) return 0;
+
+  // Slots [first, last) hold the animals born from day_ - max_age to
+  // day_ - min_age.
+  long long size = static_cast<long long>(b.counts.size());
+  long long first = std::max(day_ - max_age - b.origin, 0LL);
+  long long last = std::min(day_ - min_age - b.origin + 1, size);
+  if (first >= last) return 0;
+  return b.counts.PrefixSum(static_cast<std::size_t>(last)) -
+         b.counts.PrefixSum(static_cast<std::size_t>(first));
+}
+
+/*********************************************************************
+** Function: KthYoungest
+** Description: Returns the age of the k-th youngest animal of a species,
+ * counting from 0.
+** Parameters: s is the species; k is the rank.
+** Pre-Conditions: None
+** Post-Conditions: Returns None if there are no more than k animals of
+ * the species.
+*********************************************************************/
+Option<unsigned> ZooAgeIndex::KthYoungest(AnimalSpecies s,
+                                          unsigned long k) const {
+  const Births &b = births_[SpeciesIndex(s)];
+  unsigned long total = b.counts.Total();
+  if (k >= total) return None;
+
+  // The slots run from the oldest animals to the youngest.
+  std::size_t slot = b.counts.Find(total - 1 - k);
+  return static_cast<unsigned>(day_ - b.origin -
+                               static_cast<long long>(slot));
+}
+
+/*********************************************************************
+** Function: Add
+** Description: Counts new animals.
+** Parameters: s is the animals' species; age is their age; count is the
+ * number of animals.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void ZooAgeIndex::Add(AnimalSpecies s, unsigned age, unsigned long count) {
+  Births &b = births_[SpeciesIndex(s)];
+  long long birth_day = day_ - age;
+  Grow(b, birth_day);
+  b.counts.Add(static_cast<std::size_t>(birth_day - b.origin), count);
+}
+
+/*********************************************************************
+** Function: Remove
+** Description: Stops counting animals.
+** Parameters: s is the animals' species; age is their age; count is the
+ * number of animals.
+** Pre-Conditions: count animals of that species and age have been added
+ * and not removed since.
+** Post-Conditions: None
+*********************************************************************/
+void ZooAgeIndex::Remove(AnimalSpecies s, unsigned age, unsigned long count) {
+  // The window may have moved past the day animals that are all gone
+  // were born on.
+  if (count == 0) return;
+  Births &b = births_[SpeciesIndex(s)];
+  b.counts.Add(static_cast<std::size_t>(day_ - age - b.origin), -count);
+  Shrink(b);
+}
+
+/*********************************************************************
+** Function: Shrink
+** Description: Moves the species' window up to its oldest animal once
+ * at least half of its slots are for days before that animal's birth,
+ * so that the index covers the days animals alive now were born on,
+ * not every day since the first. Amortized O(1) a day the window moves.
+** Parameters: b is the species' births.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void ZooAgeIndex::Shrink(Births &b) {
+  if (b.counts.Total() == 0) {
+    b.counts.Clear();
+    return;
+  }
+
+  std::size_t oldest = b.counts.Find(0);
+  if (oldest * 2 < b.counts.size()) return;
+  b.counts.DropFront(oldest);
+  b.origin += static_cast<long long>(oldest);
+}
+
+/*********************************************************************
+** Function: Grow
+** Description: Makes room for animals born on the given day. Later days
+ * are appended a slot at a time; earlier ones rebuild the tree with at
+ * least twice as many slots, so that adding ever older animals stays
+ * cheap overall.
+** Parameters: b is the species' births; birth_day is the day.
+** Pre-Conditions: None
+** Post-Conditions: birth_day has a slot.
+*********************************************************************/
+void ZooAgeIndex::Grow(Births &b, long long birth_day) {
+  if (b.counts.size() == 0) b.origin = birth_day;
+
+  if (birth_day < b.origin) {
+    std::size_t old_size = b.counts.size();
+    long long new_origin = std::min(
+        birth_day, b.origin - static_cast<long long>(old_size));
+
+    FenwickTree<unsigned long> counts;
+    counts.Reserve(old_size + static_cast<std::size_t>(b.origin - new_origin));
+    for (long long d = new_origin; d != b.origin; ++d)
+      counts.Push(0);
+    for (std::size_t i = 0; i != old_size; ++i)
+      counts.Push(b.counts.PrefixSum(i + 1) - b.counts.PrefixSum(i));
+    b.counts = std::move(counts);
+    b.origin = new_origin;
+  }
+
+  while (birth_day - b.origin >= static_cast<long long>(b.counts.size()))
+    b.counts.Push(0);
+}
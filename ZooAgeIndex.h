@@ -0,0 +1,61 @@
+#ifndef ZOO_TYCOON_ZOOAGEINDEX_H
+#define ZOO_TYCOON_ZOOAGEINDEX_H
+/*********************************************************************
+** Program Filename: ZooAgeIndex.h
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Declares the ZooAgeIndex class, which counts a zoo's
+ * animals by species and age.
+** Input: None
+** Output: None
+*********************************************************************/
+
+
+#include <array>
+#include <limits>
+#include "AnimalSpecies.h"
+#include "FenwickTree.h"
+#include "Option.h"
+
+static constexpr unsigned MAX_ANIMAL_AGE = std::numeric_limits<unsigned>::max();
+
+// ZooAgeIndex holds, for each species, how many of a zoo's animals were
+// born on each day, in a FenwickTree indexed by birth day. Since aging
+// every animal leaves their birth days alone, AgeAll is O(1); adding or
+// removing an animal, counting the animals in a range of ages and finding
+// the k-th youngest animal are O(log d), d being the number of days
+// between the species' oldest and youngest animals' births. The index
+// follows the oldest animal forward as animals die, so d stays within
+// about twice the species' lifespan however long the game runs. Copies
+// share the trees until they change (see FenwickTree).
+class ZooAgeIndex {
+  public:
+    ZooAgeIndex() {}
+
+    unsigned long Count(AnimalSpecies s, unsigned min_age = 0,
+                        unsigned max_age = MAX_ANIMAL_AGE) const;
+    Option<unsigned> KthYoungest(AnimalSpecies s, unsigned long k) const;
+
+    void Add(AnimalSpecies s, unsigned age, unsigned long count = 1);
+    void AgeAll(unsigned by) { day_ += by; }
+    void Remove(AnimalSpecies s, unsigned age, unsigned long count = 1);
+
+  private:
+    // The animals of one species: slot i counts those born on day
+    // origin + i.
+    struct Births {
+      FenwickTree<unsigned long> counts;
+      long long origin = 0;
+    };
+
+    std::array<Births, NUMBER_OF_SPECIES> births_;
+    // How many days the index has aged its animals by; an animal of age a
+    // was born on day day_ - a.
+    long long day_ = 0;
+
+    static void Grow(Births &b, long long birth_day);
+    static void Shrink(Births &b);
+};
+
+
+#endif //ZOO_TYCOON_ZOOAGEINDEX_H
@@ -0,0 +1,120 @@
+/*********************************************************************
+** Program Filename: ZooBatchEnv.cpp
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Implements functions declared by the ZooBatchEnv class.
+** Input: None
+** Output: None
+*********************************************************************/
+#include <algorithm>
+#include <random>
+#include "ZooBatchEnv.h"
+#include "GameTurn.h"
+
+/*********************************************************************
+** Function: ZooBatchEnv
+** Description: Constructor for the ZooBatchEnv class; every environment
+ * starts out done until Reset is called.
+** Parameters: n_envs is the number of environments (K).
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+ZooBatchEnv::ZooBatchEnv(std::size_t n_envs):
+    games_(n_envs),
+    observations_(n_envs * ZOO_ENV_OBSERVATION_SIZE, 0.0),
+    rewards_(n_envs, 0.0), dones_(n_envs, 1) {}
+
+/*********************************************************************
+** Function: Reset
+** Description: Starts a new game in every environment.
+** Parameters: seeds holds size() seeds, one per environment; a game
+ * given the same seed and actions always plays out the same way.
+** Pre-Conditions: None
+** Post-Conditions: Every environment is on day one and not done.
+*********************************************************************/
+void ZooBatchEnv::Reset(const std::uint32_t *seeds) {
+  for (std::size_t i = 0; i != games_.size(); ++i) {
+    games_[i].reset(new Game(Player(), null_os_, std::mt19937(seeds[i])));
+    games_[i]->set_headless(true);
+    games_[i]->Start();
+    rewards_[i] = 0.0;
+    dones_[i] = 0;
+    Observe(i);
+  }
+}
+
+/*********************************************************************
+** Function: Step
+** Description: Plays one day in every environment that is not done.
+ * The games are headless and reuse their turns, so a day allocates only
+ * for what it adds to a zoo: newborn or bought animals, and the room
+ * their cohorts take.
+** Parameters: actions holds size() actions, one per environment.
+** Pre-Conditions: Reset has been called.
+** Post-Conditions: The observation, reward (change in bank balance) and
+ * done arrays describe the end of the day.
+*********************************************************************/
+void ZooBatchEnv::Step(const ZooEnvAction *actions) {
+  for (std::size_t i = 0; i != games_.size(); ++i) {
+    if (dones_[i]) {
+      rewards_[i] = 0.0;
+      continue;
+    }
+
+    Game &game = *games_[i];
+    double balance = game.player().MoneyRemaining();
+    PlayDay(game, actions[i]);
+
+    rewards_[i] = game.player().MoneyRemaining() - balance;
+    dones_[i] = game.IsOver();
+    Observe(i);
+  }
+}
+
+/*********************************************************************
+** Function: Observe
+** Description: Writes the observation of the given environment.
+** Parameters: i is the index of the environment.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void ZooBatchEnv::Observe(std::size_t i) {
+  const Game &game = *games_[i];
+  double *obs = &observations_[i * ZOO_ENV_OBSERVATION_SIZE];
+
+  obs[ZOO_ENV_OBS_BALANCE] = game.player().MoneyRemaining();
+  obs[ZOO_ENV_OBS_BASE_FOOD_COST] = game.state().base_food_cost;
+  obs[ZOO_ENV_OBS_DAY] = game.state().day;
+
+  SpeciesCounts counts = game.player().zoo().AdultsAndBabiesBySpecies();
+  for (unsigned s = 0; s != NUMBER_OF_SPECIES; ++s) {
+    obs[ZOO_ENV_OBS_ADULTS + s] = counts[s].first;
+    obs[ZOO_ENV_OBS_BABIES + s] = counts[s].second;
+  }
+}
+
+/*********************************************************************
+** Function: PlayDay
+** Description: Plays one whole turn of the game with the typed game
+ * events, then moves on to the next day unless the game ended.
+** Parameters: game is the game to play; action is the day's decisions.
+** Pre-Conditions: The game is waiting for the day's food.
+** Post-Conditions: The game is over or waiting for the next day's food.
+*********************************************************************/
+void ZooBatchEnv::PlayDay(Game &game, const ZooEnvAction &action) {
+  game.ChooseFood(action.food);
+
+  if (action.action == PlayerMainAction::BuyAnimal && action.quantity) {
+    unsigned qty = std::min(action.quantity, MAX_ANIMAL_PURCHASES);
+    game.ChooseMainAction(PlayerMainAction::BuyAnimal);
+    game.ChooseSpecies(action.species);
+    game.ChooseQuantity(qty);
+  }
+
+  if (action.action == PlayerMainAction::QuitGame)
+    game.ChooseMainAction(PlayerMainAction::QuitGame);
+  else
+    game.ChooseMainAction(PlayerMainAction::EndTurn);
+
+  game.NextDay();
+}
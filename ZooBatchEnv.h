@@ -0,0 +1,88 @@
+#ifndef ZOO_TYCOON_ZOOBATCHENV_H
+#define ZOO_TYCOON_ZOOBATCHENV_H
+/*********************************************************************
+** Program Filename: ZooBatchEnv.h
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Declares the ZooBatchEnv class, which steps many
+ * independent headless games in lockstep for training agents.
+** Input: None
+** Output: None
+*********************************************************************/
+
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "AnimalSpecies.h"
+#include "FoodType.h"
+#include "Game.h"
+#include "OutputSink.h"
+#include "PlayerAction.h"
+
+// Each environment's observation is ZOO_ENV_OBSERVATION_SIZE doubles:
+//   [0] bank balance
+//   [1] base food cost for the coming day
+//   [2] days played
+//   [3, 3 + NUMBER_OF_SPECIES) adults of each species (by SpeciesIndex)
+//   [3 + NUMBER_OF_SPECIES, 3 + 2 * NUMBER_OF_SPECIES) babies of each species
+static constexpr std::size_t ZOO_ENV_OBS_BALANCE = 0;
+static constexpr std::size_t ZOO_ENV_OBS_BASE_FOOD_COST = 1;
+static constexpr std::size_t ZOO_ENV_OBS_DAY = 2;
+static constexpr std::size_t ZOO_ENV_OBS_ADULTS = 3;
+static constexpr std::size_t ZOO_ENV_OBS_BABIES =
+    ZOO_ENV_OBS_ADULTS + NUMBER_OF_SPECIES;
+static constexpr std::size_t ZOO_ENV_OBSERVATION_SIZE =
+    ZOO_ENV_OBS_BABIES + NUMBER_OF_SPECIES;
+
+// One day's decisions for one environment.
+struct ZooEnvAction {
+  FoodType food;
+  // BuyAnimal buys quantity (1 or 2) animals of species and then ends the
+  // turn; QuitGame ends the game; anything else just ends the turn.
+  PlayerMainAction action;
+  AnimalSpecies species;
+  unsigned quantity;
+};
+
+// ZooBatchEnv holds K games and exposes them as flat arrays: Step() takes
+// K actions and plays one day of every game that is not done, then
+// observations(), rewards() and dones() hold K entries each. The arrays
+// are allocated once, up front, and the games are headless (see
+// Game::set_headless), so Step() allocates only for animals it adds.
+// Games that are done stay done (with zero reward) until the next Reset().
+class ZooBatchEnv {
+  public:
+    explicit ZooBatchEnv(std::size_t n_envs);
+    ZooBatchEnv(const ZooBatchEnv &) = delete;
+    ZooBatchEnv &operator=(const ZooBatchEnv &) = delete;
+
+    std::size_t size() const { return games_.size(); }
+
+    const unsigned char *dones() const { return dones_.data(); }
+    const double *observations() const { return observations_.data(); }
+    const double *rewards() const { return rewards_.data(); }
+    // Game i's Digest(), for checking one run against another.
+    std::uint64_t Digest(std::size_t i) const { return games_[i]->Digest(); }
+    // Game i itself, for checks that need more than the observations.
+    const Game &game(std::size_t i) const { return *games_[i]; }
+
+    void Reset(const std::uint32_t *seeds);
+    void Step(const ZooEnvAction *actions);
+
+  private:
+    // Games write their text here; nothing is ever printed.
+    NullSink null_os_;
+
+    std::vector<std::unique_ptr<Game>> games_;
+
+    std::vector<double> observations_;
+    std::vector<double> rewards_;
+    std::vector<unsigned char> dones_;
+
+    void Observe(std::size_t i);
+    void PlayDay(Game &game, const ZooEnvAction &action);
+};
+
+
+#endif //ZOO_TYCOON_ZOOBATCHENV_H
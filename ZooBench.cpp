@@ -0,0 +1,631 @@
+/*********************************************************************
+** Program Filename: ZooBench.cpp
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Microbenchmarks the game's hot paths (Zoo, BankAccount,
+ * SpecialEvent and whole headless days) on synthetic zoos of different
+ * sizes and species mixes.
+ * Usage: ./zoo_bench [--filter text] [--max-population n] [--samples n]
+ *     [--min-time seconds] [--json file]
+** Input: Command line arguments: --filter only runs the benchmarks whose
+ * names contain text; --max-population is the largest population to
+ * benchmark with (default 1e6; populations go up by a factor of 100 from
+ * 100, and 1e8 animals take about 12 GB); --samples is the number of
+ * timed samples per benchmark (default 5); --min-time is the least time
+ * a sample should take (default 0.05 s); --json also writes the results,
+ * every sample included, and a description of the machine and compiler
+ * to file, for zoo_bench_compare.
+** Output: One line per benchmark and population: the median ns/op, the
+ * bytes allocated per op and, where the kernel allows it, the last-level
+ * cache misses per op. Exits with 1 if forking a zoo allocated more than
+ * MaxForkBytes, that is, if a fork copied more than the parts it changed.
+*********************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+#endif
+#include "Game.h"
+#include "TurnProfile.h"
+
+static constexpr unsigned long long BENCH_MIN_POPULATION = 100;
+static constexpr unsigned long long BENCH_MAX_POPULATION = 1000000;
+static constexpr unsigned BENCH_POPULATION_STEP = 100;
+static constexpr unsigned BENCH_SAMPLES = 5;
+static constexpr double BENCH_MIN_SAMPLE_TIME = 0.05;
+static constexpr std::uint32_t BENCH_SEED = 1;
+// Enough that no benchmark runs out of money.
+static constexpr double BENCH_BALANCE = 1e18;
+// What a fork may allocate: a little per animal, for the lists of chunks
+// it shares, and a fixed amount for the chunks its change copies.
+static constexpr double BENCH_FORK_BYTES_PER_ANIMAL = 1.0;
+static constexpr double BENCH_FORK_SLACK_BYTES = 256 * 1024;
+
+#ifdef ZOO_PROFILE
+// The turn profiler replaces operator new already, and counts for us.
+static std::size_t AllocatedBytes() {
+  return CurrentTurnProfile().allocated_bytes;
+}
+#else
+// Bytes handed out by operator new since the program started. The
+// benchmarks are single-threaded.
+static std::size_t allocated_bytes = 0;
+
+static std::size_t AllocatedBytes() {
+  return allocated_bytes;
+}
+
+void *operator new(std::size_t size) {
+  allocated_bytes += size;
+  if (void *p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+  std::free(p);
+}
+#endif
+
+// Counts the process's last-level cache misses with a Linux perf event, if
+// the kernel allows it.
+class CacheMissCounter {
+  public:
+    CacheMissCounter();
+    CacheMissCounter(const CacheMissCounter &) = delete;
+    CacheMissCounter &operator=(const CacheMissCounter &) = delete;
+    ~CacheMissCounter();
+
+    bool available() const { return fd_ != -1; }
+
+    void Start();
+    std::uint64_t Stop();
+
+  private:
+    int fd_ = -1;
+};
+
+/*********************************************************************
+** Function: CacheMissCounter
+** Description: Constructor for the CacheMissCounter class; opens the
+ * perf event.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: available() tells whether it could.
+*********************************************************************/
+CacheMissCounter::CacheMissCounter() {
+#ifdef __linux__
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = PERF_COUNT_HW_CACHE_MISSES;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  fd_ = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+}
+
+/*********************************************************************
+** Function: ~CacheMissCounter
+** Description: Destructor for the CacheMissCounter class.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+CacheMissCounter::~CacheMissCounter() {
+#ifdef __linux__
+  if (available()) close(fd_);
+#endif
+}
+
+/*********************************************************************
+** Function: Start
+** Description: Starts counting from zero.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void CacheMissCounter::Start() {
+#ifdef __linux__
+  if (!available()) return;
+  ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+  ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+}
+
+/*********************************************************************
+** Function: Stop
+** Description: Stops counting.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: Returns the misses counted since Start(), or 0 if the
+ * counter is not available.
+*********************************************************************/
+std::uint64_t CacheMissCounter::Stop() {
+  std::uint64_t count = 0;
+#ifdef __linux__
+  if (!available()) return 0;
+  ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+  if (read(fd_, &count, sizeof(count)) != sizeof(count)) count = 0;
+#endif
+  return count;
+}
+
+// The share of each species (indexed by SpeciesIndex) in a synthetic zoo.
+struct SpeciesMix {
+  const char *name;
+  double weights[NUMBER_OF_SPECIES];
+};
+
+static const SpeciesMix MIXES[] = {
+  {"even", {1, 1, 1, 1}},
+  {"monkeys", {9, 1, 0, 0}},
+  {"elephants", {0, 0, 0, 1}},
+};
+
+/*********************************************************************
+** Function: MakeZoo
+** Description: Makes a synthetic zoo, with ages spread evenly from
+ * newborn to twice the adult age, so that it has babies, juveniles and
+ * adults.
+** Parameters: n is the number of animals; mix is the species mix.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+static Zoo MakeZoo(unsigned long long n, const SpeciesMix &mix) {
+  std::mt19937 rng(BENCH_SEED);
+  std::discrete_distribution<unsigned> species(
+      mix.weights, mix.weights + NUMBER_OF_SPECIES);
+  std::uniform_int_distribution<unsigned> age(0, 2 * ANIMAL_ADULT_AGE);
+
+  Zoo zoo;
+  zoo.Reserve(n);
+  for (unsigned long long i = 0; i != n; ++i)
+    zoo.AddAnimal(CreateFromSpecies(
+        static_cast<AnimalSpecies>(species(rng)), age(rng)));
+  return zoo;
+}
+
+// The synthetic zoo or ledger the benchmarks of one population and
+// species mix start from.
+struct Population {
+  Zoo zoo;
+  BankAccount account{BENCH_BALANCE};
+};
+
+// What a benchmark works on. Set up afresh before every sample from a
+// Population, which the fixture shares until it changes it.
+struct Fixture {
+  Zoo zoo;
+  std::unique_ptr<BankAccount> account;
+  std::unique_ptr<Game> game;
+  std::unique_ptr<Animal> animal;
+  std::mt19937 rng;
+  NullSink null_os;
+  // Results are added up here, and then stored in bench_sink, so that the
+  // compiler cannot drop the work.
+  double sink = 0.0;
+};
+
+static volatile double bench_sink;
+
+// A benchmark: setup prepares the fixture and op is the operation timed.
+// A benchmark with per_animal false ignores the species mix, and uses the
+// population as its ledger's length instead. One with forks true forks the
+// zoo, and fails if it allocates more than MaxForkBytes per op.
+struct Benchmark {
+  const char *name;
+  bool per_animal;
+  bool forks;
+  void (*setup)(Fixture &f, const Population &p);
+  void (*op)(Fixture &f);
+};
+
+static void SetupZoo(Fixture &f, const Population &p) {
+  f.zoo = p.zoo;
+  f.rng.seed(BENCH_SEED);
+}
+
+
+static void SetupRemove(Fixture &f, const Population &p) {
+  SetupZoo(f, p);
+  // An age no synthetic animal has, so that RemoveAnimal has to search the
+  // whole zoo for it.
+  f.animal = CreateFromSpecies(AnimalSpecies::Sloth, 3 * ANIMAL_ADULT_AGE);
+  f.zoo.AddAnimal(CreateFromSpecies(f.animal->species(), f.animal->age()));
+}
+
+static void SetupBirth(Fixture &f, const Population &p) {
+  SetupZoo(f, p);
+  f.animal = CreateFromSpecies(AnimalSpecies::SeaOtter, ANIMAL_ADULT_AGE);
+}
+
+// A copy of an animal from the middle of the zoo, for the fork to remove.
+static void SetupFork(Fixture &f, const Population &p) {
+  SetupZoo(f, p);
+  const Animal &a = f.zoo.NthAnimal(f.zoo.NumberOfAnimals() / 2);
+  f.animal = CreateFromSpecies(a.species(), a.age());
+}
+
+static void SetupLedger(Fixture &f, const Population &p) {
+  f.account.reset(new BankAccount(p.account));
+}
+
+static void SetupGame(Fixture &f, const Population &p) {
+  f.game.reset(new Game(Player(BankAccount(BENCH_BALANCE), Zoo(p.zoo)),
+                        f.null_os, std::mt19937(BENCH_SEED)));
+  f.game->Start();
+}
+
+static void IncrementAgesOp(Fixture &f) {
+  f.zoo.IncrementAnimalAges();
+}
+
+static void FeedingCostOp(Fixture &f) {
+  f.sink += f.zoo.FeedingCost(FoodType::Regular, DEFAULT_BASE_FOOD_COST);
+}
+
+static void RevenueOp(Fixture &f) {
+  f.sink += f.zoo.TotalDailyRevenue(None);
+}
+
+static void CountsOp(Fixture &f) {
+  f.sink += f.zoo.AdultsAndBabiesForEachSpecies().size();
+}
+
+// Removes the zoo's last animal and puts it back.
+static void RemoveOp(Fixture &f) {
+  f.zoo.RemoveAnimal(*f.animal);
+  f.zoo.AddAnimal(CreateFromSpecies(f.animal->species(), f.animal->age()));
+}
+
+static void BirthOp(Fixture &f) {
+  f.sink += f.zoo.AnimalGiveBirth(*f.animal).size();
+}
+
+static void SpecialEventOp(Fixture &f) {
+  SpecialEvent event(f.zoo, FoodType::Regular, f.rng);
+  f.sink += static_cast<double>(event.type());
+}
+
+// Cheap food, which makes DrawEventType bias the event types.
+static void DrawEventTypeOp(Fixture &f) {
+  f.sink += static_cast<double>(
+      SpecialEvent::DrawEventType(FoodType::Cheap, f.rng));
+}
+
+static void WithdrawOp(Fixture &f) {
+  f.sink += f.account->Withdraw(1.0, "Feeding");
+}
+
+// Copies the zoo, as forking a game does, removes an animal from the
+// copy, as the forked game's first day might, and throws the copy away.
+static void CopyOp(Fixture &f) {
+  Zoo copy(f.zoo);
+  copy.RemoveAnimal(*f.animal);
+  f.sink += copy.NumberOfCohorts();
+}
+
+// One whole day of the game, played as ZooBatchEnv plays it.
+static void GameDayOp(Fixture &f) {
+  f.game->ChooseFood(FoodType::Regular);
+  f.game->ChooseMainAction(PlayerMainAction::EndTurn);
+  f.game->NextDay();
+}
+
+static const Benchmark BENCHMARKS[] = {
+  {"Zoo::IncrementAnimalAges", true, false, SetupZoo, IncrementAgesOp},
+  {"Zoo::FeedingCost", true, false, SetupZoo, FeedingCostOp},
+  {"Zoo::TotalDailyRevenue", true, false, SetupZoo, RevenueOp},
+  {"Zoo::AdultsAndBabiesForEachSpecies", true, false, SetupZoo, CountsOp},
+  {"Zoo::RemoveAnimal", true, false, SetupRemove, RemoveOp},
+  {"Zoo::AnimalGiveBirth", true, false, SetupBirth, BirthOp},
+  {"Zoo copy", true, true, SetupFork, CopyOp},
+  {"SpecialEvent::SpecialEvent", true, false, SetupZoo, SpecialEventOp},
+  {"SpecialEvent::DrawEventType", true, false, SetupZoo, DrawEventTypeOp},
+  {"BankAccount::Withdraw", false, false, SetupLedger, WithdrawOp},
+  {"GameTurn day", true, false, SetupGame, GameDayOp},
+};
+
+// The measurements of one benchmark at one population and species mix.
+struct BenchResult {
+  std::string name;
+  unsigned long long population = 0;
+  std::string mix;
+  std::vector<double> ns_per_op;  // One per sample.
+  double bytes_per_op = 0.0;
+  double misses_per_op = -1.0;  // Negative if not measured.
+};
+
+/*********************************************************************
+** Function: TimeOps
+** Description: Sets up a fresh fixture and times a number of operations
+ * on it, after one untimed operation to warm it up (and to make it copy
+ * the animals it shares with the synthetic zoo, if it changes them).
+** Parameters: b is the benchmark; p is the population to start from;
+ * iters is the number of operations to time; misses, if it
+ * is not null, counts cache misses; bytes and cache_misses receive what
+ * the timed operations allocated and missed.
+** Pre-Conditions: iters > 0
+** Post-Conditions: Returns the time the operations took, in seconds.
+*********************************************************************/
+static double TimeOps(const Benchmark &b, const Population &p,
+                      std::uint64_t iters,
+                      CacheMissCounter *misses, std::size_t &bytes,
+                      std::uint64_t &cache_misses) {
+  Fixture f;
+  b.setup(f, p);
+  b.op(f);
+
+  std::size_t bytes_before = AllocatedBytes();
+  if (misses) misses->Start();
+  auto start = std::chrono::steady_clock::now();
+  for (std::uint64_t i = 0; i != iters; ++i)
+    b.op(f);
+  auto end = std::chrono::steady_clock::now();
+  cache_misses = misses ? misses->Stop() : 0;
+  bytes = AllocatedBytes() - bytes_before;
+
+  bench_sink = f.sink;
+  return std::chrono::duration<double>(end - start).count();
+}
+
+/*********************************************************************
+** Function: RunBenchmark
+** Description: Measures a benchmark: finds how many operations make a
+ * sample take at least min_time, then takes the samples.
+** Parameters: b is the benchmark; p is the population to start from;
+ * samples and min_time are as given on the command line;
+ * misses counts cache misses if it is available.
+** Pre-Conditions: samples > 0
+** Post-Conditions: None
+*********************************************************************/
+static BenchResult RunBenchmark(const Benchmark &b, const Population &p,
+                                unsigned samples,
+                                double min_time, CacheMissCounter &misses) {
+  std::size_t bytes;
+  std::uint64_t cache_misses;
+  std::uint64_t iters = 1;
+  double seconds;
+  while ((seconds = TimeOps(b, p, iters, nullptr, bytes,
+                            cache_misses)) < min_time)
+    iters = seconds > 0.0 ?
+        std::max(iters + 1, static_cast<std::uint64_t>(
+            iters * 1.2 * min_time / seconds)) : iters * 10;
+
+  BenchResult result;
+  std::size_t total_bytes = 0;
+  std::uint64_t total_misses = 0;
+  for (unsigned s = 0; s != samples; ++s) {
+    seconds = TimeOps(b, p, iters,
+                      misses.available() ? &misses : nullptr, bytes,
+                      cache_misses);
+    result.ns_per_op.push_back(seconds * 1e9 / iters);
+    total_bytes += bytes;
+    total_misses += cache_misses;
+  }
+
+  result.bytes_per_op = static_cast<double>(total_bytes) / samples / iters;
+  if (misses.available())
+    result.misses_per_op =
+        static_cast<double>(total_misses) / samples / iters;
+  return result;
+}
+
+/*********************************************************************
+** Function: Median
+** Description: Returns the median of some values.
+** Parameters: v holds the values.
+** Pre-Conditions: !v.empty()
+** Post-Conditions: None
+*********************************************************************/
+static double Median(std::vector<double> v) {
+  std::sort(v.begin(), v.end());
+  std::size_t mid = v.size() / 2;
+  return v.size() % 2 ? v[mid] : (v[mid - 1] + v[mid]) / 2;
+}
+
+/*********************************************************************
+** Function: JsonString
+** Description: Quotes a string for JSON.
+** Parameters: s is the string.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+static std::string JsonString(const std::string &s) {
+  std::string quoted = "\"";
+  for (char c : s) {
+    if (c == '"' || c == '\\') quoted += '\\';
+    if (static_cast<unsigned char>(c) >= ' ') quoted += c;
+  }
+  return quoted + '"';
+}
+
+/*********************************************************************
+** Function: CpuModel
+** Description: Returns the name of the machine's processor, if the
+ * system tells.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+static std::string CpuModel() {
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(cpuinfo, line)) {
+    if (line.compare(0, 10, "model name") != 0) continue;
+    std::string::size_type colon = line.find(':');
+    if (colon != std::string::npos && colon + 2 <= line.size())
+      return line.substr(colon + 2);
+  }
+  return "unknown";
+}
+
+/*********************************************************************
+** Function: WriteJson
+** Description: Writes the results, with the machine, compiler and
+ * settings they were measured with.
+** Parameters: path is the file to write; results are the results;
+ * samples and min_time are the settings.
+** Pre-Conditions: None
+** Post-Conditions: Returns false if the file could not be written.
+*********************************************************************/
+static bool WriteJson(const std::string &path,
+                      const std::vector<BenchResult> &results,
+                      unsigned samples, double min_time) {
+  std::string os = "unknown";
+#ifdef __linux__
+  utsname u;
+  if (uname(&u) == 0)
+    os = std::string(u.sysname) + ' ' + u.release + ' ' + u.machine;
+#endif
+  char date[32];
+  std::time_t now = std::time(nullptr);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+  std::ofstream out(path);
+  out.precision(17);
+  out << "{\n  \"metadata\": {\n"
+      << "    \"date\": " << JsonString(date) << ",\n"
+      << "    \"cpu\": " << JsonString(CpuModel()) << ",\n"
+      << "    \"threads\": " << std::thread::hardware_concurrency() << ",\n"
+      << "    \"os\": " << JsonString(os) << ",\n"
+      << "    \"compiler\": " << JsonString(__VERSION__) << ",\n"
+      << "    \"cplusplus\": " << __cplusplus << ",\n"
+#ifdef __OPTIMIZE__
+      << "    \"optimized\": true,\n"
+#else
+      << "    \"optimized\": false,\n"
+#endif
+      << "    \"samples\": " << samples << ",\n"
+      << "    \"min_time\": " << min_time << "\n  },\n"
+      << "  \"benchmarks\": [";
+  for (std::size_t i = 0; i != results.size(); ++i) {
+    const BenchResult &r = results[i];
+    out << (i ? ",\n" : "\n") << "    {\"name\": " << JsonString(r.name)
+        << ", \"population\": " << r.population
+        << ", \"mix\": " << JsonString(r.mix)
+        << ", \"bytes_per_op\": " << r.bytes_per_op
+        << ", \"misses_per_op\": ";
+    if (r.misses_per_op < 0) out << "null";
+    else out << r.misses_per_op;
+    out << ", \"ns_per_op\": [";
+    for (std::size_t j = 0; j != r.ns_per_op.size(); ++j)
+      out << (j ? ", " : "") << r.ns_per_op[j];
+    out << "]}";
+  }
+  out << "\n  ]\n}\n";
+  return static_cast<bool>(out);
+}
+
+/*********************************************************************
+** Function: MaxForkBytes
+** Description: Returns the most a fork of a zoo of n animals may
+ * allocate; copying all of it costs about 80 bytes an animal.
+** Parameters: n is the number of animals.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+static double MaxForkBytes(unsigned long long n) {
+  return BENCH_FORK_SLACK_BYTES + BENCH_FORK_BYTES_PER_ANIMAL * n;
+}
+
+int main(int argc, char **argv) {
+  std::string filter, json_path;
+  unsigned long long max_population = BENCH_MAX_POPULATION;
+  unsigned samples = BENCH_SAMPLES;
+  double min_time = BENCH_MIN_SAMPLE_TIME;
+  for (int i = 1; i < argc; ++i) {
+    if (i + 1 < argc && std::strcmp(argv[i], "--filter") == 0) {
+      filter = argv[++i];
+    } else if (i + 1 < argc &&
+               std::strcmp(argv[i], "--max-population") == 0) {
+      max_population =
+          static_cast<unsigned long long>(std::strtod(argv[++i], nullptr));
+    } else if (i + 1 < argc && std::strcmp(argv[i], "--samples") == 0) {
+      samples = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (i + 1 < argc && std::strcmp(argv[i], "--min-time") == 0) {
+      min_time = std::strtod(argv[++i], nullptr);
+    } else if (i + 1 < argc && std::strcmp(argv[i], "--json") == 0) {
+      json_path = argv[++i];
+    } else {
+      std::cerr << "Usage: " << argv[0] << " [--filter text]"
+                << " [--max-population n] [--samples n]"
+                << " [--min-time seconds] [--json file]" << std::endl;
+      return 1;
+    }
+  }
+  if (samples == 0) {
+    std::cerr << "--samples must be at least 1" << std::endl;
+    return 1;
+  }
+
+  CacheMissCounter misses;
+  std::vector<BenchResult> results;
+  bool forks_copy_too_much = false;
+  std::printf("%-36s %11s %-9s %12s %10s %10s\n", "benchmark", "population",
+              "mix", "ns/op", "bytes/op", "misses/op");
+  for (unsigned long long n = BENCH_MIN_POPULATION; n <= max_population;
+       n *= BENCH_POPULATION_STEP) {
+    for (const SpeciesMix &mix : MIXES) {
+      // Made once the first benchmark needs them.
+      std::unique_ptr<Population> p(new Population);
+      bool have_zoo = false, have_ledger = false;
+      for (const Benchmark &b : BENCHMARKS) {
+        if (std::string(b.name).find(filter) == std::string::npos) continue;
+        if (!b.per_animal && &mix != MIXES) continue;
+        if (b.per_animal && !have_zoo) {
+          p->zoo = MakeZoo(n, mix);
+          have_zoo = true;
+        }
+        if (!b.per_animal && !have_ledger) {
+          for (unsigned long long i = 0; i != n; ++i)
+            p->account.Withdraw(1.0, "Feeding");
+          have_ledger = true;
+        }
+
+        BenchResult r = RunBenchmark(b, *p, samples, min_time, misses);
+        r.name = b.name;
+        r.population = n;
+        r.mix = b.per_animal ? mix.name : "-";
+        results.push_back(r);
+        std::printf("%-36s %11llu %-9s %12.1f %10.1f ", b.name, n,
+                    r.mix.c_str(), Median(r.ns_per_op),
+                    r.bytes_per_op);
+        if (r.misses_per_op < 0) std::printf("%10s\n", "n/a");
+        else std::printf("%10.2f\n", r.misses_per_op);
+        if (b.forks && r.bytes_per_op > MaxForkBytes(n)) {
+          std::printf("%s allocated more than %.1f bytes/op: the fork copied"
+                      " what it did not change\n", b.name, MaxForkBytes(n));
+          forks_copy_too_much = true;
+        }
+        std::fflush(stdout);
+      }
+    }
+  }
+
+  if (!json_path.empty() &&
+      !WriteJson(json_path, results, samples, min_time)) {
+    std::cerr << "Cannot write " << json_path << std::endl;
+    return 1;
+  }
+
+  return forks_copy_too_much ? 1 : 0;
+}
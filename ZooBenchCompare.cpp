@@ -0,0 +1,414 @@
+/*********************************************************************
+** Program Filename: ZooBenchCompare.cpp
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Compares two sets of zoo_bench results, as written by
+ * zoo_bench --json, and flags the benchmarks that got slower. A change
+ * only counts if the medians differ by more than the threshold and a
+ * Mann-Whitney U test over the samples finds it significant, so that
+ * noise alone does not flag anything; that takes at least 4 samples on
+ * each side (zoo_bench takes 5 by default).
+ * Usage: ./zoo_bench_compare [--threshold percent] [--alpha p]
+ *     [--gate text]... baseline.json current.json
+** Input: Command line arguments: --threshold is the least change in the
+ * median that counts (default 5%); --alpha is the significance level
+ * (default 0.05); --gate names the benchmarks that fail the comparison
+ * when they get slower, as text their names start with (default Zoo::
+ * and GameTurn, the daily tick's hot paths; others are only reported);
+ * the baseline and current results.
+** Output: A line per benchmark found in both files; exits with 1 if a
+ * gated benchmark got slower.
+*********************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+static constexpr double COMPARE_THRESHOLD_PERCENT = 5.0;
+static constexpr double COMPARE_ALPHA = 0.05;
+static const char *const COMPARE_GATES[] = {"Zoo::", "GameTurn"};
+
+// Just enough JSON for zoo_bench's results.
+struct JsonValue {
+  enum class Type { Null, Bool, Number, String, Array, Object };
+
+  Type type = Type::Null;
+  bool boolean = false;
+  double number = 0.0;
+  std::string string;
+  std::vector<JsonValue> array;
+  std::vector<std::pair<std::string, JsonValue>> object;
+
+  const JsonValue *Find(const std::string &key) const;
+};
+
+/*********************************************************************
+** Function: Find
+** Description: Looks up a member of an object.
+** Parameters: key is the member's name.
+** Pre-Conditions: None
+** Post-Conditions: Returns null if this is not an object or has no such
+ * member.
+*********************************************************************/
+const JsonValue *JsonValue::Find(const std::string &key) const {
+  for (const auto &member : object)
+    if (member.first == key) return &member.second;
+  return nullptr;
+}
+
+// Parses JSON text by recursive descent.
+class JsonParser {
+  public:
+    explicit JsonParser(const std::string &text):
+        p_(text.c_str()), end_(text.c_str() + text.size()) {}
+
+    bool Parse(JsonValue &v);
+
+  private:
+    const char *p_;
+    const char *end_;
+
+    bool Consume(char c);
+    bool ParseString(std::string &s);
+    void SkipSpace();
+};
+
+/*********************************************************************
+** Function: SkipSpace
+** Description: Skips whitespace.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void JsonParser::SkipSpace() {
+  while (p_ != end_ && *p_ && std::strchr(" \t\r\n", *p_)) ++p_;
+}
+
+/*********************************************************************
+** Function: Consume
+** Description: Skips whitespace and then the given character.
+** Parameters: c is the character.
+** Pre-Conditions: None
+** Post-Conditions: Returns false, consuming nothing but whitespace, if
+ * the next character is not c.
+*********************************************************************/
+bool JsonParser::Consume(char c) {
+  SkipSpace();
+  if (p_ == end_ || *p_ != c) return false;
+  ++p_;
+  return true;
+}
+
+/*********************************************************************
+** Function: ParseString
+** Description: Parses a string; \u escapes are kept as they are, since
+ * zoo_bench does not write them.
+** Parameters: s receives the string.
+** Pre-Conditions: None
+** Post-Conditions: Returns false if there is no valid string next.
+*********************************************************************/
+bool JsonParser::ParseString(std::string &s) {
+  if (!Consume('"')) return false;
+  s.clear();
+  while (p_ != end_ && *p_ != '"') {
+    if (*p_ == '\\') {
+      if (++p_ == end_) return false;
+      switch (*p_) {
+        case 'n': s += '\n'; break;
+        case 't': s += '\t'; break;
+        case 'r': s += '\r'; break;
+        case 'b': s += '\b'; break;
+        case 'f': s += '\f'; break;
+        case 'u': s += "\\u"; break;
+        default: s += *p_;
+      }
+    } else {
+      s += *p_;
+    }
+    ++p_;
+  }
+  return Consume('"');
+}
+
+/*********************************************************************
+** Function: Parse
+** Description: Parses the next value.
+** Parameters: v receives the value.
+** Pre-Conditions: None
+** Post-Conditions: Returns false if there is no valid value next.
+*********************************************************************/
+bool JsonParser::Parse(JsonValue &v) {
+  SkipSpace();
+  if (p_ == end_) return false;
+
+  if (*p_ == '{') {
+    v.type = JsonValue::Type::Object;
+    ++p_;
+    if (Consume('}')) return true;
+    do {
+      std::pair<std::string, JsonValue> member;
+      if (!ParseString(member.first) || !Consume(':') ||
+          !Parse(member.second))
+        return false;
+      v.object.push_back(std::move(member));
+    } while (Consume(','));
+    return Consume('}');
+  }
+  if (*p_ == '[') {
+    v.type = JsonValue::Type::Array;
+    ++p_;
+    if (Consume(']')) return true;
+    do {
+      v.array.emplace_back();
+      if (!Parse(v.array.back())) return false;
+    } while (Consume(','));
+    return Consume(']');
+  }
+  if (*p_ == '"') {
+    v.type = JsonValue::Type::String;
+    return ParseString(v.string);
+  }
+  for (const char *word : {"null", "true", "false"}) {
+    std::size_t n = std::strlen(word);
+    if (static_cast<std::size_t>(end_ - p_) >= n &&
+        std::strncmp(p_, word, n) == 0) {
+      v.type = *word == 'n' ? JsonValue::Type::Null : JsonValue::Type::Bool;
+      v.boolean = *word == 't';
+      p_ += n;
+      return true;
+    }
+  }
+
+  char *number_end;
+  v.type = JsonValue::Type::Number;
+  v.number = std::strtod(p_, &number_end);
+  if (number_end == p_) return false;
+  p_ = number_end;
+  return true;
+}
+
+// A benchmark's identity within a results file: its name, population and
+// species mix.
+using BenchKey = std::tuple<std::string, unsigned long long, std::string>;
+
+// One results file.
+struct BenchResults {
+  JsonValue metadata;
+  std::map<BenchKey, std::vector<double>> samples;
+  std::vector<BenchKey> order;
+};
+
+/*********************************************************************
+** Function: ReadResults
+** Description: Reads a results file written by zoo_bench --json.
+** Parameters: path is the file; results receives its contents; error
+ * receives the reason it could not be read.
+** Pre-Conditions: None
+** Post-Conditions: Returns false if the file could not be read.
+*********************************************************************/
+static bool ReadResults(const std::string &path, BenchResults &results,
+                        std::string &error) {
+  std::ifstream in(path);
+  if (!in) {
+    error = "cannot open it";
+    return false;
+  }
+  std::stringstream buffer;
+  buffer << in.rdbuf();
+  std::string text = buffer.str();
+
+  JsonValue root;
+  JsonParser parser(text);
+  const JsonValue *benchmarks;
+  if (!parser.Parse(root) ||
+      !(benchmarks = root.Find("benchmarks")) ||
+      benchmarks->type != JsonValue::Type::Array) {
+    error = "not zoo_bench results";
+    return false;
+  }
+  if (const JsonValue *metadata = root.Find("metadata"))
+    results.metadata = *metadata;
+
+  for (const JsonValue &b : benchmarks->array) {
+    const JsonValue *name = b.Find("name"), *population = b.Find("population");
+    const JsonValue *mix = b.Find("mix"), *ns = b.Find("ns_per_op");
+    if (!name || !population || !mix || !ns ||
+        ns->type != JsonValue::Type::Array) {
+      error = "a benchmark is missing its name, population, mix or samples";
+      return false;
+    }
+
+    BenchKey key(name->string,
+                 static_cast<unsigned long long>(population->number),
+                 mix->string);
+    std::vector<double> &samples = results.samples[key];
+    if (samples.empty()) results.order.push_back(key);
+    for (const JsonValue &sample : ns->array)
+      samples.push_back(sample.number);
+  }
+  return true;
+}
+
+/*********************************************************************
+** Function: Median
+** Description: Returns the median of some values.
+** Parameters: v holds the values.
+** Pre-Conditions: !v.empty()
+** Post-Conditions: None
+*********************************************************************/
+static double Median(std::vector<double> v) {
+  std::sort(v.begin(), v.end());
+  std::size_t mid = v.size() / 2;
+  return v.size() % 2 ? v[mid] : (v[mid - 1] + v[mid]) / 2;
+}
+
+/*********************************************************************
+** Function: MannWhitneyP
+** Description: Returns the two-sided p-value of a Mann-Whitney U test of
+ * whether two sets of samples come from the same distribution, by the
+ * normal approximation with a continuity and tie correction.
+** Parameters: a and b are the samples.
+** Pre-Conditions: Neither is empty.
+** Post-Conditions: None
+*********************************************************************/
+static double MannWhitneyP(const std::vector<double> &a,
+                           const std::vector<double> &b) {
+  double n1 = a.size(), n2 = b.size(), n = n1 + n2;
+  double u = 0.0;
+  for (double x : a)
+    for (double y : b)
+      u += x > y ? 1.0 : x == y ? 0.5 : 0.0;
+
+  std::vector<double> all(a);
+  all.insert(all.end(), b.begin(), b.end());
+  std::sort(all.begin(), all.end());
+  double ties = 0.0;
+  for (std::size_t i = 0, j; i != all.size(); i = j) {
+    for (j = i; j != all.size() && all[j] == all[i]; ++j) {}
+    double t = static_cast<double>(j - i);
+    ties += t * t * t - t;
+  }
+
+  double variance = n1 * n2 / 12.0 * ((n + 1) - ties / (n * (n - 1)));
+  if (variance <= 0.0) return 1.0;
+  double z = std::max(0.0, std::fabs(u - n1 * n2 / 2) - 0.5) /
+             std::sqrt(variance);
+  return std::erfc(z / std::sqrt(2.0));
+}
+
+/*********************************************************************
+** Function: MetadataString
+** Description: Returns a metadata field as text, for comparing them.
+** Parameters: metadata is the metadata; key is the field.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+static std::string MetadataString(const JsonValue &metadata,
+                                  const std::string &key) {
+  const JsonValue *v = metadata.Find(key);
+  if (!v) return "?";
+  std::ostringstream os;
+  if (v->type == JsonValue::Type::String) os << v->string;
+  else if (v->type == JsonValue::Type::Bool) os << v->boolean;
+  else os << v->number;
+  return os.str();
+}
+
+int main(int argc, char **argv) {
+  double threshold = COMPARE_THRESHOLD_PERCENT, alpha = COMPARE_ALPHA;
+  std::vector<std::string> gates, paths;
+  for (int i = 1; i < argc; ++i) {
+    if (i + 1 < argc && std::strcmp(argv[i], "--threshold") == 0) {
+      threshold = std::strtod(argv[++i], nullptr);
+    } else if (i + 1 < argc && std::strcmp(argv[i], "--alpha") == 0) {
+      alpha = std::strtod(argv[++i], nullptr);
+    } else if (i + 1 < argc && std::strcmp(argv[i], "--gate") == 0) {
+      gates.push_back(argv[++i]);
+    } else if (argv[i][0] != '-') {
+      paths.push_back(argv[i]);
+    } else {
+      paths.clear();
+      break;
+    }
+  }
+  if (paths.size() != 2) {
+    std::cerr << "Usage: " << argv[0] << " [--threshold percent]"
+              << " [--alpha p] [--gate text]... baseline.json current.json"
+              << std::endl;
+    return 2;
+  }
+  if (gates.empty()) gates.assign(std::begin(COMPARE_GATES),
+                                  std::end(COMPARE_GATES));
+
+  BenchResults baseline, current;
+  std::string error;
+  for (int i = 0; i != 2; ++i) {
+    if (!ReadResults(paths[i], i ? current : baseline, error)) {
+      std::cerr << "Cannot read " << paths[i] << ": " << error << std::endl;
+      return 2;
+    }
+  }
+
+  for (const char *key : {"cpu", "threads", "compiler", "optimized"}) {
+    std::string a = MetadataString(baseline.metadata, key);
+    std::string b = MetadataString(current.metadata, key);
+    if (a != b)
+      std::cout << "Warning: the results differ in " << key << " (" << a
+                << " vs " << b << "), so they may not be comparable.\n";
+  }
+
+  unsigned regressions = 0, compared = 0;
+  std::printf("%-36s %11s %-9s %12s %12s %8s %7s  %s\n", "benchmark",
+              "population", "mix", "baseline ns", "current ns", "change",
+              "p", "verdict");
+  for (const BenchKey &key : current.order) {
+    auto base = baseline.samples.find(key);
+    if (base == baseline.samples.end()) continue;
+    const std::vector<double> &a = base->second;
+    const std::vector<double> &b = current.samples[key];
+    if (a.empty() || b.empty()) continue;
+    ++compared;
+
+    const std::string &name = std::get<0>(key);
+    bool gated = false;
+    for (const std::string &g : gates)
+      gated = gated || name.compare(0, g.size(), g) == 0;
+
+    double median_a = Median(a), median_b = Median(b);
+    double change = median_a > 0 ? (median_b / median_a - 1) * 100 : 0.0;
+    double p = MannWhitneyP(a, b);
+    const char *verdict = "same";
+    if (p < alpha && change > threshold) {
+      verdict = gated ? "SLOWER" : "slower (not gated)";
+      regressions += gated;
+    } else if (p < alpha && change < -threshold) {
+      verdict = "faster";
+    }
+
+    std::printf("%-36s %11llu %-9s %12.1f %12.1f %+7.1f%% %7.3f  %s\n",
+                name.c_str(), std::get<1>(key), std::get<2>(key).c_str(),
+                median_a, median_b, change, p, verdict);
+  }
+
+  if (compared != current.order.size() ||
+      compared != baseline.order.size())
+    std::cout << "Only " << compared << " benchmarks are in both files."
+              << std::endl;
+  if (regressions) {
+    std::cout << regressions << " gated benchmark(s) got slower by more than "
+              << threshold << "%." << std::endl;
+    return 1;
+  }
+  std::cout << "No gated benchmark got slower by more than " << threshold
+            << "%." << std::endl;
+  return 0;
+}
@@ -0,0 +1,887 @@
+/*********************************************************************
+** Program Filename: ZooDiffTest.cpp
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Plays randomized games with three engines side by side,
+ * comparing every game's summary after every day: a simple per-animal
+ * reference model (ReferenceEngine, below), ZooBatchEnv, which runs the
+ * game itself on its cohort Zoo, and the optimized LockstepEngine. On the
+ * first mismatch it shrinks the failing game to a minimal reproduction
+ * and writes it to a file. Then it plays a few games of each species for
+ * as long as its lifespan, so that animals grow up and die of old age,
+ * and checks that a zoo whose animals die of old age stops growing: its
+ * cohorts, and with them its daily work, level off, and that
+ * ZooBatchEnv::Step() allocates nothing on days without births. Run by
+ * "make check" to gate changes to any of the engines.
+ * Usage: ./zoo_difftest [n_trials] [n_days] [seed]
+ *        ./zoo_difftest --repro file
+** Input: Command line arguments: the number of trials (default 16), each
+ * a batch of games played with one strategy; the number of days to play
+ * (default 400); the seed the games' seeds and actions are derived from
+ * (default 1). With --repro, a reproduction written by an earlier run.
+** Output: A summary on stdout; exits with 1 if the engines disagree or
+ * the cohorts keep growing or Step() allocates.
+*********************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include "GameTurn.h"
+#include "LockstepEngine.h"
+#include "TurnProfile.h"
+#include "ZooBatchEnv.h"
+
+static constexpr unsigned DIFF_TRIALS = 16;
+static constexpr unsigned DIFF_DAYS = 400;
+static constexpr std::size_t DIFF_GAMES_PER_TRIAL = 32;
+// ReferenceEngine pays for food an animal at a time, and Game a cohort at
+// a time, so their balances may differ by a cent, or by this much
+// relative to the balance if that is more. LockstepEngine must match
+// ZooBatchEnv exactly.
+static constexpr double DIFF_REFERENCE_BALANCE_TOLERANCE = 1e-9;
+static constexpr const char *DIFF_REPRO_FILE = "zoo_difftest.repro";
+// The long trials play this many games of each species for as long as its
+// lifespan, so that babies grow up and the animals bought die of old age.
+// They buy another animal on about one day in DIFF_LONG_BUY_DAYS, and draw
+// special events with DIFF_LONG_WEIGHTS (indexed by SpecialEventType),
+// which make births rare, so the zoos, and the games' ledgers, stay small.
+static constexpr std::size_t DIFF_LONG_GAMES = 2;
+static constexpr unsigned DIFF_LONG_BUY_DAYS = 1000;
+static const SpecialEventWeights DIFF_LONG_WEIGHTS = {{2.0, 0.02, 1.0, 8.0}};
+// The cohort check adds a cohort of newborns, and removes an animal,
+// every this many days, of each species in turn, and plays three of the
+// longest lifespans.
+static constexpr unsigned COHORT_CHECK_BIRTH_DAYS = 8;
+static constexpr unsigned COHORT_CHECK_BABIES = 3;
+static constexpr unsigned COHORT_CHECK_LIFESPANS = 3;
+// How many more cohorts, as a share, the last lifespan may peak at than
+// the one before by chance; a zoo that keeps every cohort peaks at about
+// half as many again.
+static constexpr double COHORT_CHECK_SLACK = 0.05;
+// The allocation check plays this many games, one at a time, buying two
+// animals on the first day and then ending the day on regular food.
+static constexpr unsigned ALLOC_CHECK_GAMES = 64;
+static constexpr unsigned ALLOC_CHECK_DAYS = 300;
+
+#ifdef ZOO_PROFILE
+// The turn profiler replaces operator new already, and counts for us.
+static std::uint64_t Allocations() {
+  return CurrentTurnProfile().allocations;
+}
+#else
+// Allocations made by operator new since the program started. The checks
+// are single-threaded.
+static std::uint64_t allocations = 0;
+
+static std::uint64_t Allocations() {
+  return allocations;
+}
+
+void *operator new(std::size_t size) {
+  ++allocations;
+  if (void *p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+
+// GCC 11 and up, seeing this inlined into the standard containers, take
+// the free for one that does not match their operator new.
+#if defined(__GNUC__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void *p) noexcept {
+  std::free(p);
+}
+#if defined(__GNUC__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+// The action minimization replaces others with: nothing happens today.
+static const ZooEnvAction NEUTRAL_ACTION =
+    {FoodType::Regular, PlayerMainAction::EndTurn, AnimalSpecies::Monkey, 1};
+
+/*********************************************************************
+** Function: RandomStrategy
+** Description: Any food, and a purchase of one or two animals on about
+ * one day in eight.
+** Parameters: a receives the day's action; rng is the random engine to
+ * use.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+static void RandomStrategy(ZooEnvAction &a, std::mt19937 &rng) {
+  std::uint32_t r = rng();
+  a.food = static_cast<FoodType>(r % 3);
+  a.action = (r >> 2) % 8 == 0 ? PlayerMainAction::BuyAnimal :
+                                 PlayerMainAction::EndTurn;
+  a.species = static_cast<AnimalSpecies>((r >> 5) % NUMBER_OF_SPECIES);
+  a.quantity = 1 + (r >> 7) % 2;
+}
+
+/*********************************************************************
+** Function: HoarderStrategy
+** Description: Cheap food, and two animals bought every other day, to
+ * grow big zoos and run into sickness and bankruptcy.
+** Parameters: a receives the day's action; rng is the random engine to
+ * use.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+static void HoarderStrategy(ZooEnvAction &a, std::mt19937 &rng) {
+  std::uint32_t r = rng();
+  a.food = FoodType::Cheap;
+  a.action = r % 2 ? PlayerMainAction::BuyAnimal : PlayerMainAction::EndTurn;
+  a.species = static_cast<AnimalSpecies>((r >> 1) % NUMBER_OF_SPECIES);
+  a.quantity = 2;
+}
+
+/*********************************************************************
+** Function: CarefulStrategy
+** Description: Premium food, and a single animal now and then.
+** Parameters: a receives the day's action; rng is the random engine to
+ * use.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+static void CarefulStrategy(ZooEnvAction &a, std::mt19937 &rng) {
+  std::uint32_t r = rng();
+  a.food = FoodType::Premium;
+  a.action = r % 20 == 0 ? PlayerMainAction::BuyAnimal :
+                           PlayerMainAction::EndTurn;
+  a.species = static_cast<AnimalSpecies>((r >> 5) % NUMBER_OF_SPECIES);
+  a.quantity = 1;
+}
+
+/*********************************************************************
+** Function: FickleStrategy
+** Description: Like RandomStrategy, but also quits on about one day in
+ * two hundred and tries every other main action.
+** Parameters: a receives the day's action; rng is the random engine to
+ * use.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+static void FickleStrategy(ZooEnvAction &a, std::mt19937 &rng) {
+  RandomStrategy(a, rng);
+  std::uint32_t r = rng();
+  if (r % 200 == 0) a.action = PlayerMainAction::QuitGame;
+  else if (r % 7 == 0)
+    a.action = static_cast<PlayerMainAction>((r >> 8) % 5);
+}
+
+using Strategy = void (*)(ZooEnvAction &, std::mt19937 &);
+struct NamedStrategy {
+  const char *name;
+  Strategy choose;
+};
+
+static const NamedStrategy STRATEGIES[] = {
+  {"random", RandomStrategy},
+  {"hoarder", HoarderStrategy},
+  {"careful", CarefulStrategy},
+  {"fickle", FickleStrategy},
+};
+
+// ReferenceEngine plays the same games as ZooBatchEnv the simple way the
+// game did before it kept its animals in cohorts: one Animal per animal,
+// in the order they were added, with every day's deaths, aging, feeding,
+// events and revenue handled animal by animal. It is far too slow to play
+// big zoos with, and is only here to check the other two engines against.
+class ReferenceEngine {
+  public:
+    explicit ReferenceEngine(std::size_t n_games):
+        games_(n_games),
+        observations_(n_games * ZOO_ENV_OBSERVATION_SIZE, 0.0),
+        dones_(n_games, 1) {}
+
+    std::size_t size() const { return games_.size(); }
+
+    const unsigned char *dones() const { return dones_.data(); }
+    const double *observations() const { return observations_.data(); }
+
+    void Reset(const std::uint32_t *seeds);
+    void Step(const ZooEnvAction *actions);
+
+  private:
+    struct ReferenceGame {
+      double balance = 0.0;
+      double base_food_cost = 0.0;
+      unsigned day = 0;
+      std::mt19937 rng_engine;
+      AnimalsVec animals;
+    };
+    std::vector<ReferenceGame> games_;
+
+    std::vector<double> observations_;
+    std::vector<unsigned char> dones_;
+
+    static bool FeedNewAnimals(ReferenceGame &g, std::size_t first,
+                               FoodType food);
+    void Observe(std::size_t i);
+    void PlayDay(std::size_t i, const ZooEnvAction &action);
+};
+
+/*********************************************************************
+** Function: Reset
+** Description: Starts a new game in every slot.
+** Parameters: seeds holds size() seeds, one per game; see
+ * ZooBatchEnv::Reset.
+** Pre-Conditions: None
+** Post-Conditions: Every game is on day one and not done.
+*********************************************************************/
+void ReferenceEngine::Reset(const std::uint32_t *seeds) {
+  for (std::size_t i = 0; i != size(); ++i) {
+    ReferenceGame &g = games_[i];
+    g.balance = PLAYER_STARTING_BALANCE;
+    g.base_food_cost = DEFAULT_BASE_FOOD_COST;
+    g.day = 0;
+    g.rng_engine.seed(seeds[i]);
+    g.animals.clear();
+    dones_[i] = 0;
+    Observe(i);
+  }
+}
+
+/*********************************************************************
+** Function: Step
+** Description: Plays one day in every game that is not done.
+** Parameters: actions holds size() actions, one per game.
+** Pre-Conditions: Reset has been called.
+** Post-Conditions: See ZooBatchEnv::Step.
+*********************************************************************/
+void ReferenceEngine::Step(const ZooEnvAction *actions) {
+  for (std::size_t i = 0; i != size(); ++i) {
+    if (dones_[i]) continue;
+    PlayDay(i, actions[i]);
+    Observe(i);
+  }
+}
+
+/*********************************************************************
+** Function: PlayDay
+** Description: Plays one day of a game in the order a GameTurn does:
+ * deaths of old age, the special event's draws, aging, feeding, the
+ * special event, the main action, revenue and the next day's base food
+ * cost.
+** Parameters: i is the index of the game; action is the day's decisions.
+** Pre-Conditions: The game is not done.
+** Post-Conditions: None
+*********************************************************************/
+void ReferenceEngine::PlayDay(std::size_t i, const ZooEnvAction &action) {
+  ReferenceGame &g = games_[i];
+  AnimalsVec &animals = g.animals;
+  ++g.day;
+
+  animals.erase(std::remove_if(animals.begin(), animals.end(),
+                               [](const std::unique_ptr<Animal> &a) {
+                                 return a->age() >= a->lifespan();
+                               }),
+                animals.end());
+
+  SpecialEventType event =
+      SpecialEvent::DrawEventType(action.food, g.rng_engine);
+  const Animal *event_animal = nullptr;
+  Option<unsigned> bonus_revenue = None;
+  if (event == SpecialEventType::SickAnimal && !animals.empty()) {
+    event_animal = animals[SpecialEvent::DrawIndex(
+        animals.size(), g.rng_engine)].get();
+  } else if (event == SpecialEventType::AnimalBirth) {
+    std::vector<const Animal *> adults;
+    for (const auto &a : animals)
+      if (a->IsAdult()) adults.push_back(a.get());
+    if (!adults.empty())
+      event_animal = adults[SpecialEvent::DrawIndex(
+          adults.size(), g.rng_engine)];
+  } else if (event == SpecialEventType::ZooAttendanceBoom) {
+    bonus_revenue = SpecialEvent::DrawBonusRevenue(g.rng_engine);
+  }
+
+  for (const auto &a : animals) a->IncrementAge();
+
+  // Nothing is fed unless the whole dollars of every animal's food can be
+  // paid for; then each animal is fed if it can be afforded.
+  double whole_cost = 0.0;
+  for (const auto &a : animals)
+    whole_cost += static_cast<unsigned>(
+        a->FoodCost(action.food, g.base_food_cost));
+  if (whole_cost <= g.balance) {
+    for (const auto &a : animals) {
+      double cost = a->FoodCost(action.food, g.base_food_cost);
+      if (cost <= g.balance) g.balance -= cost;
+    }
+  }
+
+  if (event_animal && event == SpecialEventType::AnimalBirth) {
+    std::size_t first = animals.size();
+    for (auto &baby : event_animal->GiveBirth())
+      animals.push_back(std::move(baby));
+    if (!FeedNewAnimals(g, first, action.food)) {
+      dones_[i] = 1;
+      return;
+    }
+  } else if (event_animal) {
+    if (event_animal->SickCareCost() <= g.balance) {
+      g.balance -= event_animal->SickCareCost();
+    } else {
+      // The first animal like the sick one dies, as in Zoo::RemoveAnimal.
+      AnimalSpecies s = event_animal->species();
+      unsigned age = event_animal->age();
+      animals.erase(std::find_if(animals.begin(), animals.end(),
+                                 [&](const std::unique_ptr<Animal> &a) {
+                                   return a->species() == s && a->age() == age;
+                                 }));
+    }
+  }
+
+  if (action.action == PlayerMainAction::BuyAnimal && action.quantity) {
+    unsigned qty = std::min(action.quantity, MAX_ANIMAL_PURCHASES);
+    unsigned cost = CreateFromSpecies(action.species, ANIMAL_ADULT_AGE)->cost();
+    if (cost * qty <= g.balance) {
+      std::size_t first = animals.size();
+      for (unsigned n = 0; n != qty; ++n) {
+        g.balance -= cost;
+        animals.push_back(CreateFromSpecies(action.species, ANIMAL_ADULT_AGE));
+      }
+      if (!FeedNewAnimals(g, first, action.food)) {
+        dones_[i] = 1;
+        return;
+      }
+    }
+  } else if (action.action == PlayerMainAction::QuitGame) {
+    dones_[i] = 1;
+    return;
+  }
+
+  for (const auto &a : animals) g.balance += a->DailyRevenue(bonus_revenue);
+  g.base_food_cost = Game::DrawBaseFoodCost(g.base_food_cost, g.rng_engine);
+}
+
+/*********************************************************************
+** Function: FeedNewAnimals
+** Description: Feeds the animals at the end of a game's zoo, one by one.
+** Parameters: g is the game; first is the index of the first of them;
+ * food is the day's food.
+** Pre-Conditions: None
+** Post-Conditions: Returns false (the player is bankrupt) if one of them
+ * could not be fed.
+*********************************************************************/
+bool ReferenceEngine::FeedNewAnimals(ReferenceGame &g, std::size_t first,
+                                     FoodType food) {
+  for (std::size_t k = first; k != g.animals.size(); ++k) {
+    double cost = g.animals[k]->FoodCost(food, g.base_food_cost);
+    if (!(cost <= g.balance)) return false;
+    g.balance -= cost;
+  }
+
+  return true;
+}
+
+/*********************************************************************
+** Function: Observe
+** Description: Writes the observation of the given game, in the layout
+ * ZooBatchEnv uses.
+** Parameters: i is the index of the game.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void ReferenceEngine::Observe(std::size_t i) {
+  const ReferenceGame &g = games_[i];
+  double *obs = &observations_[i * ZOO_ENV_OBSERVATION_SIZE];
+  std::fill(obs, obs + ZOO_ENV_OBSERVATION_SIZE, 0.0);
+
+  obs[ZOO_ENV_OBS_BALANCE] = g.balance;
+  obs[ZOO_ENV_OBS_BASE_FOOD_COST] = g.base_food_cost;
+  obs[ZOO_ENV_OBS_DAY] = g.day;
+  for (const auto &a : g.animals) {
+    unsigned s = SpeciesIndex(a->species());
+    if (a->IsAdult()) ++obs[ZOO_ENV_OBS_ADULTS + s];
+    if (a->IsBaby()) ++obs[ZOO_ENV_OBS_BABIES + s];
+  }
+}
+
+/*********************************************************************
+** Function: SameGame
+** Description: Compares one game's summary from two engines.
+** Parameters: a and b are the engines; i is the game; exact is whether
+ * their balances must be the same to the bit.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+template <class A, class B>
+static bool SameGame(const A &a, const B &b, std::size_t i, bool exact) {
+  if (a.dones()[i] != b.dones()[i]) return false;
+
+  const double *x = a.observations() + i * ZOO_ENV_OBSERVATION_SIZE;
+  const double *y = b.observations() + i * ZOO_ENV_OBSERVATION_SIZE;
+  for (std::size_t j = 0; j != ZOO_ENV_OBSERVATION_SIZE; ++j) {
+    double tolerance = j == ZOO_ENV_OBS_BALANCE && !exact ?
+        std::max(0.01, DIFF_REFERENCE_BALANCE_TOLERANCE * std::fabs(y[j])) :
+        0.0;
+    if (std::fabs(x[j] - y[j]) > tolerance) return false;
+  }
+
+  return true;
+}
+
+/*********************************************************************
+** Function: SameDay
+** Description: Compares one game's summary from all three engines.
+** Parameters: engine, model and env are the engines; i is the game.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+static bool SameDay(const LockstepEngine &engine,
+                    const ReferenceEngine &model, const ZooBatchEnv &env,
+                    std::size_t i) {
+  return SameGame(engine, env, i, true) && SameGame(model, env, i, false);
+}
+
+/*********************************************************************
+** Function: PrintSummary
+** Description: Prints one game's summary from one engine.
+** Parameters: name names the engine; e is the engine; i is the game.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+template <class E>
+static void PrintSummary(const char *name, const E &e, std::size_t i) {
+  const double *obs = e.observations() + i * ZOO_ENV_OBSERVATION_SIZE;
+  std::cout.precision(17);
+  std::cout << name << " (done " << int(e.dones()[i]) << "):";
+  for (std::size_t j = 0; j != ZOO_ENV_OBSERVATION_SIZE; ++j)
+    std::cout << ' ' << obs[j];
+  std::cout << std::endl;
+}
+
+/*********************************************************************
+** Function: PrintGame
+** Description: Prints one game's summary from all three engines.
+** Parameters: engine, model and env are the engines; i is the game.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+static void PrintGame(const LockstepEngine &engine,
+                      const ReferenceEngine &model, const ZooBatchEnv &env,
+                      std::size_t i) {
+  PrintSummary("lockstep", engine, i);
+  PrintSummary("per-animal", model, i);
+  PrintSummary("game", env, i);
+}
+
+/*********************************************************************
+** Function: FirstMismatch
+** Description: Plays one game with all three engines.
+** Parameters: seed is the game's seed; actions are its actions, one per
+ * day; print is whether to print both summaries at the mismatch.
+** Pre-Conditions: None
+** Post-Conditions: Returns the first day the engines disagree on, or 0
+ * if they agree on every day.
+*********************************************************************/
+static unsigned FirstMismatch(std::uint32_t seed,
+                              const std::vector<ZooEnvAction> &actions,
+                              bool print = false) {
+  LockstepEngine engine(1);
+  ReferenceEngine model(1);
+  ZooBatchEnv env(1);
+  engine.Reset(&seed);
+  model.Reset(&seed);
+  env.Reset(&seed);
+
+  for (std::size_t day = 0; day != actions.size(); ++day) {
+    engine.Step(&actions[day]);
+    model.Step(&actions[day]);
+    env.Step(&actions[day]);
+    if (!SameDay(engine, model, env, 0)) {
+      if (print) PrintGame(engine, model, env, 0);
+      return static_cast<unsigned>(day + 1);
+    }
+  }
+
+  return 0;
+}
+
+/*********************************************************************
+** Function: IsNeutral
+** Description: Checks whether an action does nothing but end the day on
+ * regular food.
+** Parameters: a is the action.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+static bool IsNeutral(const ZooEnvAction &a) {
+  return a.food == FoodType::Regular &&
+         a.action == PlayerMainAction::EndTurn;
+}
+
+/*********************************************************************
+** Function: Minimize
+** Description: Shrinks a failing game: drops the days after the first
+ * mismatch, then replaces actions with NEUTRAL_ACTION one at a time for
+ * as long as the engines still disagree, until no single action can be
+ * replaced.
+** Parameters: seed is the game's seed; actions are its actions, which
+ * are shrunk in place.
+** Pre-Conditions: FirstMismatch(seed, actions) != 0
+** Post-Conditions: Returns the day the engines first disagree on when
+ * playing the shrunk actions.
+*********************************************************************/
+static unsigned Minimize(std::uint32_t seed,
+                         std::vector<ZooEnvAction> &actions) {
+  unsigned day = FirstMismatch(seed, actions);
+  actions.resize(day);
+
+  for (bool shrunk = true; shrunk;) {
+    shrunk = false;
+    for (std::size_t d = 0; d < actions.size(); ++d) {
+      if (IsNeutral(actions[d])) continue;
+
+      ZooEnvAction saved = actions[d];
+      actions[d] = NEUTRAL_ACTION;
+      unsigned mismatch = FirstMismatch(seed, actions);
+      if (mismatch) {
+        day = mismatch;
+        actions.resize(day);
+        shrunk = true;
+      } else {
+        actions[d] = saved;
+      }
+    }
+  }
+
+  return day;
+}
+
+/*********************************************************************
+** Function: WriteRepro
+** Description: Writes a reproduction: the game's seed, then one action
+ * per day as "food action species quantity" (the enums' values).
+** Parameters: path is the file to write; seed and actions describe the
+ * game.
+** Pre-Conditions: None
+** Post-Conditions: Returns false if the file could not be written.
+*********************************************************************/
+static bool WriteRepro(const std::string &path, std::uint32_t seed,
+                       const std::vector<ZooEnvAction> &actions) {
+  std::ofstream out(path);
+  out << "seed " << seed << '\n';
+  for (const auto &a : actions)
+    out << static_cast<unsigned>(a.food) << ' '
+        << static_cast<unsigned>(a.action) << ' '
+        << static_cast<unsigned>(a.species) << ' ' << a.quantity << '\n';
+  return static_cast<bool>(out);
+}
+
+/*********************************************************************
+** Function: ReadRepro
+** Description: Reads a reproduction written by WriteRepro.
+** Parameters: path is the file to read; seed and actions receive the
+ * game.
+** Pre-Conditions: None
+** Post-Conditions: Returns false if the file could not be read.
+*********************************************************************/
+static bool ReadRepro(const std::string &path, std::uint32_t &seed,
+                      std::vector<ZooEnvAction> &actions) {
+  std::ifstream in(path);
+  std::string word;
+  if (!(in >> word >> seed) || word != "seed") return false;
+
+  unsigned food, action, species, quantity;
+  while (in >> food >> action >> species >> quantity) {
+    if (food > static_cast<unsigned>(FoodType::Cheap) ||
+        action > static_cast<unsigned>(PlayerMainAction::QuitGame) ||
+        species >= NUMBER_OF_SPECIES)
+      return false;
+    actions.push_back(ZooEnvAction{
+        static_cast<FoodType>(food), static_cast<PlayerMainAction>(action),
+        static_cast<AnimalSpecies>(species), quantity});
+  }
+
+  return in.eof();
+}
+
+/*********************************************************************
+** Function: RunRepro
+** Description: Plays a reproduction with all three engines.
+** Parameters: path is the reproduction.
+** Pre-Conditions: None
+** Post-Conditions: Returns the program's exit status.
+*********************************************************************/
+static int RunRepro(const std::string &path) {
+  std::uint32_t seed;
+  std::vector<ZooEnvAction> actions;
+  if (!ReadRepro(path, seed, actions)) {
+    std::cerr << "Cannot read " << path << std::endl;
+    return 2;
+  }
+
+  unsigned day = FirstMismatch(seed, actions, true);
+  if (day) {
+    std::cout << "The engines disagree on day " << day << " of game seed "
+              << seed << '.' << std::endl;
+    return 1;
+  }
+  std::cout << "The engines agree on all " << actions.size()
+            << " days of game seed " << seed << '.' << std::endl;
+  return 0;
+}
+
+/*********************************************************************
+** Function: RunLongTrials
+** Description: Plays DIFF_LONG_GAMES games of each species with all
+ * three engines for as long as the species' lifespan, comparing them
+ * after every day. A mismatch is printed, but not minimized, since
+ * replaying a game that long once per action would take too long.
+** Parameters: seed is the seed the games' seeds and actions are derived
+ * from.
+** Pre-Conditions: No game is being played.
+** Post-Conditions: Returns false if the engines disagree. The event
+ * weights are as they were.
+*********************************************************************/
+static bool RunLongTrials(std::uint32_t seed) {
+  SpecialEventWeights weights = SpecialEvent::EventWeights();
+  std::string error;
+  SpecialEvent::SetEventWeights(DIFF_LONG_WEIGHTS, error);
+
+  const std::size_t n = DIFF_LONG_GAMES;
+  std::vector<std::uint32_t> seeds(n);
+  std::vector<ZooEnvAction> actions(n);
+  bool agree = true;
+  for (unsigned s = 0; s != NUMBER_OF_SPECIES && agree; ++s) {
+    AnimalSpecies species = static_cast<AnimalSpecies>(s);
+    std::unique_ptr<Animal> animal = CreateFromSpecies(species, 0);
+    std::mt19937 action_rng(seed + s);
+    for (std::size_t i = 0; i != n; ++i)
+      seeds[i] = seed + static_cast<std::uint32_t>(s * n + i);
+
+    LockstepEngine engine(n);
+    ReferenceEngine model(n);
+    ZooBatchEnv env(n);
+    engine.Reset(seeds.data());
+    model.Reset(seeds.data());
+    env.Reset(seeds.data());
+
+    for (unsigned day = 0; day != animal->lifespan(); ++day) {
+      for (ZooEnvAction &a : actions) {
+        std::uint32_t r = action_rng();
+        a.food = static_cast<FoodType>(r % 3);
+        a.action = day == 0 || (r >> 2) % DIFF_LONG_BUY_DAYS == 0 ?
+            PlayerMainAction::BuyAnimal : PlayerMainAction::EndTurn;
+        a.species = species;
+        a.quantity = day == 0 ? MAX_ANIMAL_PURCHASES : 1;
+      }
+      engine.Step(actions.data());
+      model.Step(actions.data());
+      env.Step(actions.data());
+
+      std::size_t bad = 0;
+      while (bad != n && SameDay(engine, model, env, bad)) ++bad;
+      if (bad == n) continue;
+
+      std::cout << "Mismatch in the long trial of " << animal->name()
+                << "s, game seed " << seeds[bad] << ", on day " << day + 1
+                << ":\n";
+      PrintGame(engine, model, env, bad);
+      agree = false;
+      break;
+    }
+  }
+
+  SpecialEvent::SetEventWeights(weights, error);
+  if (agree)
+    std::cout << "The engines agree on " << n << " games of each species, "
+              << "played for as long as its lifespan." << std::endl;
+  return agree;
+}
+
+/*********************************************************************
+** Function: CheckCohortsLevelOff
+** Description: Plays a zoo's days the way GameTurn does (deaths of old
+ * age, then aging, feeding and revenue), adding a cohort of newborns
+ * and removing one animal, as a sickness would, every
+ * COHORT_CHECK_BIRTH_DAYS days. Once the longest lifespan has gone by,
+ * births and deaths balance out, so the zoo's largest number of cohorts
+ * over the last lifespan played must be no greater than over the one
+ * before, give or take COHORT_CHECK_SLACK. The time a day takes over
+ * both is printed too, but not checked, since it depends on the machine.
+** Parameters: seed is the seed of the draws of the animals removed.
+** Pre-Conditions: None
+** Post-Conditions: Returns false if the cohorts kept growing.
+*********************************************************************/
+static bool CheckCohortsLevelOff(std::uint32_t seed) {
+  unsigned lifespan = 0;
+  for (unsigned s = 0; s != NUMBER_OF_SPECIES; ++s)
+    lifespan = std::max(
+        lifespan, CreateFromSpecies(static_cast<AnimalSpecies>(s), 0)->
+            lifespan());
+
+  std::mt19937 rng(seed);
+  Zoo zoo;
+  std::vector<AnimalsVec::size_type> max_cohorts(COHORT_CHECK_LIFESPANS);
+  std::vector<double> seconds(COHORT_CHECK_LIFESPANS);
+  for (unsigned day = 0; day != COHORT_CHECK_LIFESPANS * lifespan; ++day) {
+    auto start = std::chrono::steady_clock::now();
+    zoo.RemoveExpiredAnimals();
+    zoo.IncrementAnimalAges();
+    zoo.FeedingCost(FoodType::Regular, DEFAULT_BASE_FOOD_COST);
+    zoo.TotalDailyRevenue(None);
+
+    if (day % COHORT_CHECK_BIRTH_DAYS == 0) {
+      unsigned s = day / COHORT_CHECK_BIRTH_DAYS % NUMBER_OF_SPECIES;
+      zoo.AddAnimal(CreateFromSpecies(static_cast<AnimalSpecies>(s), 0),
+                    COHORT_CHECK_BABIES);
+    }
+    if (day % COHORT_CHECK_BIRTH_DAYS == COHORT_CHECK_BIRTH_DAYS / 2 &&
+        zoo.NumberOfAnimals()) {
+      const Animal &a = zoo.NthAnimal(
+          SpecialEvent::DrawIndex(zoo.NumberOfAnimals(), rng));
+      std::unique_ptr<Animal> sick = CreateFromSpecies(a.species(), a.age());
+      zoo.RemoveAnimal(*sick);
+    }
+
+    unsigned span = day / lifespan;
+    max_cohorts[span] = std::max(max_cohorts[span], zoo.NumberOfCohorts());
+    seconds[span] += std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+  }
+
+  unsigned last = COHORT_CHECK_LIFESPANS - 1;
+  std::cout << "Over its last two lifespans, a zoo with deaths of old age "
+            << "had at most " << max_cohorts[last - 1] << " and "
+            << max_cohorts[last] << " cohorts, and took "
+            << seconds[last - 1] * 1e6 / lifespan << " and "
+            << seconds[last] * 1e6 / lifespan << " us a day." << std::endl;
+  return max_cohorts[last] <=
+         max_cohorts[last - 1] * (1.0 + COHORT_CHECK_SLACK);
+}
+
+/*********************************************************************
+** Function: CheckStepAllocations
+** Description: Plays ALLOC_CHECK_GAMES games of ZooBatchEnv, each of a
+ * species in turn, and counts the allocations each day's Step() makes.
+ * Only a birth may allocate, for the newborns, so the days on which the
+ * zoo has animals aged 0 are skipped; on every other day, sicknesses,
+ * deaths and bonuses included, Step() must not allocate at all.
+** Parameters: seed is the first game's seed.
+** Pre-Conditions: None
+** Post-Conditions: Returns false if Step() allocated on a day without
+ * a birth.
+*********************************************************************/
+static bool CheckStepAllocations(std::uint32_t seed) {
+  unsigned long days = 0, allocating_days = 0;
+  std::uint64_t made_on_those_days = 0;
+  for (unsigned g = 0; g != ALLOC_CHECK_GAMES; ++g) {
+    std::uint32_t game_seed = seed + g;
+    ZooBatchEnv env(1);
+    env.Reset(&game_seed);
+    ZooEnvAction action = {FoodType::Regular, PlayerMainAction::BuyAnimal,
+                           static_cast<AnimalSpecies>(g % NUMBER_OF_SPECIES),
+                           MAX_ANIMAL_PURCHASES};
+    env.Step(&action);
+    action.action = PlayerMainAction::EndTurn;
+
+    for (unsigned day = 1; day != ALLOC_CHECK_DAYS && !env.dones()[0];
+         ++day) {
+      std::uint64_t before = Allocations();
+      env.Step(&action);
+      std::uint64_t made = Allocations() - before;
+      if (env.game(0).player().zoo().CountAnimalsAged(0, 0)) continue;
+
+      ++days;
+      made_on_those_days += made;
+      if (made) ++allocating_days;
+    }
+  }
+
+  std::cout << "ZooBatchEnv::Step() made " << made_on_those_days
+            << " allocations over " << days << " days without births."
+            << std::endl;
+  return allocating_days == 0;
+}
+
+int main(int argc, char **argv) {
+  if (argc == 3 && std::strcmp(argv[1], "--repro") == 0)
+    return RunRepro(argv[2]);
+
+  unsigned n_trials = argc > 1 ?
+      static_cast<unsigned>(std::strtoul(argv[1], nullptr, 10)) :
+      DIFF_TRIALS;
+  unsigned n_days = argc > 2 ?
+      static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : DIFF_DAYS;
+  std::uint32_t seed = argc > 3 ?
+      static_cast<std::uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 1;
+
+  const std::size_t n = DIFF_GAMES_PER_TRIAL;
+  const std::size_t n_strategies = sizeof(STRATEGIES) / sizeof(STRATEGIES[0]);
+  std::vector<std::uint32_t> seeds(n);
+  // history[d * n + i] is game i's action on day d + 1.
+  std::vector<ZooEnvAction> history;
+
+  for (unsigned trial = 0; trial != n_trials; ++trial) {
+    const NamedStrategy &strategy = STRATEGIES[trial % n_strategies];
+    std::mt19937 action_rng(seed + trial);
+    for (std::size_t i = 0; i != n; ++i)
+      seeds[i] = seed + static_cast<std::uint32_t>(trial * n + i);
+
+    LockstepEngine engine(n);
+    ReferenceEngine model(n);
+    ZooBatchEnv env(n);
+    engine.Reset(seeds.data());
+    model.Reset(seeds.data());
+    env.Reset(seeds.data());
+    history.assign(static_cast<std::size_t>(n_days) * n, ZooEnvAction());
+
+    for (unsigned day = 0; day != n_days; ++day) {
+      ZooEnvAction *actions = &history[day * n];
+      for (std::size_t i = 0; i != n; ++i)
+        strategy.choose(actions[i], action_rng);
+      engine.Step(actions);
+      model.Step(actions);
+      env.Step(actions);
+
+      std::size_t bad = 0;
+      while (bad != n && SameDay(engine, model, env, bad)) ++bad;
+      if (bad == n) continue;
+
+      std::cout << "Mismatch in trial " << trial << " (" << strategy.name
+                << " strategy), game seed " << seeds[bad] << ", on day "
+                << day + 1 << ":\n";
+      PrintGame(engine, model, env, bad);
+
+      std::vector<ZooEnvAction> game_actions;
+      for (unsigned d = 0; d <= day; ++d)
+        game_actions.push_back(history[d * n + bad]);
+      unsigned min_day = Minimize(seeds[bad], game_actions);
+      std::size_t kept = std::count_if(
+          game_actions.begin(), game_actions.end(),
+          [](const ZooEnvAction &a) { return !IsNeutral(a); });
+
+      std::cout << "Minimized to " << min_day << " days with " << kept
+                << " non-trivial actions:\n";
+      FirstMismatch(seeds[bad], game_actions, true);
+      if (WriteRepro(DIFF_REPRO_FILE, seeds[bad], game_actions))
+        std::cout << "Reproduce with: " << argv[0] << " --repro "
+                  << DIFF_REPRO_FILE << std::endl;
+      return 1;
+    }
+  }
+
+  std::cout << "The engines agree on " << n_trials * n << " games of "
+            << n_days << " days." << std::endl;
+  if (!RunLongTrials(seed)) return 1;
+
+  if (!CheckCohortsLevelOff(seed)) {
+    std::cout << "The zoo's cohorts keep growing." << std::endl;
+    return 1;
+  }
+  if (!CheckStepAllocations(seed)) return 1;
+  return 0;
+}
@@ -0,0 +1,77 @@
+/*********************************************************************
+** Program Filename: ZooDigest.cpp
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Implements functions declared by the ZooDigest class.
+** Input: None
+** Output: None
+*********************************************************************/
+#include "Utils.h"
+#include "ZooDigest.h"
+
+/*********************************************************************
+** Function: PowBase
+** Description: Returns ZOO_DIGEST_BASE^n (mod 2^64), in O(log n).
+** Parameters: n is the exponent.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+static std::uint64_t PowBase(unsigned n) {
+  std::uint64_t result = 1, base = ZOO_DIGEST_BASE;
+  for (; n; n >>= 1) {
+    if (n & 1) result *= base;
+    base *= base;
+  }
+  return result;
+}
+
+/*********************************************************************
+** Function: value
+** Description: Returns the digest.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+std::uint64_t ZooDigest::value() const {
+  std::uint64_t h = 0;
+  for (std::uint64_t sum : sums_)
+    h = Mix64(h ^ sum);
+  return h;
+}
+
+/*********************************************************************
+** Function: Add
+** Description: Accounts for animals added to the zoo.
+** Parameters: s and age are the animals' species and age; count is the
+ * number of animals.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void ZooDigest::Add(AnimalSpecies s, unsigned age, unsigned long count) {
+  sums_[SpeciesIndex(s)] += count * PowBase(age);
+}
+
+/*********************************************************************
+** Function: AgeAll
+** Description: Accounts for every animal in the zoo aging.
+** Parameters: by is the number of days they aged by.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void ZooDigest::AgeAll(unsigned by) {
+  std::uint64_t factor = PowBase(by);
+  for (std::uint64_t &sum : sums_)
+    sum *= factor;
+}
+
+/*********************************************************************
+** Function: Remove
+** Description: Accounts for animals removed from the zoo.
+** Parameters: s and age are the animals' species and age; count is the
+ * number of animals.
+** Pre-Conditions: The zoo had such animals.
+** Post-Conditions: None
+*********************************************************************/
+void ZooDigest::Remove(AnimalSpecies s, unsigned age, unsigned long count) {
+  sums_[SpeciesIndex(s)] -= count * PowBase(age);
+}
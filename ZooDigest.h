@@ -0,0 +1,38 @@
+#ifndef ZOO_TYCOON_ZOODIGEST_H
+#define ZOO_TYCOON_ZOODIGEST_H
+/*********************************************************************
+** Program Filename: ZooDigest.h
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Declares the ZooDigest class and its related members.
+** Input: None
+** Output: None
+*********************************************************************/
+
+
+#include <array>
+#include <cstdint>
+#include "AnimalSpecies.h"
+
+// ZooDigest is a 64-bit digest of the animals in a zoo, as a multiset of
+// (species, age), kept up to date in O(1) per change. For each species it
+// holds the sum of ZOO_DIGEST_BASE^age over the species' animals (mod
+// 2^64), so aging every animal by a day is a single multiplication.
+static constexpr std::uint64_t ZOO_DIGEST_BASE = 0x9E3779B97F4A7C15ULL;
+
+class ZooDigest {
+  public:
+    ZooDigest() { sums_.fill(0); }
+
+    std::uint64_t value() const;
+
+    void Add(AnimalSpecies s, unsigned age, unsigned long count = 1);
+    void AgeAll(unsigned by);
+    void Remove(AnimalSpecies s, unsigned age, unsigned long count = 1);
+
+  private:
+    std::array<std::uint64_t, NUMBER_OF_SPECIES> sums_;
+};
+
+
+#endif //ZOO_TYCOON_ZOODIGEST_H
@@ -0,0 +1,70 @@
+/*********************************************************************
+** Program Filename: ZooDigestDiff.cpp
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Compares the per-day digests of two runs of a game, as
+ * written by ZooTycoon --digest, and reports the first day they differ.
+ * Usage: ./zoo_digest_diff digest_file_a digest_file_b
+** Input: Command line arguments: the two digest files.
+** Output: The first day the runs differ, or that they agree; exits with
+ * 0 only if they agree on every day.
+*********************************************************************/
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+/*********************************************************************
+** Function: ReadDigest
+** Description: Reads the next day's digest from a digest file.
+** Parameters: is is the file; day and digest receive the day and its
+ * digest.
+** Pre-Conditions: None
+** Post-Conditions: Returns false at the end of the file, or if the line
+ * cannot be read.
+*********************************************************************/
+static bool ReadDigest(std::istream &is, unsigned &day,
+                       std::uint64_t &digest) {
+  return static_cast<bool>(is >> std::dec >> day >> std::hex >> digest);
+}
+
+int main(int argc, char **argv) {
+  if (argc != 3) {
+    std::cerr << "Usage: " << argv[0] << " digest_file_a digest_file_b"
+              << std::endl;
+    return 2;
+  }
+
+  std::ifstream a(argv[1]), b(argv[2]);
+  if (!a || !b) {
+    std::cerr << "Cannot open " << (a ? argv[2] : argv[1]) << std::endl;
+    return 2;
+  }
+
+  unsigned day_a, day_b, days = 0;
+  std::uint64_t digest_a, digest_b;
+  for (;;) {
+    bool more_a = ReadDigest(a, day_a, digest_a);
+    bool more_b = ReadDigest(b, day_b, digest_b);
+    if (!more_a && !more_b) break;
+
+    if (more_a != more_b) {
+      std::cout << "Run " << (more_a ? "B" : "A") << " ends after "
+                << days << " days; run " << (more_a ? "A" : "B")
+                << " goes on to day " << (more_a ? day_a : day_b) << '.'
+                << std::endl;
+      return 1;
+    }
+    if (day_a != day_b || digest_a != digest_b) {
+      std::cout << "Runs diverge on day " << day_a;
+      if (day_b != day_a) std::cout << " (day " << day_b << " in run B)";
+      std::cout << ": " << std::hex << digest_a << " vs " << digest_b
+                << std::dec << '.' << std::endl;
+      return 1;
+    }
+    ++days;
+  }
+
+  std::cout << "Runs agree on all " << days << " days." << std::endl;
+  return 0;
+}
@@ -0,0 +1,226 @@
+/*********************************************************************
+** Program Filename: ZooLoadGen.cpp
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Load generator for the Zoo Tycoon server. Opens many
+ * sessions at once and plays each of them with random menu choices for
+ * a number of days, then reports throughput.
+ * Usage: ./zoo_loadgen [socket_path] [n_sessions] [n_days]
+** Input: Command line arguments: the server socket path (default
+ * /tmp/zoo_tycoon.sock), the number of concurrent sessions (default
+ * 1000) and the number of days each session plays (default 20).
+** Output: A summary of the run on stdout. Exits with status 1 unless
+ * every session played all its days or went bankrupt.
+*********************************************************************/
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static constexpr const char *LOADGEN_SOCKET_PATH = "/tmp/zoo_tycoon.sock";
+static constexpr unsigned LOADGEN_SESSIONS = 1000;
+static constexpr unsigned LOADGEN_DAYS = 20;
+// How much of a session's most recent output is kept to find menus in.
+static constexpr std::size_t LOADGEN_TAIL_SIZE = 2048;
+
+// Prompts after which the server waits for a line of input.
+static const std::string OPTION_PROMPT = "Enter option: ";
+static const std::string NEXT_DAY_PROMPT = "continue to the next day...";
+// What the server prints before closing a session whose zoo went
+// bankrupt, which is a game played to its end, not a dropped session.
+static const std::string GAME_OVER_TEXT = "GAME OVER";
+
+struct LoadSession {
+  int fd = -1;
+  unsigned days = 0;
+  // The end of the output received since the last line was sent.
+  std::string tail;
+};
+
+/*********************************************************************
+** Function: EndsWith
+** Description: Returns whether s ends with suffix.
+** Parameters: s is the string to check; suffix is the ending to look for.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+static bool EndsWith(const std::string &s, const std::string &suffix) {
+  return s.size() >= suffix.size() &&
+         s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+/*********************************************************************
+** Function: ChooseOption
+** Description: Picks a menu option from the menu at the end of the
+ * output, like a (very) casual player would: end the turn half of the
+ * time, otherwise anything but quitting.
+** Parameters: tail is the output containing the menu; rng is the random
+ * engine to use.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+static std::string ChooseOption(const std::string &tail, std::mt19937 &rng) {
+  std::vector<std::string> options;
+  std::string end_turn;
+
+  std::string::size_type pos = tail.rfind("option from below:");
+  if (pos == std::string::npos) pos = 0;
+
+  while ((pos = tail.find('\n', pos)) != std::string::npos) {
+    ++pos;
+    std::string::size_type paren = tail.find(") ", pos);
+    std::string::size_type eol = tail.find('\n', pos);
+    if (paren == std::string::npos || paren > eol) continue;
+
+    std::string number = tail.substr(pos, paren - pos);
+    std::string text = tail.substr(paren + 2, eol - paren - 2);
+    if (text == "Quit game.") continue;
+    if (text == "End the current turn.") end_turn = number;
+    options.push_back(number);
+  }
+
+  if (options.empty()) return "1";
+  if (!end_turn.empty() && rng() % 2 == 0) return end_turn;
+  return options[rng() % options.size()];
+}
+
+/*********************************************************************
+** Function: Connect
+** Description: Opens a connection to the server.
+** Parameters: path is the server's socket path.
+** Pre-Conditions: None
+** Post-Conditions: Returns the socket, or -1 on failure.
+*********************************************************************/
+static int Connect(const std::string &path) {
+  sockaddr_un addr = {};
+  addr.sun_family = AF_UNIX;
+  std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd == -1) return -1;
+  if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+/*********************************************************************
+** Function: Respond
+** Description: Sends the next line of input if the session's output ends
+ * with a prompt; closes the session once it has played enough days.
+** Parameters: s is the session; n_days is the number of days to play;
+ * rng is the random engine; inputs counts the lines sent.
+** Pre-Conditions: None
+** Post-Conditions: Returns false if the session is finished.
+*********************************************************************/
+static bool Respond(LoadSession &s, unsigned n_days, std::mt19937 &rng,
+                    unsigned long &inputs) {
+  std::string line;
+  if (EndsWith(s.tail, NEXT_DAY_PROMPT)) {
+    if (++s.days >= n_days) return false;
+    line = "\n";
+  } else if (EndsWith(s.tail, OPTION_PROMPT)) {
+    line = ChooseOption(s.tail, rng) + '\n';
+  } else {
+    return true;
+  }
+
+  s.tail.clear();
+  ++inputs;
+  return send(s.fd, line.data(), line.size(), MSG_NOSIGNAL) ==
+         static_cast<ssize_t>(line.size());
+}
+
+int main(int argc, char **argv) {
+  std::string path = argc > 1 ? argv[1] : LOADGEN_SOCKET_PATH;
+  unsigned n_sessions = argc > 2 ?
+      static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) :
+      LOADGEN_SESSIONS;
+  unsigned n_days = argc > 3 ?
+      static_cast<unsigned>(std::strtoul(argv[3], nullptr, 10)) :
+      LOADGEN_DAYS;
+
+  rlimit limit;
+  if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+  }
+  std::signal(SIGPIPE, SIG_IGN);
+
+  int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  std::vector<LoadSession> sessions(n_sessions);
+  auto start = std::chrono::steady_clock::now();
+
+  unsigned open = 0;
+  for (unsigned i = 0; i != n_sessions; ++i) {
+    sessions[i].fd = Connect(path);
+    if (sessions[i].fd == -1) {
+      std::perror("zoo_loadgen: connect");
+      break;
+    }
+
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.u32 = i;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, sessions[i].fd, &ev);
+    ++open;
+  }
+
+  std::mt19937 rng(12345);
+  unsigned long inputs = 0, finished = 0, bankrupt = 0, dropped = 0;
+  unsigned long long bytes = 0;
+  std::vector<epoll_event> events(256);
+  char buf[4096];
+
+  while (finished + bankrupt + dropped != open) {
+    int n = epoll_wait(epoll_fd, events.data(), events.size(), -1);
+    if (n < 0 && errno != EINTR) break;
+
+    for (int i = 0; i < n; ++i) {
+      LoadSession &s = sessions[events[i].data.u32];
+      ssize_t r = recv(s.fd, buf, sizeof(buf), 0);
+
+      bool alive = r > 0;
+      if (alive) {
+        bytes += static_cast<unsigned long long>(r);
+        s.tail.append(buf, static_cast<std::size_t>(r));
+        if (s.tail.size() > LOADGEN_TAIL_SIZE)
+          s.tail.erase(0, s.tail.size() - LOADGEN_TAIL_SIZE);
+        alive = Respond(s, n_days, rng, inputs);
+      }
+
+      if (!alive) {
+        if (s.days >= n_days) ++finished;
+        else if (s.tail.find(GAME_OVER_TEXT) != std::string::npos) ++bankrupt;
+        else ++dropped;
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, s.fd, nullptr);
+        close(s.fd);
+      }
+    }
+  }
+
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::cout << "Sessions: " << open << " (" << finished << " played "
+            << n_days << " days, " << bankrupt << " went bankrupt, "
+            << dropped << " ended early)\n"
+            << "Inputs sent: " << inputs << '\n'
+            << "Bytes received: " << bytes << '\n'
+            << "Elapsed: " << elapsed.count() << " s\n"
+            << "Inputs/s: " << inputs / elapsed.count() << std::endl;
+
+  close(epoll_fd);
+  return finished + bankrupt == n_sessions ? 0 : 1;
+}
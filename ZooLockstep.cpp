@@ -0,0 +1,240 @@
+/*********************************************************************
+** Program Filename: ZooLockstep.cpp
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Plays many headless games at once with the LockstepEngine,
+ * for parameter studies, and reports throughput. With --verify, also
+ * plays every game with ZooBatchEnv and checks that both agree.
+ * Usage: ./zoo_lockstep [n_games] [n_days] [seed] [--verify]
+ *     [--trace file] [--trace-every n]
+** Input: Command line arguments: the number of games (default 4096), the
+ * number of days to play (default 365), the seed the games' seeds and
+ * actions are derived from (default 1), and --verify. With --verify,
+ * --trace writes a Chrome trace of every n-th day (default every day) of
+ * the ZooBatchEnv games to file. Counts must be whole numbers of at
+ * least 1; any other argument prints the usage and exits with status 1.
+** Output: A summary of the run on stdout; with --verify, the first
+ * disagreement, if any.
+*********************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+#include "LockstepEngine.h"
+#include "Trace.h"
+#include "ZooBatchEnv.h"
+
+static constexpr std::size_t LOCKSTEP_GAMES = 4096;
+static constexpr unsigned LOCKSTEP_DAYS = 365;
+
+/*********************************************************************
+** Function: ChooseActions
+** Description: Picks every game's actions for the day like a simple,
+ * random strategy: any food, and a purchase of one or two animals on
+ * about one day in eight.
+** Parameters: actions receives one action per game; rng is the random
+ * engine to use.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+static void ChooseActions(std::vector<ZooEnvAction> &actions,
+                          std::mt19937 &rng) {
+  for (auto &a : actions) {
+    std::uint32_t r = rng();
+    a.food = static_cast<FoodType>(r % 3);
+    a.action = (r >> 2) % 8 == 0 ? PlayerMainAction::BuyAnimal :
+                                   PlayerMainAction::EndTurn;
+    a.species = static_cast<AnimalSpecies>((r >> 5) % NUMBER_OF_SPECIES);
+    a.quantity = 1 + (r >> 7) % 2;
+  }
+}
+
+/*********************************************************************
+** Function: FindMismatch
+** Description: Compares the games of both engines after a day.
+** Parameters: engine and env are the engines to compare.
+** Pre-Conditions: None
+** Post-Conditions: Returns the index of the first game that differs, or
+ * engine.size() if none does.
+*********************************************************************/
+static std::size_t FindMismatch(const LockstepEngine &engine,
+                                const ZooBatchEnv &env) {
+  for (std::size_t i = 0; i != engine.size(); ++i) {
+    if (engine.dones()[i] != env.dones()[i]) return i;
+
+    const double *a = engine.observations() + i * ZOO_ENV_OBSERVATION_SIZE;
+    const double *b = env.observations() + i * ZOO_ENV_OBSERVATION_SIZE;
+    for (std::size_t j = 0; j != ZOO_ENV_OBSERVATION_SIZE; ++j)
+      if (a[j] != b[j]) return i;
+  }
+
+  return engine.size();
+}
+
+/*********************************************************************
+** Function: PrintGame
+** Description: Prints one game's observation from both engines.
+** Parameters: i is the index of the game; engine and env are the engines.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+static void PrintGame(std::size_t i, const LockstepEngine &engine,
+                      const ZooBatchEnv &env) {
+  const double *a = engine.observations() + i * ZOO_ENV_OBSERVATION_SIZE;
+  const double *b = env.observations() + i * ZOO_ENV_OBSERVATION_SIZE;
+  std::cout.precision(17);
+  std::cout << "lockstep (done " << int(engine.dones()[i]) << "):";
+  for (std::size_t j = 0; j != ZOO_ENV_OBSERVATION_SIZE; ++j)
+    std::cout << ' ' << a[j];
+  std::cout << "\nscalar   (done " << int(env.dones()[i]) << "):";
+  for (std::size_t j = 0; j != ZOO_ENV_OBSERVATION_SIZE; ++j)
+    std::cout << ' ' << b[j];
+  std::cout << std::endl;
+}
+
+/*********************************************************************
+** Function: PrintUsage
+** Description: Prints how to run the lockstep driver.
+** Parameters: program is the name it was run as.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+static void PrintUsage(const char *program) {
+  std::cerr << "Usage: " << program << " [n_games] [n_days] [seed]"
+            << " [--verify]\n    [--trace file] [--trace-every n]\n"
+            << "n_games, n_days and n must be at least 1." << std::endl;
+}
+
+/*********************************************************************
+** Function: ParseNumber
+** Description: Reads a decimal number that fills all of text, so that a
+ * typo is not silently read as 0.
+** Parameters: text is the argument; max is the largest value accepted;
+ * value receives the number.
+** Pre-Conditions: None
+** Post-Conditions: Returns false, leaving value alone, if text is not a
+ * number of at most max.
+*********************************************************************/
+static bool ParseNumber(const char *text, unsigned long long max,
+                        unsigned long long &value) {
+  if (!std::isdigit(static_cast<unsigned char>(*text))) return false;
+  errno = 0;
+  char *end;
+  unsigned long long n = std::strtoull(text, &end, 10);
+  if (*end != '\0' || errno == ERANGE || n > max) return false;
+  value = n;
+  return true;
+}
+
+int main(int argc, char **argv) {
+  bool verify = false;
+  const char *trace_path = nullptr;
+  unsigned long long trace_every_days = DEFAULT_TRACE_EVERY_DAYS;
+  unsigned long long n_games = LOCKSTEP_GAMES, n_days = LOCKSTEP_DAYS;
+  unsigned long long seed = 1;
+  unsigned long long *positional[] = {&n_games, &n_days, &seed};
+  const unsigned long long positional_max[] = {
+      std::numeric_limits<std::size_t>::max(),
+      std::numeric_limits<unsigned>::max(),
+      std::numeric_limits<std::uint32_t>::max()};
+  std::size_t n_positional = 0;
+  bool ok = true;
+  for (int i = 1; ok && i < argc; ++i) {
+    if (std::strcmp(argv[i], "--verify") == 0) {
+      verify = true;
+    } else if (i + 1 < argc && std::strcmp(argv[i], "--trace") == 0) {
+      trace_path = argv[++i];
+    } else if (i + 1 < argc && std::strcmp(argv[i], "--trace-every") == 0) {
+      ok = ParseNumber(argv[++i], std::numeric_limits<unsigned>::max(),
+                       trace_every_days);
+    } else if (argv[i][0] == '-' || n_positional == 3) {
+      ok = false;
+    } else {
+      ok = ParseNumber(argv[i], positional_max[n_positional],
+                       *positional[n_positional]);
+      ++n_positional;
+    }
+  }
+  if (!ok || n_games == 0 || n_days == 0 || trace_every_days == 0) {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+
+  std::vector<std::uint32_t> seeds(n_games);
+  for (std::size_t i = 0; i != n_games; ++i)
+    seeds[i] = static_cast<std::uint32_t>(seed + i);
+  std::vector<ZooEnvAction> actions(n_games);
+  std::mt19937 action_rng(static_cast<std::uint32_t>(seed));
+
+  LockstepEngine engine(n_games);
+  engine.Reset(seeds.data());
+
+  if (trace_path) StartTracing(static_cast<unsigned>(trace_every_days));
+  std::unique_ptr<ZooBatchEnv> env;
+  if (verify) {
+    env.reset(new ZooBatchEnv(n_games));
+    env->Reset(seeds.data());
+  }
+
+  double lockstep_time = 0.0, scalar_time = 0.0;
+  unsigned long long game_days = 0;
+  for (unsigned day = 1; day <= n_days; ++day) {
+    ChooseActions(actions, action_rng);
+    for (std::size_t i = 0; i != n_games; ++i)
+      game_days += !engine.dones()[i];
+
+    auto start = std::chrono::steady_clock::now();
+    engine.Step(actions.data());
+    auto end = std::chrono::steady_clock::now();
+    lockstep_time += std::chrono::duration<double>(end - start).count();
+
+    if (!verify) continue;
+
+    start = std::chrono::steady_clock::now();
+    env->Step(actions.data());
+    end = std::chrono::steady_clock::now();
+    scalar_time += std::chrono::duration<double>(end - start).count();
+
+    std::size_t bad = FindMismatch(engine, *env);
+    if (bad != n_games) {
+      std::cout << "Mismatch in game " << bad << " (seed " << seeds[bad]
+                << ") on day " << day << ":\n";
+      PrintGame(bad, engine, *env);
+      return 1;
+    }
+  }
+
+  std::size_t over = 0;
+  double total_balance = 0.0;
+  for (std::size_t i = 0; i != n_games; ++i) {
+    over += engine.dones()[i];
+    total_balance +=
+        engine.observations()[i * ZOO_ENV_OBSERVATION_SIZE +
+                              ZOO_ENV_OBS_BALANCE];
+  }
+
+  std::cout << "Games: " << n_games << " (" << over << " over after "
+            << n_days << " days)\n"
+            << "Mean balance: $" << total_balance / n_games << '\n'
+            << "Game-days played: " << game_days << '\n'
+            << "Lockstep: " << lockstep_time << " s, "
+            << game_days / lockstep_time << " game-days/s\n";
+  if (verify)
+    std::cout << "Scalar: " << scalar_time << " s, "
+              << game_days / scalar_time << " game-days/s\n"
+              << "Both engines agree on every game and day." << '\n';
+  std::cout << std::flush;
+
+  if (trace_path && !WriteChromeTrace(trace_path)) {
+    std::cerr << "Cannot write " << trace_path << std::endl;
+    return 1;
+  }
+  return 0;
+}
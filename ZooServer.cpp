@@ -0,0 +1,79 @@
+/*********************************************************************
+** Program Filename: ZooServer.cpp
+** Author: Jason Chen
+** Date: 02/19/2018
+** Description: Runs the Zoo Tycoon game server, which hosts one game per
+ * connection on a Unix domain socket.
+ * Usage: ./zoo_server [socket_path] [n_threads]
+ * Play with e.g.: socat - UNIX-CONNECT:/tmp/zoo_tycoon.sock
+** Input: Command line arguments: the socket path (default
+ * /tmp/zoo_tycoon.sock) and the number of worker threads (default 4).
+** Output: Status messages on stdout.
+*********************************************************************/
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sys/resource.h>
+#include "GameServer.h"
+
+namespace {
+
+GameServer *running_server = nullptr;
+
+/*********************************************************************
+** Function: HandleSignal
+** Description: Stops the running server on SIGINT/SIGTERM.
+** Parameters: signum is the signal number (unused).
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void HandleSignal(int) {
+  if (running_server) running_server->Stop();
+}
+
+/*********************************************************************
+** Function: RaiseFileLimit
+** Description: Raises the open file limit to its hard maximum so that
+ * thousands of sessions can be connected at once.
+** Parameters: None
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+void RaiseFileLimit() {
+  rlimit limit;
+  if (getrlimit(RLIMIT_NOFILE, &limit) != 0) return;
+  limit.rlim_cur = limit.rlim_max;
+  setrlimit(RLIMIT_NOFILE, &limit);
+}
+
+}
+
+int main(int argc, char **argv) {
+  std::string path = argc > 1 ? argv[1] : DEFAULT_SERVER_SOCKET_PATH;
+  unsigned n_threads = argc > 2 ?
+      static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) :
+      DEFAULT_SERVER_THREADS;
+
+  RaiseFileLimit();
+  std::signal(SIGPIPE, SIG_IGN);
+
+  GameServer server(path, n_threads);
+  if (!server.Listen()) {
+    std::perror(("zoo_server: cannot listen on " + path).c_str());
+    return 1;
+  }
+
+  running_server = &server;
+  std::signal(SIGINT, HandleSignal);
+  std::signal(SIGTERM, HandleSignal);
+
+  std::cout << "Zoo Tycoon server listening on " << path << " with "
+            << (n_threads ? n_threads : 1) << " worker threads." << std::endl;
+  server.Run();
+  std::cout << "Shutting down with " << server.NumberOfSessions()
+            << " sessions open." << std::endl;
+
+  running_server = nullptr;
+  return 0;
+}
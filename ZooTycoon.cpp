@@ -2,21 +2,287 @@
 ** Program Filename: ZooTycoon.cpp
 ** Author: Jason Chen
 ** Date: 02/19/2018
-** Description: Runs the Zoo Tycoon game. 
-** Input: None
+** Description: Runs the Zoo Tycoon game.
+ * Usage: ./ZooTycoon [--load save_file | --restore prefix | --replay log]
+ *     [--replay-to-day n] [--record log] [--save save_file]
+ *     [--checkpoint prefix] [--checkpoint-days n] [--digest file]
+ *     [--profile] [--trace file] [--trace-every n]
+ *     [--metrics file | --metrics-csv file] [--population-events]
+ *     [--event-weights file]
+** Input: Command line arguments: --load carries on with the game saved in
+ * save_file; --restore carries on from the game's last checkpoint;
+ * --replay silently replays a recorded game, up to the end of day n if
+ * --replay-to-day is given, and then lets the player carry on; --record
+ * records a new or replayed game's seed and input to log; --save saves
+ * the game to save_file at the end of every day; --checkpoint checkpoints
+ * the game every n days (default 200); --digest writes the game's digest
+ * to file at the end of every day, for zoo_digest_diff; --profile prints
+ * where the game's time went (see TurnProfile) once it ends; --trace
+ * writes a Chrome trace of every n-th day (default every day) to file
+ * once it ends; --metrics and --metrics-csv stream the game's balance,
+ * revenue, food costs and animal counts at the end of every day to file
+ * (see MetricsSink), as binary records or CSV; --population-events makes
+ * every animal fall sick and conceive on its own (see PopulationEvents)
+ * rather than special events befalling one animal a day, and must be given
+ * again to replay, load or restore such a game; --event-weights draws
+ * the day's special event with the weights in file (see
+ * ReadSpecialEventWeights), which must likewise be given again. Logs,
+ * saves and checkpoints record both (see GameRules), and a game given
+ * other ones is refused. When
+ * standard output is not a terminal, the game's text is written to it in
+ * large blocks (see BufferedSink) rather than at every prompt.
 ** Output: None
 *********************************************************************/
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <random>
+#include <unistd.h>
+#include "Checkpoint.h"
 #include "Game.h"
+#include "InputLog.h"
+#include "MetricsSink.h"
+#include "OutputSink.h"
+#include "SaveFile.h"
+#include "SpecialEvent.h"
+#include "Trace.h"
+#include "TurnProfile.h"
 
-int main() {
-  std::cout << "Welcome to Zoo Tycoon!\n"
-            << "Hit enter to start the game...";
-  std::cin.ignore();
-  std::cout << "\n\n" << std::endl;
+/*********************************************************************
+** Function: CheckRules
+** Description: Checks that a game is carried on with the rules it was
+ * played with.
+** Parameters: played are the game's rules; given are the command line's;
+ * error receives a description of how they differ, if they do.
+** Pre-Conditions: None
+** Post-Conditions: Returns false if the rules differ.
+*********************************************************************/
+static bool CheckRules(const GameRules &played, const GameRules &given,
+                       std::string &error) {
+  if (played.population_events != given.population_events) {
+    error = played.population_events ?
+        "it was played with --population-events" :
+        "it was played without --population-events";
+    return false;
+  }
+  if (played.event_weights != given.event_weights) {
+    error = "it was played with other --event-weights";
+    return false;
+  }
+  return true;
+}
+
+/*********************************************************************
+** Function: PrintUsage
+** Description: Prints how to run the game.
+** Parameters: program is the name the game was run as.
+** Pre-Conditions: None
+** Post-Conditions: None
+*********************************************************************/
+static void PrintUsage(const char *program) {
+  std::cerr << "Usage: " << program
+            << " [--load save_file | --restore prefix | --replay log]\n"
+            << "    [--replay-to-day n] [--record log] [--save save_file]\n"
+            << "    [--checkpoint prefix] [--checkpoint-days n]"
+            << " [--digest file]\n    [--profile] [--trace file]"
+            << " [--trace-every n]\n"
+            << "    [--metrics file | --metrics-csv file]"
+            << " [--population-events]\n"
+            << "    [--event-weights file]" << std::endl;
+}
+
+int main(int argc, char **argv) {
+  Option<std::string> load_path, restore_prefix, replay_path, record_path;
+  Option<std::string> save_path, checkpoint_prefix, digest_path, trace_path;
+  Option<std::string> metrics_path, event_weights_path;
+  MetricsFormat metrics_format = MetricsFormat::Binary;
+  unsigned checkpoint_days = DEFAULT_CHECKPOINT_DAYS, replay_to_day = 0;
+  unsigned trace_every_days = DEFAULT_TRACE_EVERY_DAYS;
+  bool profile = false, population_events = false;
+  for (int i = 1; i < argc; ++i) {
+    if (i + 1 < argc && std::strcmp(argv[i], "--load") == 0) {
+      load_path = std::string(argv[++i]);
+    } else if (i + 1 < argc && std::strcmp(argv[i], "--restore") == 0) {
+      restore_prefix = std::string(argv[++i]);
+    } else if (i + 1 < argc && std::strcmp(argv[i], "--replay") == 0) {
+      replay_path = std::string(argv[++i]);
+    } else if (i + 1 < argc &&
+               std::strcmp(argv[i], "--replay-to-day") == 0) {
+      replay_to_day =
+          static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (i + 1 < argc && std::strcmp(argv[i], "--record") == 0) {
+      record_path = std::string(argv[++i]);
+    } else if (i + 1 < argc && std::strcmp(argv[i], "--save") == 0) {
+      save_path = std::string(argv[++i]);
+    } else if (i + 1 < argc && std::strcmp(argv[i], "--checkpoint") == 0) {
+      checkpoint_prefix = std::string(argv[++i]);
+    } else if (i + 1 < argc &&
+               std::strcmp(argv[i], "--checkpoint-days") == 0) {
+      checkpoint_days =
+          static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (i + 1 < argc && std::strcmp(argv[i], "--digest") == 0) {
+      digest_path = std::string(argv[++i]);
+    } else if (i + 1 < argc && std::strcmp(argv[i], "--trace") == 0) {
+      trace_path = std::string(argv[++i]);
+    } else if (i + 1 < argc && std::strcmp(argv[i], "--trace-every") == 0) {
+      trace_every_days =
+          static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (i + 1 < argc && (std::strcmp(argv[i], "--metrics") == 0 ||
+                                std::strcmp(argv[i], "--metrics-csv") == 0)) {
+      metrics_format = std::strcmp(argv[i], "--metrics-csv") == 0 ?
+          MetricsFormat::Csv : MetricsFormat::Binary;
+      metrics_path = std::string(argv[++i]);
+    } else if (std::strcmp(argv[i], "--profile") == 0) {
+      profile = true;
+    } else if (i + 1 < argc &&
+               std::strcmp(argv[i], "--event-weights") == 0) {
+      event_weights_path = std::string(argv[++i]);
+    } else if (std::strcmp(argv[i], "--population-events") == 0) {
+      population_events = true;
+    } else {
+      PrintUsage(argv[0]);
+      return 1;
+    }
+  }
+  if (load_path.IsSome() + restore_prefix.IsSome() + replay_path.IsSome() >
+      1) {
+    std::cerr << "Only one of --load, --restore and --replay may be given"
+              << std::endl;
+    return 1;
+  }
+  if (record_path.IsSome() && (load_path.IsSome() || restore_prefix.IsSome())) {
+    std::cerr << "Only new and replayed games can be recorded" << std::endl;
+    return 1;
+  }
+  if (checkpoint_days == 0 || trace_every_days == 0) {
+    std::cerr << "--checkpoint-days and --trace-every must be at least 1"
+              << std::endl;
+    return 1;
+  }
+  if (event_weights_path.IsSome()) {
+    SpecialEventWeights weights;
+    std::string error;
+    if (!ReadSpecialEventWeights(event_weights_path.CUnwrapRef(), weights,
+                                 error) ||
+        !SpecialEvent::SetEventWeights(weights, error)) {
+      std::cerr << "Cannot use event weights from "
+                << event_weights_path.CUnwrapRef() << ": " << error
+                << std::endl;
+      return 1;
+    }
+  }
+  GameRules rules{population_events, SpecialEvent::EventWeightsDigest()};
+
+  // All of the game's output goes through out, so that a replay can run
+  // silently and then hand the game over to the player.
+  std::unique_ptr<OutputSink> out_sink;
+  if (isatty(STDOUT_FILENO)) out_sink = make_unique<TerminalSink>();
+  else out_sink = make_unique<BufferedSink>(STDOUT_FILENO);
+  OutputSink &out = *out_sink;
+  std::unique_ptr<Game> game;
+  InputLog log;
+  if (load_path.IsSome() || restore_prefix.IsSome()) {
+    const std::string &path = load_path.IsSome() ?
+        load_path.CUnwrapRef() : restore_prefix.CUnwrapRef();
+    std::string error;
+    Option<SavedGame> saved = load_path.IsSome() ?
+        ReadSaveFile(path, error) : RestoreCheckpoint(path, error);
+    if (saved.IsNone() ||
+        !CheckRules(saved.CUnwrapRef().state.rules, rules, error)) {
+      std::cerr << "Cannot load " << path << ": " << error << std::endl;
+      return 1;
+    }
+    game = make_unique<Game>(saved.Unwrap(), out);
+  } else if (replay_path.IsSome() || record_path.IsSome()) {
+    std::string error;
+    if (replay_path.IsSome() &&
+        (!ReadInputLog(replay_path.CUnwrapRef(), log, error) ||
+         !CheckRules(log.rules, rules, error))) {
+      std::cerr << "Cannot replay " << replay_path.CUnwrapRef() << ": "
+                << error << std::endl;
+      return 1;
+    }
+    std::uint32_t seed =
+        replay_path.IsSome() ? log.seed : std::random_device()();
+    game = make_unique<Game>(Player(), out, std::mt19937(seed));
+
+    if (record_path.IsSome()) {
+      auto recorder =
+          make_unique<InputRecorder>(record_path.CUnwrapRef(), seed, rules);
+      if (!recorder->good()) {
+        std::cerr << "Cannot record to " << record_path.CUnwrapRef() << ": "
+                  << std::strerror(errno) << std::endl;
+        return 1;
+      }
+      game->set_input_recorder(std::move(recorder));
+    }
+  } else {
+    game = make_unique<Game>(out);
+  }
+  game->set_population_events(population_events);
+  if (save_path.IsSome()) game->set_autosave_path(save_path.CUnwrapRef());
+  if (checkpoint_prefix.IsSome())
+    game->set_checkpoint(checkpoint_prefix.CUnwrapRef(), checkpoint_days);
+  std::ofstream digest_os;
+  if (digest_path.IsSome()) {
+    digest_os.open(digest_path.CUnwrapRef());
+    if (!digest_os) {
+      std::cerr << "Cannot write " << digest_path.CUnwrapRef() << ": "
+                << std::strerror(errno) << std::endl;
+      return 1;
+    }
+    game->set_digest_log(&digest_os);
+  }
+  std::unique_ptr<MetricsSink> metrics;
+  if (metrics_path.IsSome()) {
+    metrics = make_unique<MetricsSink>(metrics_path.CUnwrapRef(),
+                                       metrics_format);
+    if (!metrics->good()) {
+      std::cerr << "Cannot write " << metrics_path.CUnwrapRef() << ": "
+                << std::strerror(errno) << std::endl;
+      return 1;
+    }
+    game->set_metrics_sink(metrics.get());
+  }
+
+  if (trace_path.IsSome()) StartTracing(trace_every_days);
+
+  if (replay_path.IsSome()) {
+    std::streambuf *out_buf = out.rdbuf(nullptr);
+    auto start = std::chrono::steady_clock::now();
+    game->Start();
+    std::size_t n = ReplayInputLog(*game, log, replay_to_day);
+    auto end = std::chrono::steady_clock::now();
+    out.rdbuf(out_buf);
+
+    std::cout << "Replayed " << n << " of " << log.lines.size()
+              << " inputs, to day " << game->state().day << ", in "
+              << std::chrono::duration<double>(end - start).count()
+              << " s.\n" << std::endl;
+    if (game->IsOver()) std::cout << "The game is over." << std::endl;
+  } else {
+    std::cout << "Welcome to Zoo Tycoon!\n"
+              << "Hit enter to start the game...";
+    std::cin.ignore();
+    std::cout << "\n\n" << std::endl;
+  }
 
-  Game game;
-  game.Run();
+  if (!game->IsOver()) game->Run();
+  if (profile) std::cerr << '\n' << CurrentTurnProfile();
+  if (metrics && !metrics->Close()) {
+    std::cerr << "Could not write all of " << metrics_path.CUnwrapRef()
+              << std::endl;
+    return 1;
+  }
+  if (trace_path.IsSome() && !WriteChromeTrace(trace_path.CUnwrapRef())) {
+    std::cerr << "Cannot write " << trace_path.CUnwrapRef() << ": "
+              << std::strerror(errno) << std::endl;
+    return 1;
+  }
 
   return 0;
-}
\ No newline at end of file
+}